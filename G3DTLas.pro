@@ -14,8 +14,29 @@ CONFIG += c++11
 SOURCES += \
     EVLR/lasevlr.cpp \
     Fileheader/lasfileheader14.cpp \
+    IO/laschunkcodec.cpp \
+    IO/laschunkdecoder.cpp \
+    IO/laschunkencoder.cpp \
+    IO/laschunkpipeline.cpp \
+    IO/laschunkscheduler.cpp \
+    IO/laschunktable.cpp \
+    IO/lascopytask.cpp \
+    IO/lasfilereader.cpp \
+    IO/laspagecache.cpp \
+    IO/lasreadahead.cpp \
+    IO/lasscantask.cpp \
+    IO/laswaveformreader.cpp \
+    IO/laswritebehind.cpp \
+    Index/lasspatialindex.cpp \
+    Index/lasspatialsort.cpp \
+    Index/laszonemap.cpp \
+    Point/lascoordinates.cpp \
     Point/laspoint.cpp \
+    Point/laspointbatch.cpp \
+    Point/laspointfilter.cpp \
+    Point/laspointstatistics.cpp \
     VLR/lasvlr.cpp \
+    VLR/lasvlrdirectory.cpp \
     VLR/lasvlrgeokeys.cpp \
     lasfile.cpp
 
@@ -25,6 +46,31 @@ HEADERS += \
     Fileheader/lasfileheader12.h \
     Fileheader/lasfileheader13.h \
     Fileheader/lasfileheader14.h \
+    IO/laschunkcodec.h \
+    IO/laschunkdecoder.h \
+    IO/laschunkencoder.h \
+    IO/laschunkpipeline.h \
+    IO/laschunkscheduler.h \
+    IO/laschunktable.h \
+    IO/laschunktableheader.h \
+    IO/lascompressedchunk.h \
+    IO/lascopytask.h \
+    IO/lasfilereader.h \
+    IO/laspagecache.h \
+    IO/lasreadahead.h \
+    IO/lasscantask.h \
+    IO/laswaveformreader.h \
+    IO/laswritebehind.h \
+    Index/lasfilestamp.h \
+    Index/laspointinterval.h \
+    Index/lasspacefillingcurve.h \
+    Index/lasspatialindex.h \
+    Index/lasspatialindexheader.h \
+    Index/lasspatialsort.h \
+    Index/laszone.h \
+    Index/laszonemap.h \
+    Index/laszonemapheader.h \
+    Point/lascoordinates.h \
     Point/laspoint.h \
     Point/laspoint0.h \
     Point/laspoint1.h \
@@ -37,9 +83,15 @@ HEADERS += \
     Point/laspoint7.h \
     Point/laspoint8.h \
     Point/laspoint9.h \
+    Point/laspointbatch.h \
     Point/laspointclassification.h \
+    Point/laspointcodec.h \
+    Point/laspointfilter.h \
+    Point/laspointstatistics.h \
     VLR/lasvlr.h \
+    VLR/lasvlrchunkcodec.h \
     VLR/lasvlrclassificationlookup.h \
+    VLR/lasvlrdirectory.h \
     VLR/lasvlrgeokeyentry.h \
     VLR/lasvlrgeokeys.h \
     VLR/lasvlrheader.h \
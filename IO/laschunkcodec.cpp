@@ -0,0 +1,127 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laschunkcodec.cpp
+ *
+ * \brief The implementation of the LasChunkCodec class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <cstring>
+#include "laschunkcodec.h"
+
+
+/*!
+ * \brief Compresses a chunk of point records.
+ * \param records Point records.
+ * \param nRecords Number of records.
+ * \param recordLength Length of point records, at least 12 bytes of scaled coordinates.
+ * \param gpsTimeOffset Offset of GPS time in records, -1 if GPS time is not stored.
+ * \param chunk Returns the compressed chunk.
+ * \return True, if the chunk was compressed.
+ * \remark x, y, z are coded as differences of 32-bit integers, GPS time as a difference of 64-bit patterns of doubles,
+ *         both transformations are lossless.
+ */
+bool LasChunkCodec::encode(const char *records, qint64 nRecords, quint16 recordLength, int gpsTimeOffset, QByteArray &chunk)
+{
+    char *planes, *record;
+    qint32 value[3], previous[3] = { 0, 0, 0 };
+    quint32 delta32;
+    quint64 gpsTime, previousGpsTime = 0, delta64;
+    qint64 i, nBytes = nRecords * recordLength;
+
+    chunk.clear();
+    if (records == nullptr || nRecords <= 0 || recordLength < 3 * sizeof(qint32) || 0x7FFFFFFFLL < nBytes) return false;
+    if (recordLength < gpsTimeOffset + qint64(sizeof(quint64))) gpsTimeOffset = -1;
+
+    planes = new char[size_t(nBytes)];
+    record = new char[recordLength];
+
+    for (i = 0; i < nRecords; i++)
+    {
+        memcpy(record, records + i * recordLength, recordLength);
+
+        memcpy(value, record, sizeof(value));
+        for (int k = 0; k < 3; k++)
+        {
+            delta32 = zigzag32(qint32(quint32(value[k]) - quint32(previous[k])));
+            memcpy(record + k * sizeof(qint32), &delta32, sizeof(quint32));
+            previous[k] = value[k];
+        }
+
+        if (0 <= gpsTimeOffset)
+        {
+            memcpy(&gpsTime, record + gpsTimeOffset, sizeof(quint64));
+            delta64 = zigzag64(qint64(gpsTime - previousGpsTime));
+            memcpy(record + gpsTimeOffset, &delta64, sizeof(quint64));
+            previousGpsTime = gpsTime;
+        }
+
+        // byte j of record i is stored in the plane j
+        for (int j = 0; j < recordLength; j++)
+            planes[j * nRecords + i] = record[j];
+    }
+
+    chunk = qCompress(reinterpret_cast<const uchar *>(planes), int(nBytes), LAS_CHUNK_CODEC_LEVEL);
+
+    delete[] record;
+    delete[] planes;
+    return !chunk.isEmpty();
+}
+
+
+/*!
+ * \brief Decompresses a chunk of point records.
+ * \param chunk Compressed chunk.
+ * \param recordLength Length of point records.
+ * \param gpsTimeOffset Offset of GPS time in records, -1 if GPS time is not stored.
+ * \param records Buffer for nRecords records.
+ * \param nRecords Number of records in the chunk.
+ * \return True, if the chunk was decompressed and holds nRecords records.
+ */
+bool LasChunkCodec::decode(const QByteArray &chunk, quint16 recordLength, int gpsTimeOffset, char *records, qint64 nRecords)
+{
+    QByteArray planes;
+    const char *plane;
+    char *record;
+    qint32 previous[3] = { 0, 0, 0 };
+    quint32 delta32;
+    quint64 previousGpsTime = 0, delta64;
+    qint64 i;
+
+    if (records == nullptr || nRecords <= 0 || recordLength < 3 * sizeof(qint32)) return false;
+    if (recordLength < gpsTimeOffset + qint64(sizeof(quint64))) gpsTimeOffset = -1;
+
+    planes = qUncompress(chunk);
+    if (qint64(planes.size()) != nRecords * recordLength) return false;
+    plane = planes.constData();
+
+    for (i = 0; i < nRecords; i++)
+    {
+        record = records + i * recordLength;
+        for (int j = 0; j < recordLength; j++)
+            record[j] = plane[j * nRecords + i];
+
+        for (int k = 0; k < 3; k++)
+        {
+            memcpy(&delta32, record + k * sizeof(qint32), sizeof(quint32));
+            previous[k] = qint32(quint32(previous[k]) + quint32(unzigzag32(delta32)));
+            memcpy(record + k * sizeof(qint32), &previous[k], sizeof(qint32));
+        }
+
+        if (0 <= gpsTimeOffset)
+        {
+            memcpy(&delta64, record + gpsTimeOffset, sizeof(quint64));
+            previousGpsTime += quint64(unzigzag64(delta64));
+            memcpy(record + gpsTimeOffset, &previousGpsTime, sizeof(quint64));
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,45 @@
+#ifndef LASCHUNKCODEC_H
+#define LASCHUNKCODEC_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laschunkcodec.h
+ *
+ * \brief Compression of chunks of point records.
+ * \remark Coordinates and GPS time are delta coded against the previous record, deltas are zigzag coded.
+ *         Records are transposed into byte planes, so equal bytes of consecutive records are adjacent,
+ *         and planes are compressed by zlib (qCompress).
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QByteArray>
+#include "g3dtlas_global.h"
+
+#define LAS_CHUNK_CODEC_LEVEL (6)       //!< zlib compression level of chunks
+
+
+/*!
+ * \brief The LasChunkCodec class.
+ * Encodes and decodes chunks of raw point records.
+ */
+class G3DTLAS_EXPORT LasChunkCodec
+{
+public:
+    static bool encode(const char *records, qint64 nRecords, quint16 recordLength, int gpsTimeOffset, QByteArray &chunk);
+    static bool decode(const QByteArray &chunk, quint16 recordLength, int gpsTimeOffset, char *records, qint64 nRecords);
+
+protected:
+    static inline quint32 zigzag32(qint32 value) { return (quint32(value) << 1) ^ quint32(value >> 31); }
+    static inline qint32 unzigzag32(quint32 value) { return qint32((value >> 1) ^ (0U - (value & 1U))); }
+    static inline quint64 zigzag64(qint64 value) { return (quint64(value) << 1) ^ quint64(value >> 63); }
+    static inline qint64 unzigzag64(quint64 value) { return qint64((value >> 1) ^ (0ULL - (value & 1ULL))); }
+};
+
+#endif // LASCHUNKCODEC_H
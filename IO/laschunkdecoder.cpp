@@ -0,0 +1,188 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laschunkdecoder.cpp
+ *
+ * \brief The implementation of the LasChunkDecoder class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "laschunkdecoder.h"
+#include "lasfile.h"
+
+
+/*!
+ * \brief Default constructor.
+ */
+LasChunkDecoder::LasChunkDecoder()
+{
+}
+
+
+/*!
+ * \brief Destructor. Stops workers.
+ */
+LasChunkDecoder::~LasChunkDecoder()
+{
+    end();
+}
+
+
+/*!
+ * \brief Starts decoding from the first chunk.
+ * \param las Compressed las-file, open for reading.
+ * \param nWorkers Number of worker threads.
+ * \return True, if workers were started.
+ */
+bool LasChunkDecoder::begin(LasFile *las, int nWorkers)
+{
+    end();
+    if (las == nullptr || !las->isCompressed() || las->chunkTable.getNumberOfChunks() == 0) return false;
+    if (nWorkers < 1) nWorkers = 1;
+
+    this->lasFile = las;
+    this->numberOfChunks = las->chunkTable.getNumberOfChunks();
+    this->nextChunk = 0;
+    this->expectedChunk = 0;
+    this->generation = 1;
+    allocateSlots(nWorkers * LAS_CHUNK_PIPELINE_SLOTS_PER_WORKER, las->chunkTable.getChunkNRecords(), las->getPointRecordLength());
+    startWorkers(nWorkers);
+    return true;
+}
+
+
+/*!
+ * \brief Stops workers and releases slots.
+ */
+void LasChunkDecoder::end()
+{
+    stopWorkers();
+    releaseSlots();
+    this->lasFile = nullptr;
+}
+
+
+/*!
+ * \brief Takes a decompressed chunk.
+ * \param iChunk Index of the chunk.
+ * \param buffer Input: released buffer of chunkNRecords records, output: buffer with the decompressed chunk.
+ * \param nRecords Returns the number of records in the chunk.
+ * \return True, if the chunk was decompressed successfully.
+ * \remark If the chunk is not the next expected chunk, decoding restarts at iChunk and the caller waits.
+ */
+bool LasChunkDecoder::fetch(qint64 iChunk, char *&buffer, qint64 &nRecords)
+{
+    char *records;
+    int iSlot;
+    bool error = true;
+
+    nRecords = 0;
+    if (buffer == nullptr || this->chunkSlots == nullptr || iChunk < 0 || this->numberOfChunks <= iChunk) return false;
+
+    this->mutex.lock();
+    if (iChunk != this->expectedChunk)
+    {
+        // random access, chunks decoded ahead are discarded, chunks being decoded are discarded by workers
+        this->generation++;
+        for (int i = 0; i < this->numberOfSlots; i++)
+            if (this->chunkSlots[i].state == LAS_CHUNK_SLOT_DONE || this->chunkSlots[i].state == LAS_CHUNK_SLOT_FAILED)
+                freeSlot(this->chunkSlots[i]);
+        this->nextChunk = iChunk;
+        this->expectedChunk = iChunk;
+        this->slotChanged.wakeAll();
+    }
+
+    while ((iSlot = findSlot(iChunk)) < 0 && !this->stopRequested)
+        this->slotChanged.wait(&this->mutex);
+
+    if (0 <= iSlot)
+    {
+        LasChunkSlot &slot = this->chunkSlots[iSlot];
+        if (slot.state == LAS_CHUNK_SLOT_DONE)
+        {
+            records = slot.records;
+            slot.records = buffer;
+            buffer = records;
+            nRecords = slot.nRecords;
+            error = false;
+        }
+        freeSlot(slot);
+        this->expectedChunk = iChunk + 1;
+        this->slotChanged.wakeAll();
+    }
+    this->mutex.unlock();
+
+    return !error;
+}
+
+
+/*!
+ * \brief Thread function, decompresses chunks following the expected chunk into free slots.
+ * \param iWorker Index of the worker.
+ */
+void LasChunkDecoder::work(int iWorker)
+{
+    qint64 nRecords;
+    int iSlot;
+    bool error;
+
+    Q_UNUSED(iWorker);
+
+    this->mutex.lock();
+    while (!this->stopRequested)
+    {
+        iSlot = -1;
+        if (this->nextChunk < this->numberOfChunks && this->nextChunk < this->expectedChunk + this->numberOfSlots)
+            for (int i = 0; i < this->numberOfSlots && iSlot < 0; i++)
+                if (this->chunkSlots[i].state == LAS_CHUNK_SLOT_FREE) iSlot = i;
+        if (iSlot < 0)
+        {
+            this->slotChanged.wait(&this->mutex);
+            continue;
+        }
+
+        // the slot is not accessed by the consumer while it is decoded
+        LasChunkSlot &slot = this->chunkSlots[iSlot];
+        slot.iChunk = this->nextChunk++;
+        slot.state = LAS_CHUNK_SLOT_CODING;
+        slot.generation = this->generation;
+        this->mutex.unlock();
+
+        error = !this->lasFile->readChunkAt(slot.iChunk, slot.records, nRecords);
+
+        this->mutex.lock();
+        if (slot.generation != this->generation)
+            freeSlot(slot);
+        else
+        {
+            slot.nRecords = (error ? 0 : nRecords);
+            slot.state = (error ? LAS_CHUNK_SLOT_FAILED : LAS_CHUNK_SLOT_DONE);
+        }
+        this->slotChanged.wakeAll();
+    }
+    this->mutex.unlock();
+}
+
+
+/*!
+ * \brief Finds the slot of a decoded chunk of the current generation.
+ * \param iChunk Index of the chunk.
+ * \return Index of the slot, -1 if the chunk is not decoded yet.
+ */
+int LasChunkDecoder::findSlot(qint64 iChunk)
+{
+    for (int i = 0; i < this->numberOfSlots; i++)
+    {
+        const LasChunkSlot &slot = this->chunkSlots[i];
+        if (slot.iChunk == iChunk && slot.generation == this->generation &&
+            (slot.state == LAS_CHUNK_SLOT_DONE || slot.state == LAS_CHUNK_SLOT_FAILED))
+            return i;
+    }
+    return -1;
+}
@@ -0,0 +1,55 @@
+#ifndef LASCHUNKDECODER_H
+#define LASCHUNKDECODER_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laschunkdecoder.h
+ *
+ * \brief Parallel decompression of consecutive chunks of point records.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+#include "IO/laschunkpipeline.h"
+
+class LasFile;
+
+
+/*!
+ * \brief The LasChunkDecoder class.
+ * Worker threads decompress chunks following the last fetched chunk, chunks are fetched in the order of the file.
+ * \remark The number of decompressed chunks waiting for the consumer is bounded by the number of slots.
+ *         Chunks are read by positional reads, the las-file must not be modified while decoding.
+ */
+class G3DTLAS_EXPORT LasChunkDecoder : public LasChunkPipeline
+{
+protected:
+    LasFile *lasFile = nullptr;         //!< compressed las-file
+    qint64 numberOfChunks = 0;          //!< number of chunks in the file
+    qint64 nextChunk = 0;               //!< index of the next chunk taken by a worker
+    qint64 expectedChunk = 0;           //!< index of the next chunk expected by the consumer
+    quint64 generation = 1;             //!< incremented on every change of the position, stale chunks are discarded
+
+public:
+    LasChunkDecoder();
+    ~LasChunkDecoder();
+
+    bool begin(LasFile *las, int nWorkers);
+    void end();
+
+    bool fetch(qint64 iChunk, char *&buffer, qint64 &nRecords);
+
+    void work(int iWorker);
+
+protected:
+    int findSlot(qint64 iChunk);
+};
+
+#endif // LASCHUNKDECODER_H
@@ -0,0 +1,256 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laschunkencoder.cpp
+ *
+ * \brief The implementation of the LasChunkEncoder class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <cstring>
+#include "laschunkencoder.h"
+#include "laschunkcodec.h"
+
+
+/*!
+ * \brief Default constructor.
+ */
+LasChunkEncoder::LasChunkEncoder()
+{
+}
+
+
+/*!
+ * \brief Destructor. Writes submitted chunks and stops workers.
+ */
+LasChunkEncoder::~LasChunkEncoder()
+{
+    end();
+}
+
+
+/*!
+ * \brief Opens the las-file for writing and starts workers.
+ * \param fileName Las-file name, the file must exist.
+ * \param firstChunkOffset Offset of the first written chunk.
+ * \param pointRecordLength Length of point records.
+ * \param pointGpsTimeOffset Offset of GPS time in point records, -1 if not stored.
+ * \param chunkNumberOfRecords Maximal number of records in a chunk.
+ * \param nWorkers Number of compressing threads, one more thread writes chunks.
+ * \return True, if the file was open and workers started.
+ */
+bool LasChunkEncoder::begin(QString fileName, qint64 firstChunkOffset, quint16 pointRecordLength, int pointGpsTimeOffset, qint64 chunkNumberOfRecords, int nWorkers)
+{
+    end();
+    if (pointRecordLength == 0 || chunkNumberOfRecords <= 0) return false;
+    if (nWorkers < 1) nWorkers = 1;
+
+    this->dataFile.setFileName(fileName);
+    if (!this->dataFile.open(QFile::ReadWrite | QFile::Unbuffered)) return false;
+
+    this->gpsTimeOffset = pointGpsTimeOffset;
+    this->nextOffset = firstChunkOffset;
+    this->nextSubmitted = 0;
+    this->nextWritten = 0;
+    this->writtenChunks.clear();
+    this->writeError = false;
+    allocateSlots(nWorkers * LAS_CHUNK_PIPELINE_SLOTS_PER_WORKER, chunkNumberOfRecords, pointRecordLength);
+    startWorkers(nWorkers + 1);
+    return true;
+}
+
+
+/*!
+ * \brief Writes submitted chunks, stops workers, closes the file and releases slots.
+ * \return True, if all chunks were written successfully.
+ * \remark Descriptors of written chunks not taken yet remain available.
+ */
+bool LasChunkEncoder::end()
+{
+    bool error;
+
+    error = !flush();
+    stopWorkers();
+    releaseSlots();
+    if (this->dataFile.isOpen()) this->dataFile.close();
+
+    return !error;
+}
+
+
+/*!
+ * \brief Queues a chunk for compression.
+ * \param records Point records, they are copied into a slot.
+ * \param nRecords Number of records, at most chunkNRecords.
+ * \return True, if the chunk was queued and no previous chunk failed.
+ */
+bool LasChunkEncoder::submit(const char *records, qint64 nRecords)
+{
+    LasChunkSlot *slot = nullptr;
+
+    if (records == nullptr || nRecords <= 0 || this->chunkNRecords < nRecords || this->chunkSlots == nullptr) return false;
+
+    this->mutex.lock();
+    while (slot == nullptr && !this->writeError)
+    {
+        for (int i = 0; i < this->numberOfSlots && slot == nullptr; i++)
+            if (this->chunkSlots[i].state == LAS_CHUNK_SLOT_FREE) slot = &this->chunkSlots[i];
+        if (slot == nullptr) this->slotChanged.wait(&this->mutex);
+    }
+    if (slot != nullptr)
+    {
+        slot->iChunk = this->nextSubmitted++;
+        slot->state = LAS_CHUNK_SLOT_FILLING;
+    }
+    this->mutex.unlock();
+    if (slot == nullptr) return false;
+
+    // the filled slot is not accessed by workers
+    memcpy(slot->records, records, size_t(nRecords * this->recordLength));
+    slot->nRecords = nRecords;
+
+    this->mutex.lock();
+    slot->state = LAS_CHUNK_SLOT_QUEUED;
+    this->slotChanged.wakeAll();
+    this->mutex.unlock();
+
+    return true;
+}
+
+
+/*!
+ * \brief Waits until all submitted chunks are written.
+ * \return True, if all chunks were written successfully.
+ */
+bool LasChunkEncoder::flush()
+{
+    bool error;
+
+    this->mutex.lock();
+    while (this->nextWritten < this->nextSubmitted && this->chunkSlots != nullptr)
+        this->slotChanged.wait(&this->mutex);
+    error = this->writeError;
+    this->mutex.unlock();
+
+    return !error;
+}
+
+
+/*!
+ * \brief Takes descriptors of chunks written since the last call.
+ * \param chunks Returns written chunks in the order of submission.
+ */
+void LasChunkEncoder::takeWrittenChunks(QVector<LasCompressedChunk> &chunks)
+{
+    this->mutex.lock();
+    chunks = this->writtenChunks;
+    this->writtenChunks.clear();
+    this->mutex.unlock();
+}
+
+
+/*!
+ * \brief Thread function, the first worker writes chunks, other workers compress chunks.
+ * \param iWorker Index of the worker.
+ */
+void LasChunkEncoder::work(int iWorker)
+{
+    if (iWorker == 0)
+        writeChunks();
+    else
+        encodeChunks();
+}
+
+
+/*!
+ * \brief Compresses queued chunks, the chunk submitted first is taken first.
+ */
+void LasChunkEncoder::encodeChunks()
+{
+    LasChunkSlot *slot;
+    bool error;
+
+    this->mutex.lock();
+    while (true)
+    {
+        slot = nullptr;
+        for (int i = 0; i < this->numberOfSlots; i++)
+            if (this->chunkSlots[i].state == LAS_CHUNK_SLOT_QUEUED && (slot == nullptr || this->chunkSlots[i].iChunk < slot->iChunk))
+                slot = &this->chunkSlots[i];
+        if (slot == nullptr)
+        {
+            if (this->stopRequested) break;
+            this->slotChanged.wait(&this->mutex);
+            continue;
+        }
+
+        // the slot is not accessed by the producer and the writer while it is compressed
+        slot->state = LAS_CHUNK_SLOT_CODING;
+        this->mutex.unlock();
+
+        error = !LasChunkCodec::encode(slot->records, slot->nRecords, this->recordLength, this->gpsTimeOffset, slot->chunk);
+
+        this->mutex.lock();
+        slot->state = (error ? LAS_CHUNK_SLOT_FAILED : LAS_CHUNK_SLOT_DONE);
+        this->slotChanged.wakeAll();
+    }
+    this->mutex.unlock();
+}
+
+
+/*!
+ * \brief Writes compressed chunks in the order of submission.
+ * \remark After an error the following chunks are not written, their slots are released.
+ */
+void LasChunkEncoder::writeChunks()
+{
+    LasChunkSlot *slot;
+    LasCompressedChunk chunk;
+    qint64 nBytes;
+    bool error;
+
+    this->mutex.lock();
+    while (true)
+    {
+        slot = nullptr;
+        for (int i = 0; i < this->numberOfSlots && slot == nullptr; i++)
+            if (this->chunkSlots[i].iChunk == this->nextWritten &&
+                (this->chunkSlots[i].state == LAS_CHUNK_SLOT_DONE || this->chunkSlots[i].state == LAS_CHUNK_SLOT_FAILED))
+                slot = &this->chunkSlots[i];
+        if (slot == nullptr)
+        {
+            if (this->stopRequested && this->nextSubmitted <= this->nextWritten) break;
+            this->slotChanged.wait(&this->mutex);
+            continue;
+        }
+
+        // the compressed slot is accessed only by the writer
+        error = this->writeError || slot->state == LAS_CHUNK_SLOT_FAILED;
+        nBytes = slot->chunk.size();
+        chunk.offset = quint64(this->nextOffset);
+        chunk.numberOfRecords = quint32(slot->nRecords);
+        chunk.numberOfBytes = quint32(nBytes);
+        this->mutex.unlock();
+
+        if (!error) error = !this->dataFile.seek(qint64(chunk.offset));
+        if (!error) error = (this->dataFile.write(slot->chunk.constData(), nBytes) != nBytes);
+
+        this->mutex.lock();
+        if (!error)
+        {
+            this->writtenChunks.append(chunk);
+            this->nextOffset += nBytes;
+        }
+        this->writeError = error;
+        freeSlot(*slot);
+        this->nextWritten++;
+        this->slotChanged.wakeAll();
+    }
+    this->mutex.unlock();
+}
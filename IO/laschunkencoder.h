@@ -0,0 +1,61 @@
+#ifndef LASCHUNKENCODER_H
+#define LASCHUNKENCODER_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laschunkencoder.h
+ *
+ * \brief Parallel compression of consecutive chunks of point records.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QFile>
+#include <QVector>
+#include "g3dtlas_global.h"
+#include "IO/laschunkpipeline.h"
+#include "IO/lascompressedchunk.h"
+
+
+/*!
+ * \brief The LasChunkEncoder class.
+ * Submitted chunks are compressed by worker threads and written in the order of submission by a single writer thread.
+ * \remark The writer uses its own file handle, the caller must call flush before accessing written chunks.
+ *         The producer waits only if all slots are occupied.
+ */
+class G3DTLAS_EXPORT LasChunkEncoder : public LasChunkPipeline
+{
+protected:
+    QFile dataFile;                     //!< own handle of the las-file
+    int gpsTimeOffset = -1;             //!< offset of GPS time in point records, -1 if not stored
+    qint64 nextOffset = 0;              //!< offset of the next written chunk
+    qint64 nextSubmitted = 0;           //!< index of the next submitted chunk
+    qint64 nextWritten = 0;             //!< index of the next written chunk
+    QVector<LasCompressedChunk> writtenChunks; //!< chunks written since the last takeWrittenChunks
+    bool writeError = false;            //!< write error flag
+
+public:
+    LasChunkEncoder();
+    ~LasChunkEncoder();
+
+    bool begin(QString fileName, qint64 firstChunkOffset, quint16 pointRecordLength, int pointGpsTimeOffset, qint64 chunkNumberOfRecords, int nWorkers);
+    bool end();
+
+    bool submit(const char *records, qint64 nRecords);
+    bool flush();
+    void takeWrittenChunks(QVector<LasCompressedChunk> &chunks);
+
+    void work(int iWorker);
+
+protected:
+    void encodeChunks();
+    void writeChunks();
+};
+
+#endif // LASCHUNKENCODER_H
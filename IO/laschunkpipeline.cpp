@@ -0,0 +1,133 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laschunkpipeline.cpp
+ *
+ * \brief The implementation of the LasChunkPipeline and LasChunkWorker classes.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "laschunkpipeline.h"
+
+
+/*!
+ * \brief Default constructor.
+ */
+LasChunkPipeline::LasChunkPipeline()
+{
+}
+
+
+/*!
+ * \brief Destructor. Workers must be stopped by the derived class.
+ */
+LasChunkPipeline::~LasChunkPipeline()
+{
+    releaseSlots();
+}
+
+
+/*!
+ * \brief Allocates free slots.
+ * \param nSlots Number of slots.
+ * \param chunkNumberOfRecords Number of records in a chunk.
+ * \param pointRecordLength Length of point records.
+ */
+void LasChunkPipeline::allocateSlots(int nSlots, qint64 chunkNumberOfRecords, quint16 pointRecordLength)
+{
+    releaseSlots();
+
+    this->chunkNRecords = chunkNumberOfRecords;
+    this->recordLength = pointRecordLength;
+    this->numberOfSlots = nSlots;
+    this->chunkSlots = new LasChunkSlot[nSlots];
+    for (int i = 0; i < nSlots; i++)
+    {
+        this->chunkSlots[i].records = new char[size_t(chunkNumberOfRecords * pointRecordLength)];
+        freeSlot(this->chunkSlots[i]);
+    }
+}
+
+
+/*!
+ * \brief Starts worker threads.
+ * \param nWorkers Number of workers.
+ * \remark Every worker runs in its own thread until the pipeline is stopped.
+ */
+void LasChunkPipeline::startWorkers(int nWorkers)
+{
+    this->stopRequested = false;
+    this->workers.setMaxThreadCount(nWorkers);
+    for (int i = 0; i < nWorkers; i++)
+        this->workers.start(new LasChunkWorker(this, i));
+}
+
+
+/*!
+ * \brief Requests termination of workers and waits until they finish.
+ */
+void LasChunkPipeline::stopWorkers()
+{
+    this->mutex.lock();
+    this->stopRequested = true;
+    this->slotChanged.wakeAll();
+    this->mutex.unlock();
+    this->workers.waitForDone();
+}
+
+
+/*!
+ * \brief Releases slots, workers must be stopped.
+ */
+void LasChunkPipeline::releaseSlots()
+{
+    if (this->chunkSlots != nullptr)
+    {
+        for (int i = 0; i < this->numberOfSlots; i++)
+            if (this->chunkSlots[i].records != nullptr) delete[] this->chunkSlots[i].records;
+        delete[] this->chunkSlots;
+        this->chunkSlots = nullptr;
+    }
+    this->numberOfSlots = 0;
+}
+
+
+/*!
+ * \brief Marks a slot as free.
+ * \param slot Slot.
+ */
+void LasChunkPipeline::freeSlot(LasChunkSlot &slot)
+{
+    slot.iChunk = -1;
+    slot.nRecords = 0;
+    slot.chunk.clear();
+    slot.state = LAS_CHUNK_SLOT_FREE;
+    slot.generation = 0;
+}
+
+
+/*!
+ * \brief Constructor.
+ * \param chunkPipeline Pipeline.
+ * \param worker Index of the worker.
+ */
+LasChunkWorker::LasChunkWorker(LasChunkPipeline *chunkPipeline, int worker)
+{
+    this->pipeline = chunkPipeline;
+    this->iWorker = worker;
+}
+
+
+/*!
+ * \brief Runs the thread function of the worker.
+ */
+void LasChunkWorker::run()
+{
+    this->pipeline->work(this->iWorker);
+}
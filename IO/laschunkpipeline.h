@@ -0,0 +1,111 @@
+#ifndef LASCHUNKPIPELINE_H
+#define LASCHUNKPIPELINE_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laschunkpipeline.h
+ *
+ * \brief Base of pipelines coding compressed chunks of point records by worker threads.
+ * \remark Chunks are held in a bounded set of slots, a slot passes through states of the pipeline
+ *         and it is released when the chunk is taken by the consumer.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QByteArray>
+#include <QMutex>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include "g3dtlas_global.h"
+
+#define LAS_CHUNK_PIPELINE_SLOTS_PER_WORKER (2)     //!< number of chunk slots per worker thread
+
+
+/*!
+ * \brief States of a chunk slot.
+ */
+enum LasChunkSlotState
+{
+    LAS_CHUNK_SLOT_FREE = 0,    //!< the slot is not used
+    LAS_CHUNK_SLOT_FILLING = 1, //!< records are copied into the slot by the producer
+    LAS_CHUNK_SLOT_QUEUED = 2,  //!< the chunk waits for a worker
+    LAS_CHUNK_SLOT_CODING = 3,  //!< the chunk is coded by a worker
+    LAS_CHUNK_SLOT_DONE = 4,    //!< the chunk was coded successfully
+    LAS_CHUNK_SLOT_FAILED = 5   //!< the chunk cannot be read or coded
+};
+
+
+/*!
+ * \brief Chunk held in the pipeline.
+ */
+struct LasChunkSlot
+{
+    qint64 iChunk;              //!< index of the chunk, -1 if the slot is free
+    char *records;              //!< buffer of chunkNRecords point records
+    qint64 nRecords;            //!< number of valid records
+    QByteArray chunk;           //!< compressed chunk
+    LasChunkSlotState state;    //!< state of the slot
+    quint64 generation;         //!< generation of the pipeline, when the chunk was taken by a worker
+};
+
+
+/*!
+ * \brief The LasChunkPipeline class.
+ * Slots of chunks and worker threads shared by the chunk decoder and the chunk encoder.
+ * \remark All state changes of slots are guarded by the mutex and signalled by slotChanged.
+ */
+class G3DTLAS_EXPORT LasChunkPipeline
+{
+protected:
+    QThreadPool workers;                //!< worker threads
+    QMutex mutex;                       //!< guards slots and state of the pipeline
+    QWaitCondition slotChanged;         //!< signalled on every change of a slot or of the pipeline state
+    LasChunkSlot *chunkSlots = nullptr; //!< chunk slots
+    int numberOfSlots = 0;              //!< number of slots
+    qint64 chunkNRecords = 0;           //!< number of records in a chunk
+    quint16 recordLength = 0;           //!< length of point records
+    bool stopRequested = false;         //!< thread termination flag
+
+public:
+    LasChunkPipeline();
+    virtual ~LasChunkPipeline();
+
+    /*!
+     * \brief Thread function of a worker.
+     * \param iWorker Index of the worker, from 0 to the number of workers - 1.
+     */
+    virtual void work(int iWorker) = 0;
+
+protected:
+    void allocateSlots(int nSlots, qint64 chunkNumberOfRecords, quint16 pointRecordLength);
+    void startWorkers(int nWorkers);
+    void stopWorkers();
+    void releaseSlots();
+    void freeSlot(LasChunkSlot &slot);
+};
+
+
+/*!
+ * \brief The LasChunkWorker class.
+ * Runs the thread function of a pipeline worker in the thread pool.
+ */
+class G3DTLAS_EXPORT LasChunkWorker : public QRunnable
+{
+protected:
+    LasChunkPipeline *pipeline;         //!< pipeline
+    int iWorker;                        //!< index of the worker
+
+public:
+    LasChunkWorker(LasChunkPipeline *chunkPipeline, int worker);
+
+    void run();
+};
+
+#endif // LASCHUNKPIPELINE_H
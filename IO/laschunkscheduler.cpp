@@ -0,0 +1,136 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laschunkscheduler.cpp
+ *
+ * \brief The implementation of the LasChunkScheduler class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "laschunkscheduler.h"
+
+
+/*!
+ * \brief Constructor. Splits chunks into equal contiguous ranges of workers.
+ * \param numberOfChunks Number of chunks.
+ * \param numberOfWorkers Number of workers.
+ */
+LasChunkScheduler::LasChunkScheduler(qint64 numberOfChunks, int numberOfWorkers)
+{
+    this->nWorkers = (0 < numberOfWorkers ? numberOfWorkers : 1);
+    this->ranges = new LasChunkRange[this->nWorkers];
+    this->rangeMutexes = new QMutex[this->nWorkers];
+    for (int i = 0; i < this->nWorkers; i++)
+    {
+        this->ranges[i].next = numberOfChunks * i / this->nWorkers;
+        this->ranges[i].end = numberOfChunks * (i + 1) / this->nWorkers;
+    }
+}
+
+
+/*!
+ * \brief Destructor.
+ */
+LasChunkScheduler::~LasChunkScheduler()
+{
+    delete[] this->ranges;
+    delete[] this->rangeMutexes;
+}
+
+
+/*!
+ * \brief Takes the next chunk of a worker.
+ * \param iWorker Index of the worker.
+ * \param iChunk Returns the index of the chunk.
+ * \return True, if a chunk was taken, false if all chunks were taken or the scheduler was stopped.
+ * \remark If the range of the worker is empty, chunks are stolen from other workers.
+ */
+bool LasChunkScheduler::next(int iWorker, qint64 &iChunk)
+{
+    do
+    {
+        if (isStopped()) return false;
+        {
+            QMutexLocker locker(&this->rangeMutexes[iWorker]);
+            LasChunkRange &range = this->ranges[iWorker];
+            if (range.next < range.end)
+            {
+                iChunk = range.next++;
+                return true;
+            }
+        }
+    } while (steal(iWorker));
+
+    return false;
+}
+
+
+/*!
+ * \brief Stops scheduling, following calls of next return false.
+ */
+void LasChunkScheduler::stop()
+{
+    this->stopped.storeRelease(1);
+}
+
+
+/*!
+ * \brief Checks if scheduling was stopped.
+ * \return True, if stop was called.
+ */
+bool LasChunkScheduler::isStopped()
+{
+    return (this->stopped.loadAcquire() != 0);
+}
+
+
+/*!
+ * \brief Moves the back half of the largest range of other workers to the range of a worker.
+ * \param iWorker Index of the idle worker.
+ * \return True, if any chunk was stolen, false if all ranges are empty.
+ * \remark Ranges are sampled one by one, the size of the victim range is checked again before it is split.
+ */
+bool LasChunkScheduler::steal(int iWorker)
+{
+    qint64 size, maxSize, first;
+    int victim;
+
+    for (;;)
+    {
+        victim = -1;
+        maxSize = 0;
+        for (int i = 0; i < this->nWorkers; i++)
+        {
+            if (i == iWorker) continue;
+            QMutexLocker locker(&this->rangeMutexes[i]);
+            size = this->ranges[i].end - this->ranges[i].next;
+            if (maxSize < size)
+            {
+                maxSize = size;
+                victim = i;
+            }
+        }
+        if (victim < 0) return false;
+
+        {
+            QMutexLocker locker(&this->rangeMutexes[victim]);
+            LasChunkRange &range = this->ranges[victim];
+            size = range.end - range.next;
+            if (size <= 0) continue; // taken meanwhile, select another victim
+            first = range.end - (size + 1) / 2;
+            range.end = first;
+            size = (size + 1) / 2;
+        }
+
+        QMutexLocker locker(&this->rangeMutexes[iWorker]);
+        this->ranges[iWorker].next = first;
+        this->ranges[iWorker].end = first + size;
+        return true;
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef LASCHUNKSCHEDULER_H
+#define LASCHUNKSCHEDULER_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laschunkscheduler.h
+ *
+ * \brief Work stealing scheduler of chunks of point records.
+ * \remark Every worker owns a contiguous range of chunks and takes chunks from its front,
+ *         an idle worker steals the back half of the largest remaining range.
+ *         Workers read mostly consecutive records and slow chunks do not hold up the rest.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QAtomicInt>
+#include <QMutex>
+#include "g3dtlas_global.h"
+
+
+/*!
+ * \brief Range of chunks owned by a worker.
+ */
+struct LasChunkRange
+{
+    qint64 next;                //!< index of the next chunk taken by the owner
+    qint64 end;                 //!< index after the last chunk of the range, stolen chunks are taken from the end
+};
+
+
+/*!
+ * \brief The LasChunkScheduler class.
+ * Distributes chunks among workers with work stealing.
+ */
+class G3DTLAS_EXPORT LasChunkScheduler
+{
+protected:
+    int nWorkers;                       //!< number of workers
+    LasChunkRange *ranges;              //!< ranges of workers
+    QMutex *rangeMutexes;               //!< guard ranges of workers
+    QAtomicInt stopped;                 //!< if not zero, no more chunks are scheduled
+
+public:
+    LasChunkScheduler(qint64 numberOfChunks, int numberOfWorkers);
+    ~LasChunkScheduler();
+
+    bool next(int iWorker, qint64 &iChunk);
+    void stop();
+    bool isStopped();
+
+protected:
+    bool steal(int iWorker);
+
+private:
+    Q_DISABLE_COPY(LasChunkScheduler)
+};
+
+#endif // LASCHUNKSCHEDULER_H
@@ -0,0 +1,184 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laschunktable.cpp
+ *
+ * \brief The implementation of the LasChunkTable class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <cstring>
+#include "laschunktable.h"
+
+
+/*!
+ * \brief Constructor.
+ */
+LasChunkTable::LasChunkTable()
+{
+    clear();
+}
+
+
+/*!
+ * \brief Removes all chunks.
+ * \param chunkNRecords Number of point records in a chunk.
+ */
+void LasChunkTable::clear(quint32 chunkNRecords)
+{
+    memset(&this->header, 0, sizeof(LasChunkTableHeader));
+    memcpy(this->header.signature, "LSCT", LAS_CHUNK_TABLE_SIGNATURE_LENGTH);
+    this->header.version = LAS_CHUNK_TABLE_VERSION;
+    this->header.chunkNRecords = (0 < chunkNRecords ? chunkNRecords : 1);
+    this->chunks.clear();
+    this->numberOfRecords = 0;
+}
+
+
+/*!
+ * \brief Appends the next chunk.
+ * \param offset Offset of the compressed chunk in the las-file.
+ * \param nRecords Number of point records in the chunk.
+ * \param nBytes Size of the compressed chunk.
+ * \return True, if the chunk was appended. Only the last chunk may hold less than chunkNRecords records.
+ */
+bool LasChunkTable::append(qint64 offset, qint64 nRecords, qint64 nBytes)
+{
+    LasCompressedChunk chunk;
+
+    if (offset < 0 || nRecords <= 0 || this->header.chunkNRecords < nRecords || nBytes <= 0 || 0xFFFFFFFFLL < nBytes) return false;
+    if (this->numberOfRecords % this->header.chunkNRecords != 0) return false;
+
+    chunk.offset = quint64(offset);
+    chunk.numberOfRecords = quint32(nRecords);
+    chunk.numberOfBytes = quint32(nBytes);
+    this->chunks.append(chunk);
+    this->header.numberOfChunks++;
+    this->numberOfRecords += quint64(nRecords);
+    return true;
+}
+
+
+/*!
+ * \brief Returns the number of point records in a chunk.
+ * \return Number of records.
+ */
+quint32 LasChunkTable::getChunkNRecords()
+{
+    return this->header.chunkNRecords;
+}
+
+
+/*!
+ * \brief Returns the number of chunks.
+ * \return Number of chunks.
+ */
+qint64 LasChunkTable::getNumberOfChunks()
+{
+    return qint64(this->header.numberOfChunks);
+}
+
+
+/*!
+ * \brief Returns the number of point records in all chunks.
+ * \return Number of records.
+ */
+quint64 LasChunkTable::getNumberOfRecords()
+{
+    return this->numberOfRecords;
+}
+
+
+/*!
+ * \brief Returns the offset following the last chunk.
+ * \param dataOffset Offset of the first chunk, used if the table is empty.
+ * \return Offset of the next chunk.
+ */
+qint64 LasChunkTable::getEndOffset(qint64 dataOffset)
+{
+    if (this->chunks.isEmpty()) return dataOffset;
+    const LasCompressedChunk &chunk = this->chunks[this->chunks.size() - 1];
+    return qint64(chunk.offset + chunk.numberOfBytes);
+}
+
+
+/*!
+ * \brief Returns the size of the table stored in the file.
+ * \return Number of bytes of the table header and all chunk descriptors.
+ */
+qint64 LasChunkTable::getTableLength()
+{
+    return qint64(sizeof(LasChunkTableHeader)) + qint64(this->chunks.size()) * qint64(sizeof(LasCompressedChunk));
+}
+
+
+/*!
+ * \brief Returns a chunk.
+ * \param iChunk Index of the chunk, must be valid.
+ * \return Chunk descriptor.
+ */
+const LasCompressedChunk &LasChunkTable::getChunk(qint64 iChunk)
+{
+    return this->chunks[int(iChunk)];
+}
+
+
+/*!
+ * \brief Reads the table from a las-file.
+ * \param file Las-file, open for reading.
+ * \param offset Offset of the table.
+ * \return True, if the table was read and all chunks are stored inside the file.
+ */
+bool LasChunkTable::read(QFile &file, qint64 offset)
+{
+    LasChunkTableHeader tableHeader;
+    LasCompressedChunk chunk;
+    qint64 fileSize = file.size();
+    bool error = false;
+
+    this->clear();
+
+    error = (offset < 0 || fileSize < offset + qint64(sizeof(LasChunkTableHeader)));
+    if (!error) error = !file.seek(offset);
+    if (!error) error = file.read((char *)&tableHeader, sizeof(LasChunkTableHeader)) != sizeof(LasChunkTableHeader);
+    if (!error) error = memcmp(tableHeader.signature, "LSCT", LAS_CHUNK_TABLE_SIGNATURE_LENGTH) != 0;
+    if (!error) error = tableHeader.version != LAS_CHUNK_TABLE_VERSION || tableHeader.chunkNRecords == 0;
+    if (!error) error = quint64(fileSize - offset - qint64(sizeof(LasChunkTableHeader))) / sizeof(LasCompressedChunk) < tableHeader.numberOfChunks;
+    if (!error)
+    {
+        this->clear(tableHeader.chunkNRecords);
+        for (quint64 i = 0; i < tableHeader.numberOfChunks && !error; i++)
+        {
+            error = file.read((char *)&chunk, sizeof(LasCompressedChunk)) != sizeof(LasCompressedChunk);
+            if (!error) error = (quint64(offset) < chunk.offset + chunk.numberOfBytes);
+            if (!error) error = !append(qint64(chunk.offset), chunk.numberOfRecords, chunk.numberOfBytes);
+        }
+    }
+
+    if (error) this->clear();
+    return !error;
+}
+
+
+/*!
+ * \brief Writes the table into a las-file.
+ * \param file Las-file, open for writing.
+ * \param offset Offset of the table, following the last chunk.
+ * \return True, if the table was written successfully.
+ */
+bool LasChunkTable::write(QFile &file, qint64 offset)
+{
+    qint64 nBytes = qint64(this->chunks.size()) * qint64(sizeof(LasCompressedChunk));
+    bool error = false;
+
+    error = !file.seek(offset);
+    if (!error) error = file.write((char *)&this->header, sizeof(LasChunkTableHeader)) != sizeof(LasChunkTableHeader);
+    if (!error && 0 < nBytes) error = file.write((char *)this->chunks.data(), nBytes) != nBytes;
+    return !error;
+}
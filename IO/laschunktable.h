@@ -0,0 +1,58 @@
+#ifndef LASCHUNKTABLE_H
+#define LASCHUNKTABLE_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laschunktable.h
+ *
+ * \brief Table of compressed chunks of point records.
+ * \remark Compressed point data start with the offset of the table (qint64) followed by chunks,
+ *         the table is written after the last chunk when the las-file is closed.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QFile>
+#include <QVector>
+#include "g3dtlas_global.h"
+#include "IO/laschunktableheader.h"
+#include "IO/lascompressedchunk.h"
+
+#define LAS_COMPRESSED_CHUNK_NRECORDS (64*1024)     //!< number of point records in a compressed chunk, equal to the zone map chunk
+
+
+/*!
+ * \brief The LasChunkTable class.
+ * Offsets and sizes of compressed chunks, every chunk except the last one holds chunkNRecords records.
+ */
+class G3DTLAS_EXPORT LasChunkTable
+{
+protected:
+    LasChunkTableHeader header;         //!< header
+    QVector<LasCompressedChunk> chunks; //!< chunks in the order of point records
+    quint64 numberOfRecords = 0;        //!< number of records in all chunks
+
+public:
+    LasChunkTable();
+
+    void clear(quint32 chunkNRecords = LAS_COMPRESSED_CHUNK_NRECORDS);
+    bool append(qint64 offset, qint64 nRecords, qint64 nBytes);
+
+    quint32 getChunkNRecords();
+    qint64 getNumberOfChunks();
+    quint64 getNumberOfRecords();
+    qint64 getEndOffset(qint64 dataOffset);
+    qint64 getTableLength();
+    const LasCompressedChunk &getChunk(qint64 iChunk);
+
+    bool read(QFile &file, qint64 offset);
+    bool write(QFile &file, qint64 offset);
+};
+
+#endif // LASCHUNKTABLE_H
@@ -0,0 +1,42 @@
+#ifndef LASCHUNKTABLEHEADER_H
+#define LASCHUNKTABLEHEADER_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laschunktableheader.h
+ *
+ * \brief Header of the table of compressed chunks of point records.
+ * \remark The header is followed by numberOfChunks chunk descriptors (LasCompressedChunk).
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+
+#define LAS_CHUNK_TABLE_SIGNATURE_LENGTH (4)
+#define LAS_CHUNK_TABLE_VERSION (1)
+
+#pragma pack(1)
+
+/*!
+ * \brief Header of the table of compressed chunks.
+ * \remark size = 24
+ */
+struct LasChunkTableHeader
+{
+    char signature[LAS_CHUNK_TABLE_SIGNATURE_LENGTH]; //!< "LSCT"
+    quint32 version;                //!< LAS_CHUNK_TABLE_VERSION
+    quint32 chunkNRecords;          //!< number of point records in a chunk, the last chunk may be shorter
+    quint32 reserved;               //!< set to zero
+    quint64 numberOfChunks;         //!< number of chunks
+};
+
+#pragma pack()
+
+#endif // LASCHUNKTABLEHEADER_H
@@ -0,0 +1,36 @@
+#ifndef LASCOMPRESSEDCHUNK_H
+#define LASCOMPRESSEDCHUNK_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lascompressedchunk.h
+ *
+ * \brief Descriptor of a compressed chunk of point records.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+
+#pragma pack(1)
+
+/*!
+ * \brief Position and size of a compressed chunk in the las-file.
+ * \remark size = 16
+ */
+struct LasCompressedChunk
+{
+    quint64 offset;             //!< offset of the compressed chunk in the las-file
+    quint32 numberOfRecords;    //!< number of point records in the chunk
+    quint32 numberOfBytes;      //!< size of the compressed chunk in bytes
+};
+
+#pragma pack()
+
+#endif // LASCOMPRESSEDCHUNK_H
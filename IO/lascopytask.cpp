@@ -0,0 +1,109 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lascopytask.cpp
+ *
+ * \brief The implementation of the LasCopyTask class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "lascopytask.h"
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+
+/*!
+ * \brief Constructor.
+ * \param sourceName Source file name.
+ * \param sourceStart Offset of the first copied byte in the source file.
+ * \param targetName Target file name, the file must exist.
+ * \param targetStart Offset of the first written byte in the target file.
+ * \param nBytes Number of copied bytes.
+ * \param errors Error counter shared by tasks.
+ */
+LasCopyTask::LasCopyTask(QString sourceName, qint64 sourceStart, QString targetName, qint64 targetStart, qint64 nBytes, QAtomicInt *errors)
+{
+    this->sourceFileName = sourceName;
+    this->sourceOffset = sourceStart;
+    this->targetFileName = targetName;
+    this->targetOffset = targetStart;
+    this->length = nBytes;
+    this->errorCount = errors;
+}
+
+
+/*!
+ * \brief Opens both files and copies the range.
+ */
+void LasCopyTask::run()
+{
+    QFile source(this->sourceFileName);
+    QFile target(this->targetFileName);
+    bool error;
+
+    error = !source.open(QFile::ReadOnly);
+    if (!error) error = !target.open(QFile::ReadWrite);
+    if (!error) error = !copy(source, this->sourceOffset, target, this->targetOffset, this->length);
+    if (!error) error = !target.flush();
+
+    if (error) this->errorCount->fetchAndAddOrdered(1);
+}
+
+
+/*!
+ * \brief Copies a range of bytes between two open files.
+ * \param source Source file, open for reading.
+ * \param sourceStart Offset of the first copied byte in the source file.
+ * \param target Target file, open for writing.
+ * \param targetStart Offset of the first written byte in the target file.
+ * \param nBytes Number of copied bytes.
+ * \return True, if all bytes were copied successfully.
+ * \remark On Linux bytes are copied by the kernel (copy_file_range), otherwise in blocks of LAS_COPY_BLOCK_SIZE bytes.
+ *         Buffered writes of both files are flushed first.
+ */
+bool LasCopyTask::copy(QFile &source, qint64 sourceStart, QFile &target, qint64 targetStart, qint64 nBytes)
+{
+    qint64 nBlock;
+    char *buf;
+    bool error = false;
+
+    if (!source.flush() || !target.flush()) return false;
+
+#ifdef Q_OS_LINUX
+    loff_t inOffset = sourceStart, outOffset = targetStart;
+    ssize_t nCopied;
+
+    while (0 < nBytes)
+    {
+        nCopied = copy_file_range(source.handle(), &inOffset, target.handle(), &outOffset, size_t(qMin(nBytes, qint64(LAS_COPY_BLOCK_SIZE))), 0);
+        if (nCopied <= 0) break; // not supported (e.g. between file systems), continue with buffered copy
+        nBytes -= nCopied;
+    }
+    sourceStart = inOffset;
+    targetStart = outOffset;
+#endif
+
+    if (nBytes <= 0) return true;
+    buf = new char[size_t(qMin(nBytes, qint64(LAS_COPY_BLOCK_SIZE)))];
+    while (0 < nBytes && !error)
+    {
+        nBlock = qMin(nBytes, qint64(LAS_COPY_BLOCK_SIZE));
+        error = !source.seek(sourceStart);
+        if (!error) error = (source.read(buf, nBlock) != nBlock);
+        if (!error) error = !target.seek(targetStart);
+        if (!error) error = (target.write(buf, nBlock) != nBlock);
+        sourceStart += nBlock;
+        targetStart += nBlock;
+        nBytes -= nBlock;
+    }
+    delete [] buf;
+
+    return !error;
+}
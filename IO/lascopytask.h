@@ -0,0 +1,51 @@
+#ifndef LASCOPYTASK_H
+#define LASCOPYTASK_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lascopytask.h
+ *
+ * \brief Copying of byte ranges between files.
+ * \remark LasCopyTask copies one range in a thread pool,
+ *         every task uses its own file handles.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QAtomicInt>
+#include <QFile>
+#include <QRunnable>
+#include "g3dtlas_global.h"
+
+#define LAS_COPY_BLOCK_SIZE (16*1024*1024) //!< size of blocks copied through memory
+
+
+/*!
+ * \brief The LasCopyTask class.
+ * Copies a range of bytes from a source file to a target file.
+ */
+class G3DTLAS_EXPORT LasCopyTask : public QRunnable
+{
+protected:
+    QString sourceFileName;     //!< source file name
+    qint64 sourceOffset;        //!< offset of the first copied byte in the source file
+    QString targetFileName;     //!< target file name, the file must exist
+    qint64 targetOffset;        //!< offset of the first written byte in the target file
+    qint64 length;              //!< number of copied bytes
+    QAtomicInt *errorCount;     //!< incremented, if the copying fails
+
+public:
+    LasCopyTask(QString sourceName, qint64 sourceStart, QString targetName, qint64 targetStart, qint64 nBytes, QAtomicInt *errors);
+
+    void run();
+
+    static bool copy(QFile &source, qint64 sourceStart, QFile &target, qint64 targetStart, qint64 nBytes);
+};
+
+#endif // LASCOPYTASK_H
@@ -0,0 +1,203 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasfilereader.cpp
+ *
+ * \brief The implementation of the LasFileReader class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "lasfilereader.h"
+
+
+/*!
+ * \brief Constructor.
+ * \param las Open las-file shared by readers.
+ * \param bufferNumberOfRecords Number of records buffered by the reader, the buffer is not used if the file is mapped.
+ */
+LasFileReader::LasFileReader(LasFile &las, qint64 bufferNumberOfRecords)
+{
+    this->lasFile = &las;
+    this->bufferNRecords = (0 < bufferNumberOfRecords ? bufferNumberOfRecords : 1);
+}
+
+
+/*!
+ * \brief Destructor.
+ */
+LasFileReader::~LasFileReader()
+{
+    if (this->buffer != nullptr) delete[] this->buffer;
+}
+
+
+/*!
+ * \brief Reads a point.
+ * \param iPoint Index of the point.
+ * \param lasPoint Returns the point.
+ * \param fields Bit mask of decoded fields (LasPointFields).
+ * \return True, if the point was read successfully.
+ */
+bool LasFileReader::readPoint(qint64 iPoint, LasPoint &lasPoint, quint32 fields)
+{
+    qint64 nRecords;
+    char *buf;
+
+    if (!isValidRange(iPoint, 1)) return false;
+
+    buf = pointRecords(iPoint, nRecords);
+    if (buf == nullptr) return false;
+    this->lasFile->decodePoints(buf, 1, &lasPoint, fields);
+    return true;
+}
+
+
+/*!
+ * \brief Reads a run of points.
+ * \param firstPoint Index of the first point.
+ * \param nPoints Number of points.
+ * \param lasPoints Array of nPoints points.
+ * \param fields Bit mask of decoded fields (LasPointFields).
+ * \return True, if all points were read successfully.
+ */
+bool LasFileReader::readPoints(qint64 firstPoint, qint64 nPoints, LasPoint *lasPoints, quint32 fields)
+{
+    qint64 nRecords;
+    char *buf;
+
+    if (lasPoints == nullptr || !isValidRange(firstPoint, nPoints)) return false;
+
+    while (0 < nPoints)
+    {
+        buf = pointRecords(firstPoint, nRecords);
+        if (buf == nullptr) return false;
+        if (nPoints < nRecords) nRecords = nPoints;
+        this->lasFile->decodePoints(buf, nRecords, lasPoints, fields);
+        lasPoints += nRecords;
+        firstPoint += nRecords;
+        nPoints -= nRecords;
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief Reads a run of points into a columnar batch.
+ * \param firstPoint Index of the first point.
+ * \param nPoints Number of points.
+ * \param batch Batch, allocated for nPoints points if needed.
+ * \param fields Bit mask of decoded fields (LasPointFields).
+ * \return True, if all points were read successfully.
+ */
+bool LasFileReader::readPointBatch(qint64 firstPoint, qint64 nPoints, LasPointBatch &batch, quint32 fields)
+{
+    const LasFileHeader14 &header = this->lasFile->dataFileHeader;
+    quint32 extraDataLength = 0;
+    qint64 iBatch = 0;
+    qint64 nRecords;
+    char *buf;
+
+    if (!isValidRange(firstPoint, nPoints)) return false;
+
+    if (this->lasFile->getStandardPointRecordLength() < header.point_record_length)
+        extraDataLength = header.point_record_length - this->lasFile->getStandardPointRecordLength();
+    if (!batch.allocate(nPoints, extraDataLength, fields)) return false;
+    batch.firstPoint = firstPoint;
+    batch.numberOfPoints = 0;
+
+    while (iBatch < nPoints)
+    {
+        buf = pointRecords(firstPoint + iBatch, nRecords);
+        if (buf == nullptr) return false;
+        if (nPoints - iBatch < nRecords) nRecords = nPoints - iBatch;
+        this->lasFile->decodeBatch(buf, nRecords, batch, iBatch, fields);
+        iBatch += nRecords;
+    }
+
+    batch.numberOfPoints = nPoints;
+    if (fields & LAS_FIELD_XYZ)
+    {
+        LasCoordinates::unscale(batch.ix, batch.x, nPoints, header.scale_x, header.offset_x);
+        LasCoordinates::unscale(batch.iy, batch.y, nPoints, header.scale_y, header.offset_y);
+        LasCoordinates::unscale(batch.iz, batch.z, nPoints, header.scale_z, header.offset_z);
+    }
+
+    return true;
+}
+
+
+/*!
+ * \brief Checks if a run of points is stored in the las-file.
+ * \param firstPoint Index of the first point.
+ * \param nPoints Number of points.
+ * \return True, if the file is open and contains all points.
+ */
+bool LasFileReader::isValidRange(qint64 firstPoint, qint64 nPoints)
+{
+    if (!this->lasFile->isOpen()) return false;
+    return (0 <= firstPoint && 0 <= nPoints && firstPoint <= qint64(this->lasFile->dataFileHeader.number_of_points) - nPoints);
+}
+
+
+/*!
+ * \brief Gets the pointer to point records in memory.
+ * \param iPoint Index of the first required point.
+ * \param nRecords Returns the number of consecutive records available from the returned pointer.
+ * \return Pointer to the record of iPoint in the mapped memory or in the buffer of the reader, nullptr if records cannot be read.
+ * \remark The buffer is filled by a positional read starting at iPoint, compressed files are read by whole chunks.
+ */
+char *LasFileReader::pointRecords(qint64 iPoint, qint64 &nRecords)
+{
+    const LasFileHeader14 &header = this->lasFile->dataFileHeader;
+    qint64 n, chunkNRecords;
+
+    nRecords = 0;
+
+    if (iPoint < this->lasFile->mappedNumberOfRecords)
+    {
+        nRecords = this->lasFile->mappedNumberOfRecords - iPoint;
+        return reinterpret_cast<char*>(this->lasFile->mappedData) + header.offset_to_point_data + iPoint * header.point_record_length;
+    }
+
+    if (this->lasFile->isCompressed() && (iPoint < this->bufferFirstRecord || this->bufferFirstRecord + this->bufferNumberOfRecords <= iPoint))
+    {
+        // the buffer holds one decompressed chunk
+        chunkNRecords = this->lasFile->chunkTable.getChunkNRecords();
+        if (this->buffer != nullptr && this->bufferNRecords < chunkNRecords)
+        {
+            delete[] this->buffer;
+            this->buffer = nullptr;
+        }
+        if (this->buffer == nullptr)
+        {
+            this->bufferNRecords = chunkNRecords;
+            this->buffer = new char[size_t(this->bufferNRecords * header.point_record_length)];
+        }
+        this->bufferFirstRecord = -1;
+        this->bufferNumberOfRecords = 0;
+        if (!this->lasFile->readChunkAt(iPoint / chunkNRecords, this->buffer, n)) return nullptr;
+        this->bufferFirstRecord = iPoint - iPoint % chunkNRecords;
+        this->bufferNumberOfRecords = n;
+    }
+
+    if (iPoint < this->bufferFirstRecord || this->bufferFirstRecord + this->bufferNumberOfRecords <= iPoint)
+    {
+        if (this->buffer == nullptr) this->buffer = new char[size_t(this->bufferNRecords * header.point_record_length)];
+        n = qMin(this->bufferNRecords, qint64(header.number_of_points) - iPoint);
+        this->bufferFirstRecord = -1;
+        this->bufferNumberOfRecords = 0;
+        if (!this->lasFile->readPointRecordsAt(iPoint, n, this->buffer)) return nullptr;
+        this->bufferFirstRecord = iPoint;
+        this->bufferNumberOfRecords = n;
+    }
+
+    nRecords = this->bufferFirstRecord + this->bufferNumberOfRecords - iPoint;
+    return this->buffer + (iPoint - this->bufferFirstRecord) * header.point_record_length;
+}
@@ -0,0 +1,96 @@
+#ifndef LASFILEREADER_H
+#define LASFILEREADER_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasfilereader.h
+ *
+ * \brief Reader of points of a las-file shared by several threads.
+ * \remark Every thread uses its own reader, readers of one las-file do not share any state
+ *         except the open file handle and the memory mapping.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+#include "lasfile.h"
+
+#define LAS_FILE_READER_NRECORDS (64*1024)      //!< default number of records buffered by a reader
+
+
+/*!
+ * \brief The LasFileReader class.
+ * Per-thread read access to an open las-file.
+ * \remark Records are decoded directly from the mapped file, otherwise they are read by positional reads into the buffer of the reader.
+ *         The las-file must not be changed or closed while readers are used, open it with LAS_ACCESS_CONCURRENT.
+ */
+class G3DTLAS_EXPORT LasFileReader
+{
+protected:
+    LasFile *lasFile;                   //!< shared las-file
+    char *buffer = nullptr;             //!< records read by the reader, allocated on the first read
+    qint64 bufferNRecords = 0;          //!< capacity of the buffer
+    qint64 bufferFirstRecord = -1;      //!< index of the first buffered record
+    qint64 bufferNumberOfRecords = 0;   //!< number of valid records in the buffer
+
+public:
+    LasFileReader(LasFile &las, qint64 bufferNumberOfRecords = LAS_FILE_READER_NRECORDS);
+    ~LasFileReader();
+
+    bool readPoint(qint64 iPoint, LasPoint &lasPoint, quint32 fields = LAS_FIELD_ALL);
+    bool readPoints(qint64 firstPoint, qint64 nPoints, LasPoint *lasPoints, quint32 fields = LAS_FIELD_ALL);
+    bool readPointBatch(qint64 firstPoint, qint64 nPoints, LasPointBatch &batch, quint32 fields = LAS_FIELD_ALL);
+    template<class F> bool forEachPoint(qint64 firstPoint, qint64 nPoints, F function, quint32 fields = LAS_FIELD_ALL);
+
+protected:
+    bool isValidRange(qint64 firstPoint, qint64 nPoints);
+    char *pointRecords(qint64 iPoint, qint64 &nRecords);
+
+private:
+    Q_DISABLE_COPY(LasFileReader)
+};
+
+
+/*!
+ * \brief Calls a function for each point of a contiguous run of points.
+ * \param firstPoint Index of the first point.
+ * \param nPoints Number of points.
+ * \param function Function or functor bool(qint64 iPoint, LasPoint &lasPoint), returns false to stop the iteration.
+ * \param fields Bit mask of decoded fields (LasPointFields).
+ * \return True, if all points were read successfully or the iteration was stopped by the function.
+ * \remark The same las-point object is passed to all calls.
+ */
+template<class F>
+bool LasFileReader::forEachPoint(qint64 firstPoint, qint64 nPoints, F function, quint32 fields)
+{
+    LasPoint lasPoint;
+    char *buf;
+    qint64 nRecords, i;
+    const quint16 recordLength = this->lasFile->dataFileHeader.point_record_length;
+
+    if (!isValidRange(firstPoint, nPoints)) return false;
+
+    while (0 < nPoints)
+    {
+        buf = pointRecords(firstPoint, nRecords);
+        if (buf == nullptr) return false;
+        if (nPoints < nRecords) nRecords = nPoints;
+        for(i = 0; i < nRecords; i++, buf += recordLength)
+        {
+            this->lasFile->decodePoints(buf, 1, &lasPoint, fields);
+            if (!function(firstPoint + i, lasPoint)) return true;
+        }
+        firstPoint += nRecords;
+        nPoints -= nRecords;
+    }
+
+    return true;
+}
+
+#endif // LASFILEREADER_H
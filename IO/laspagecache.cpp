@@ -0,0 +1,388 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laspagecache.cpp
+ *
+ * \brief The implementation of the LasPageCache class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <algorithm>
+#include <QVector>
+#include "laspagecache.h"
+
+
+/*!
+ * \brief Constructor.
+ */
+LasPageCache::LasPageCache()
+{
+}
+
+
+/*!
+ * \brief Destructor. Dirty pages are not written.
+ */
+LasPageCache::~LasPageCache()
+{
+    release();
+}
+
+
+/*!
+ * \brief Allocates page slots.
+ * \param lasFile Las-file, open for reading.
+ * \param pointDataOffset Offset of the first point record in the file.
+ * \param pointRecordLength Length of point records.
+ * \param pageNumberOfRecords Number of records in a page.
+ * \param numberOfPages Number of cached pages.
+ * \return True, if the cache was allocated.
+ * \remark Memory of a page is allocated on the first use of its slot.
+ */
+bool LasPageCache::allocate(QFile *lasFile, qint64 pointDataOffset, quint16 pointRecordLength, qint64 pageNumberOfRecords, int numberOfPages)
+{
+    release();
+    if (lasFile == nullptr || pointRecordLength == 0 || pageNumberOfRecords <= 0 || numberOfPages <= 0) return false;
+
+    this->file = lasFile;
+    this->dataOffset = pointDataOffset;
+    this->recordLength = pointRecordLength;
+    this->pageNRecords = pageNumberOfRecords;
+    this->nPages = numberOfPages;
+    this->pages = new LasCachePage[numberOfPages];
+    for (int i = 0; i < numberOfPages; i++)
+    {
+        this->pages[i].iPage = -1;
+        this->pages[i].nRecords = 0;
+        this->pages[i].data = nullptr;
+        this->pages[i].dirty = false;
+        this->pages[i].lastUse = 0;
+    }
+    return true;
+}
+
+
+/*!
+ * \brief Releases all pages. Dirty pages are not written.
+ */
+void LasPageCache::release()
+{
+    if (this->pages != nullptr)
+    {
+        for (int i = 0; i < this->nPages; i++)
+            if (this->pages[i].data != nullptr) delete[] this->pages[i].data;
+        delete[] this->pages;
+        this->pages = nullptr;
+    }
+    this->pageSlots.clear();
+    this->file = nullptr;
+    this->nPages = 0;
+    this->pageNRecords = 0;
+    this->useTick = 0;
+}
+
+
+/*!
+ * \brief Checks if page slots are allocated.
+ * \return True, if the cache is allocated.
+ */
+bool LasPageCache::isAllocated()
+{
+    return (this->pages != nullptr);
+}
+
+
+/*!
+ * \brief Sets the offset of point records, after VLRs were added.
+ * \param pointDataOffset Offset of the first point record in the file.
+ * \remark Cached pages are not moved, the cache should be invalidated.
+ */
+void LasPageCache::setDataOffset(qint64 pointDataOffset)
+{
+    this->dataOffset = pointDataOffset;
+}
+
+
+/*!
+ * \brief Returns the number of records in a page.
+ * \return Number of records.
+ */
+qint64 LasPageCache::getPageNRecords()
+{
+    return this->pageNRecords;
+}
+
+
+/*!
+ * \brief Returns the number of page slots.
+ * \return Number of pages.
+ */
+int LasPageCache::getNumberOfPages()
+{
+    return this->nPages;
+}
+
+
+/*!
+ * \brief Returns the number of requests served from cached pages.
+ * \return Number of hits.
+ */
+quint64 LasPageCache::getHits()
+{
+    return this->hits;
+}
+
+
+/*!
+ * \brief Returns the number of pages loaded into the cache.
+ * \return Number of misses.
+ */
+quint64 LasPageCache::getMisses()
+{
+    return this->misses;
+}
+
+
+/*!
+ * \brief Sets hit and miss counters to zero.
+ */
+void LasPageCache::resetCounters()
+{
+    this->hits = 0;
+    this->misses = 0;
+}
+
+
+/*!
+ * \brief Finds a record in cached pages.
+ * \param iRecord Index of the record.
+ * \param nRecords Returns the number of consecutive records available from the returned pointer.
+ * \return Pointer to the record, nullptr if the record is not cached.
+ */
+char *LasPageCache::find(qint64 iRecord, qint64 &nRecords)
+{
+    qint64 iPage, i;
+    int slot;
+
+    nRecords = 0;
+    if (this->pages == nullptr || iRecord < 0) return nullptr;
+
+    iPage = iRecord / this->pageNRecords;
+    slot = this->pageSlots.value(iPage, -1);
+    if (slot < 0) return nullptr;
+
+    LasCachePage &page = this->pages[slot];
+    i = iRecord - iPage * this->pageNRecords;
+    if (page.nRecords <= i) return nullptr;
+
+    this->hits++;
+    page.lastUse = ++this->useTick;
+    nRecords = page.nRecords - i;
+    return page.data + i * this->recordLength;
+}
+
+
+/*!
+ * \brief Reads the page of a record from the file.
+ * \param iRecord Index of the record.
+ * \param nFileRecords Number of records stored in the file.
+ * \param nRecords Returns the number of consecutive records available from the returned pointer.
+ * \return Pointer to the record, nullptr if the page cannot be read.
+ */
+char *LasPageCache::load(qint64 iRecord, qint64 nFileRecords, qint64 &nRecords)
+{
+    qint64 iPage, firstRecord, n, nLength;
+    char *data;
+    bool error;
+
+    nRecords = 0;
+    if (this->pages == nullptr || iRecord < 0 || nFileRecords <= iRecord) return nullptr;
+
+    iPage = iRecord / this->pageNRecords;
+    firstRecord = iPage * this->pageNRecords;
+    n = qMin(this->pageNRecords, nFileRecords - firstRecord);
+
+    data = detachPage(iPage);
+    if (data == nullptr) return nullptr;
+
+    nLength = n * this->recordLength;
+    error = !this->file->seek(this->dataOffset + firstRecord * this->recordLength);
+    if (!error) error = (this->file->read(data, nLength) != nLength);
+
+    attachPage(iPage, data, error ? 0 : n);
+    if (error) return nullptr;
+
+    nRecords = n - (iRecord - firstRecord);
+    return data + (iRecord - firstRecord) * this->recordLength;
+}
+
+
+/*!
+ * \brief Takes the buffer of the least recently used page to be filled with a page.
+ * \param iPage Index of the page, which will be attached.
+ * \return Buffer of pageNRecords records, nullptr if the evicted page cannot be written.
+ * \remark The previous copy of the page and the evicted page are removed from the cache, the evicted page is written if it is dirty.
+ *         The buffer must be returned by attachPage.
+ */
+char *LasPageCache::detachPage(qint64 iPage)
+{
+    char *data;
+    int slot;
+
+    if (this->pages == nullptr) return nullptr;
+
+    slot = this->pageSlots.value(iPage, -1);
+    if (slot < 0) slot = victimSlot();
+
+    LasCachePage &page = this->pages[slot];
+    if (page.dirty && !writePage(page)) return nullptr;
+    if (0 <= page.iPage) this->pageSlots.remove(page.iPage);
+
+    data = page.data;
+    if (data == nullptr) data = new char[size_t(this->pageNRecords * this->recordLength)];
+    page.iPage = -1;
+    page.nRecords = 0;
+    page.data = nullptr;
+    page.lastUse = 0;
+    this->misses++;
+    return data;
+}
+
+
+/*!
+ * \brief Stores a filled buffer as a cached page.
+ * \param iPage Index of the page.
+ * \param data Buffer returned by detachPage, or a buffer of the same size.
+ * \param nRecords Number of valid records, if zero the buffer is kept in an empty slot.
+ * \return Pointer to the page data.
+ */
+char *LasPageCache::attachPage(qint64 iPage, char *data, qint64 nRecords)
+{
+    int slot = -1;
+
+    for (int i = 0; i < this->nPages && slot < 0; i++)
+        if (this->pages[i].iPage < 0 && this->pages[i].data == nullptr) slot = i;
+    if (slot < 0)
+    {
+        delete[] data;
+        return nullptr;
+    }
+
+    LasCachePage &page = this->pages[slot];
+    page.data = data;
+    page.dirty = false;
+    if (0 < nRecords)
+    {
+        page.iPage = iPage;
+        page.nRecords = nRecords;
+        page.lastUse = ++this->useTick;
+        this->pageSlots.insert(iPage, slot);
+    }
+    return data;
+}
+
+
+/*!
+ * \brief Marks the page of a record as changed.
+ * \param iRecord Index of the record.
+ * \return True, if the record is held in a cached page.
+ * \remark The page is written when it is evicted or flushed.
+ */
+bool LasPageCache::markDirty(qint64 iRecord)
+{
+    qint64 iPage;
+    int slot;
+
+    if (this->pages == nullptr || iRecord < 0) return false;
+    iPage = iRecord / this->pageNRecords;
+    slot = this->pageSlots.value(iPage, -1);
+    if (slot < 0 || this->pages[slot].nRecords <= iRecord - iPage * this->pageNRecords) return false;
+    this->pages[slot].dirty = true;
+    return true;
+}
+
+
+/*!
+ * \brief Writes all dirty pages.
+ * \return True, if all pages were written successfully.
+ * \remark Pages are written in the order of the file.
+ */
+bool LasPageCache::flush()
+{
+    QVector<int> dirtySlots;
+    bool error = false;
+
+    for (int i = 0; i < this->nPages; i++)
+        if (this->pages[i].dirty) dirtySlots.append(i);
+
+    std::sort(dirtySlots.begin(), dirtySlots.end(), [this](int a, int b)
+    {
+        return this->pages[a].iPage < this->pages[b].iPage;
+    });
+
+    for (int i = 0; i < dirtySlots.size() && !error; i++)
+        error = !writePage(this->pages[dirtySlots[i]]);
+    return !error;
+}
+
+
+/*!
+ * \brief Writes dirty pages and removes all pages from the cache.
+ * \return True, if all dirty pages were written successfully.
+ * \remark Page buffers are kept for following loads.
+ */
+bool LasPageCache::invalidate()
+{
+    bool error;
+
+    error = !flush();
+    for (int i = 0; i < this->nPages; i++)
+    {
+        this->pages[i].iPage = -1;
+        this->pages[i].nRecords = 0;
+        this->pages[i].dirty = false;
+        this->pages[i].lastUse = 0;
+    }
+    this->pageSlots.clear();
+    return !error;
+}
+
+
+/*!
+ * \brief Selects the slot of a page to be evicted.
+ * \return Empty slot, otherwise the slot of the least recently used page.
+ */
+int LasPageCache::victimSlot()
+{
+    int slot = 0;
+
+    for (int i = 0; i < this->nPages; i++)
+    {
+        if (this->pages[i].iPage < 0) return i;
+        if (this->pages[i].lastUse < this->pages[slot].lastUse) slot = i;
+    }
+    return slot;
+}
+
+
+/*!
+ * \brief Writes a dirty page into the file.
+ * \param page Page.
+ * \return True, if the page was written successfully.
+ */
+bool LasPageCache::writePage(LasCachePage &page)
+{
+    qint64 nLength = page.nRecords * this->recordLength;
+    bool error;
+
+    error = !this->file->seek(this->dataOffset + page.iPage * this->pageNRecords * this->recordLength);
+    if (!error) error = (this->file->write(page.data, nLength) != nLength);
+    if (!error) page.dirty = false;
+    return !error;
+}
@@ -0,0 +1,89 @@
+#ifndef LASPAGECACHE_H
+#define LASPAGECACHE_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laspagecache.h
+ *
+ * \brief Cache of point record pages.
+ * \remark Point records are split into pages of a fixed number of records,
+ *         the cache keeps a limited number of pages and evicts the least recently used page.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QFile>
+#include <QHash>
+#include "g3dtlas_global.h"
+
+
+/*!
+ * \brief Page of point records held in the cache.
+ */
+struct LasCachePage
+{
+    qint64 iPage;               //!< index of the page, -1 if the slot is empty
+    qint64 nRecords;            //!< number of valid records in the page, the last page of a file may be shorter
+    char *data;                 //!< records, allocated on the first use of the slot
+    bool dirty;                 //!< changed records must be written before the page is evicted
+    quint64 lastUse;            //!< tick of the last access, used to find the least recently used page
+};
+
+
+/*!
+ * \brief The LasPageCache class.
+ * LRU cache of pages of point records with per-page dirty tracking.
+ */
+class G3DTLAS_EXPORT LasPageCache
+{
+protected:
+    QFile *file = nullptr;              //!< las-file, owned by the caller
+    qint64 dataOffset = 0;              //!< offset of the first point record in the file
+    quint16 recordLength = 0;           //!< length of point records
+    qint64 pageNRecords = 0;            //!< number of records in a page
+    int nPages = 0;                     //!< number of cached pages
+    LasCachePage *pages = nullptr;      //!< page slots
+    QHash<qint64, int> pageSlots;       //!< slots of cached pages
+    quint64 useTick = 0;                //!< access counter
+    quint64 hits = 0;                   //!< number of requests served from cached pages
+    quint64 misses = 0;                 //!< number of pages loaded into the cache
+
+public:
+    LasPageCache();
+    ~LasPageCache();
+
+    bool allocate(QFile *lasFile, qint64 pointDataOffset, quint16 pointRecordLength, qint64 pageNumberOfRecords, int numberOfPages);
+    void release();
+    bool isAllocated();
+    void setDataOffset(qint64 pointDataOffset);
+
+    qint64 getPageNRecords();
+    int getNumberOfPages();
+    quint64 getHits();
+    quint64 getMisses();
+    void resetCounters();
+
+    char *find(qint64 iRecord, qint64 &nRecords);
+    char *load(qint64 iRecord, qint64 nFileRecords, qint64 &nRecords);
+    char *detachPage(qint64 iPage);
+    char *attachPage(qint64 iPage, char *data, qint64 nRecords);
+    bool markDirty(qint64 iRecord);
+
+    bool flush();
+    bool invalidate();
+
+protected:
+    int victimSlot();
+    bool writePage(LasCachePage &page);
+
+private:
+    Q_DISABLE_COPY(LasPageCache)
+};
+
+#endif // LASPAGECACHE_H
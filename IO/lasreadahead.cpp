@@ -0,0 +1,197 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasreadahead.cpp
+ *
+ * \brief The implementation of the LasReadAhead class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "lasreadahead.h"
+
+
+/*!
+ * \brief Default constructor.
+ */
+LasReadAhead::LasReadAhead()
+{
+    for (int i = 0; i < LAS_READ_AHEAD_NUMBER_OF_WINDOWS; i++)
+    {
+        this->windowData[i] = nullptr;
+        this->windowFirstRecord[i] = -1;
+        this->windowRecords[i] = 0;
+    }
+}
+
+
+/*!
+ * \brief Destructor. Stops the thread and releases buffers.
+ */
+LasReadAhead::~LasReadAhead()
+{
+    end();
+}
+
+
+/*!
+ * \brief Opens the las-file and starts reading from the first record.
+ * \param fileName Las-file name.
+ * \param pointDataOffset Offset of the first point record in the file.
+ * \param pointRecordLength Length of a point record.
+ * \param nRecords Number of point records in the file.
+ * \param windowNRecords Number of records in a window, must be equal to the number of records of the point cache.
+ * \return True, if the file was open and the thread started.
+ */
+bool LasReadAhead::begin(QString fileName, qint64 pointDataOffset, qint64 pointRecordLength, qint64 nRecords, qint64 windowNRecords)
+{
+    end();
+    if (pointRecordLength <= 0 || windowNRecords <= 0) return false;
+
+    this->dataFile.setFileName(fileName);
+    if (!this->dataFile.open(QFile::ReadOnly)) return false;
+
+    this->offsetToPointData = pointDataOffset;
+    this->recordLength = pointRecordLength;
+    this->numberOfRecords = nRecords;
+    this->windowNumberOfRecords = windowNRecords;
+    for (int i = 0; i < LAS_READ_AHEAD_NUMBER_OF_WINDOWS; i++)
+        this->windowData[i] = new char[quint64(windowNRecords * pointRecordLength)];
+
+    this->firstWindow = 0;
+    this->numberOfWindows = 0;
+    this->nextRecord = 0;
+    this->readError = false;
+    this->stopRequested = false;
+
+    start();
+    return true;
+}
+
+
+/*!
+ * \brief Stops the thread, closes the file and releases buffers.
+ */
+void LasReadAhead::end()
+{
+    this->mutex.lock();
+    this->stopRequested = true;
+    this->windowReleased.wakeAll();
+    this->mutex.unlock();
+    wait();
+
+    for (int i = 0; i < LAS_READ_AHEAD_NUMBER_OF_WINDOWS; i++)
+    {
+        if (this->windowData[i] != nullptr)
+        {
+            delete [] this->windowData[i];
+            this->windowData[i] = nullptr;
+        }
+    }
+    this->numberOfWindows = 0;
+    if (this->dataFile.isOpen()) this->dataFile.close();
+}
+
+
+/*!
+ * \brief Takes the window starting at a given record.
+ * \param firstRecord Index of the first record of the window.
+ * \param buffer Input: released buffer of windowNRecords records, output: buffer with the read window.
+ * \param nRecords Returns the number of records in the window.
+ * \return True, if the window was read successfully.
+ * \remark If the window was not read ahead, reading restarts at firstRecord and the caller waits.
+ *         The following windows are read ahead into the released buffers.
+ */
+bool LasReadAhead::fetch(qint64 firstRecord, char *&buffer, qint64 &nRecords)
+{
+    char *readBuffer;
+    bool error = true;
+
+    nRecords = 0;
+    if (buffer == nullptr || firstRecord < 0 || this->numberOfRecords <= firstRecord) return false;
+
+    this->mutex.lock();
+    if (!(0 < this->numberOfWindows && this->windowFirstRecord[this->firstWindow] == firstRecord) &&
+        !(this->numberOfWindows == 0 && this->nextRecord == firstRecord && !this->readError))
+    {
+        // random access, restart reading at the requested record
+        this->generation++;
+        this->firstWindow = 0;
+        this->numberOfWindows = 0;
+        this->nextRecord = firstRecord;
+        this->readError = false;
+        this->windowReleased.wakeAll();
+    }
+
+    while (this->numberOfWindows == 0 && !this->readError && !this->stopRequested)
+        this->windowRead.wait(&this->mutex);
+
+    if (0 < this->numberOfWindows)
+    {
+        readBuffer = this->windowData[this->firstWindow];
+        this->windowData[this->firstWindow] = buffer;
+        buffer = readBuffer;
+        nRecords = this->windowRecords[this->firstWindow];
+        this->firstWindow = (this->firstWindow + 1) % LAS_READ_AHEAD_NUMBER_OF_WINDOWS;
+        this->numberOfWindows--;
+        this->windowReleased.wakeAll();
+        error = false;
+    }
+    this->mutex.unlock();
+
+    return !error;
+}
+
+
+/*!
+ * \brief Thread function, reads windows into free buffers.
+ */
+void LasReadAhead::run()
+{
+    int iWindow;
+    qint64 firstRecord, nRecords, nLength;
+    quint64 readGeneration;
+    bool error;
+
+    this->mutex.lock();
+    while (!this->stopRequested)
+    {
+        if (this->numberOfWindows == LAS_READ_AHEAD_NUMBER_OF_WINDOWS || this->numberOfRecords <= this->nextRecord || this->readError)
+        {
+            this->windowReleased.wait(&this->mutex);
+            continue;
+        }
+
+        // the free window is not accessed by the caller, read it unlocked
+        iWindow = (this->firstWindow + this->numberOfWindows) % LAS_READ_AHEAD_NUMBER_OF_WINDOWS;
+        firstRecord = this->nextRecord;
+        nRecords = qMin(this->windowNumberOfRecords, this->numberOfRecords - firstRecord);
+        readGeneration = this->generation;
+        this->mutex.unlock();
+
+        nLength = nRecords * this->recordLength;
+        error = !this->dataFile.seek(this->offsetToPointData + firstRecord * this->recordLength);
+        if (!error) error = (this->dataFile.read(this->windowData[iWindow], nLength) != nLength);
+
+        this->mutex.lock();
+        if (readGeneration == this->generation)
+        {
+            if (error)
+                this->readError = true;
+            else
+            {
+                this->windowFirstRecord[iWindow] = firstRecord;
+                this->windowRecords[iWindow] = nRecords;
+                this->numberOfWindows++;
+                this->nextRecord = firstRecord + nRecords;
+            }
+            this->windowRead.wakeAll();
+        }
+    }
+    this->mutex.unlock();
+}
@@ -0,0 +1,71 @@
+#ifndef LASREADAHEAD_H
+#define LASREADAHEAD_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasreadahead.h
+ *
+ * \brief Background reader of point cache windows.
+ * \remark A worker thread reads the following windows of point records
+ *         into a ring of buffers while the caller decodes the current window.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include "g3dtlas_global.h"
+
+#define LAS_READ_AHEAD_NUMBER_OF_WINDOWS (2) //!< number of windows read ahead, together with the point cache gives triple buffering
+
+
+/*!
+ * \brief The LasReadAhead class.
+ * Reads consecutive windows of point records in a background thread.
+ * \remark The thread uses its own file handle, so the las-file must not be modified while reading ahead.
+ */
+class G3DTLAS_EXPORT LasReadAhead : public QThread
+{
+protected:
+    QFile dataFile;                     //!< own handle of the las-file
+    qint64 offsetToPointData = 0;       //!< offset of the first point record in the file
+    qint64 recordLength = 0;            //!< length of a point record
+    qint64 numberOfRecords = 0;         //!< number of point records in the file
+    qint64 windowNumberOfRecords = 0;   //!< maximal number of records in a window
+
+    QMutex mutex;                       //!< guards the ring of windows
+    QWaitCondition windowRead;          //!< signalled by the thread when a window was read
+    QWaitCondition windowReleased;      //!< signalled by the caller when a window was taken or the position changed
+
+    char *windowData[LAS_READ_AHEAD_NUMBER_OF_WINDOWS];            //!< ring of window buffers
+    qint64 windowFirstRecord[LAS_READ_AHEAD_NUMBER_OF_WINDOWS];    //!< index of the first record of a read window
+    qint64 windowRecords[LAS_READ_AHEAD_NUMBER_OF_WINDOWS];        //!< number of records of a read window
+    int firstWindow = 0;                //!< index of the oldest read window in the ring
+    int numberOfWindows = 0;            //!< number of read windows in the ring
+    qint64 nextRecord = 0;              //!< index of the first record of the next window to read
+    quint64 generation = 0;             //!< incremented on every change of the position, stale windows are discarded
+    bool readError = false;             //!< read error flag
+    bool stopRequested = false;         //!< thread termination flag
+
+public:
+    LasReadAhead();
+    ~LasReadAhead();
+
+    bool begin(QString fileName, qint64 pointDataOffset, qint64 pointRecordLength, qint64 nRecords, qint64 windowNRecords);
+    void end();
+
+    bool fetch(qint64 firstRecord, char *&buffer, qint64 &nRecords);
+
+protected:
+    void run();
+};
+
+#endif // LASREADAHEAD_H
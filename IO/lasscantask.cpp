@@ -0,0 +1,66 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasscantask.cpp
+ *
+ * \brief The implementation of the LasScanTask class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "lasscantask.h"
+#include "laschunkscheduler.h"
+#include "lasfilereader.h"
+
+
+/*!
+ * \brief Constructor.
+ * \param las Scanned las-file.
+ * \param chunkScheduler Scheduler of chunks shared by workers.
+ * \param batchFunction Callback shared by workers.
+ * \param worker Index of the worker.
+ * \param chunkNumberOfRecords Number of records in a chunk.
+ * \param decodedFields Bit mask of decoded fields (LasPointFields).
+ * \param errors Error counter shared by workers.
+ */
+LasScanTask::LasScanTask(LasFile *las, LasChunkScheduler *chunkScheduler, LasBatchFunction *batchFunction, int worker,
+                         qint64 chunkNumberOfRecords, quint32 decodedFields, QAtomicInt *errors)
+{
+    this->lasFile = las;
+    this->scheduler = chunkScheduler;
+    this->function = batchFunction;
+    this->iWorker = worker;
+    this->chunkNRecords = chunkNumberOfRecords;
+    this->fields = decodedFields;
+    this->errorCount = errors;
+}
+
+
+/*!
+ * \brief Processes chunks until all chunks are taken or the scan is stopped.
+ * \remark The worker reads through its own LasFileReader and reuses one batch for all chunks.
+ */
+void LasScanTask::run()
+{
+    LasFileReader reader(*this->lasFile, this->chunkNRecords);
+    LasPointBatch batch;
+    qint64 nPoints = qint64(this->lasFile->getNumberOfPoints());
+    qint64 iChunk, firstPoint;
+
+    while (this->scheduler->next(this->iWorker, iChunk))
+    {
+        firstPoint = iChunk * this->chunkNRecords;
+        if (!reader.readPointBatch(firstPoint, qMin(this->chunkNRecords, nPoints - firstPoint), batch, this->fields))
+        {
+            this->errorCount->fetchAndAddOrdered(1);
+            this->scheduler->stop();
+        }
+        else if (!this->function->call(this->iWorker, batch))
+            this->scheduler->stop();
+    }
+}
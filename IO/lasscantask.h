@@ -0,0 +1,83 @@
+#ifndef LASSCANTASK_H
+#define LASSCANTASK_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasscantask.h
+ *
+ * \brief Worker of the parallel scan of point records.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QAtomicInt>
+#include <QRunnable>
+#include "g3dtlas_global.h"
+#include "Point/laspointbatch.h"
+
+class LasFile;
+class LasChunkScheduler;
+
+
+/*!
+ * \brief Callback of the parallel scan called with batches of decoded points.
+ */
+class G3DTLAS_EXPORT LasBatchFunction
+{
+public:
+    virtual ~LasBatchFunction() {}
+
+    /*!
+     * \brief Processes a batch of points.
+     * \param iThread Index of the worker thread, from 0 to the number of threads - 1.
+     * \param batch Decoded points, batch.firstPoint is the index of the first point in the las-file.
+     * \return False to stop the scan.
+     */
+    virtual bool call(int iThread, LasPointBatch &batch) = 0;
+};
+
+
+/*!
+ * \brief Adapter of a function or functor bool(int iThread, LasPointBatch &batch) to LasBatchFunction.
+ */
+template<class F> class LasBatchFunctionOf : public LasBatchFunction
+{
+protected:
+    F &function;                        //!< called function
+
+public:
+    LasBatchFunctionOf(F &batchFunction) : function(batchFunction) {}
+
+    bool call(int iThread, LasPointBatch &batch) { return function(iThread, batch); }
+};
+
+
+/*!
+ * \brief The LasScanTask class.
+ * Reads and decodes chunks assigned by the scheduler and passes them to the callback.
+ */
+class G3DTLAS_EXPORT LasScanTask : public QRunnable
+{
+protected:
+    LasFile *lasFile;                   //!< scanned las-file
+    LasChunkScheduler *scheduler;       //!< scheduler of chunks
+    LasBatchFunction *function;         //!< callback
+    int iWorker;                        //!< index of the worker
+    qint64 chunkNRecords;               //!< number of records in a chunk, the last chunk may be shorter
+    quint32 fields;                     //!< bit mask of decoded fields (LasPointFields)
+    QAtomicInt *errorCount;             //!< incremented, if a chunk cannot be read
+
+public:
+    LasScanTask(LasFile *las, LasChunkScheduler *chunkScheduler, LasBatchFunction *batchFunction, int worker,
+                qint64 chunkNumberOfRecords, quint32 decodedFields, QAtomicInt *errors);
+
+    void run();
+};
+
+#endif // LASSCANTASK_H
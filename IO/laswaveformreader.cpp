@@ -0,0 +1,268 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laswaveformreader.cpp
+ *
+ * \brief The implementation of the LasWaveformReader class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <cstring>
+#include <QFileInfo>
+#include "laswaveformreader.h"
+
+
+/*!
+ * \brief Returns the number of samples stored in the packet.
+ * \return Number of samples given by the descriptor, limited by the size of the packet.
+ */
+quint32 LasWaveformPacket::getNumberOfSamples() const
+{
+    quint64 n;
+
+    if (this->descriptor == nullptr || this->descriptor->bitsPerSample == 0) return 0;
+    n = quint64(this->size) * 8 / this->descriptor->bitsPerSample;
+    return quint32(qMin(n, quint64(this->descriptor->numberOfSamples)));
+}
+
+
+/*!
+ * \brief Returns a raw sample.
+ * \param iSample Index of the sample, must be less than the number of samples.
+ * \return Waveform amplitude.
+ * \remark Samples of 8, 16, 24 and 32 bits are stored in whole little-endian bytes, other sizes are packed from the least significant bit.
+ */
+quint32 LasWaveformPacket::getSample(quint32 iSample) const
+{
+    const quint8 bits = this->descriptor->bitsPerSample;
+    quint32 value = 0;
+    quint64 bit;
+
+    if (bits % 8 == 0)
+    {
+        memcpy(&value, this->data + quint64(iSample) * (bits / 8), bits / 8);
+        return value;
+    }
+
+    bit = quint64(iSample) * bits;
+    for (quint8 i = 0; i < bits; i++, bit++)
+        if ((this->data[bit >> 3] >> (bit & 7)) & 1) value |= (quint32(1) << i);
+    return value;
+}
+
+
+/*!
+ * \brief Returns a sample converted to volts.
+ * \param iSample Index of the sample, must be less than the number of samples.
+ * \return Digitizer offset + digitizer gain * amplitude.
+ */
+double LasWaveformPacket::getVolts(quint32 iSample) const
+{
+    return this->descriptor->digitizerOffset + this->descriptor->digitizerGain * getSample(iSample);
+}
+
+
+/*!
+ * \brief Constructor.
+ */
+LasWaveformReader::LasWaveformReader()
+{
+    memset(this->descriptors, 0, sizeof(this->descriptors));
+    memset(this->hasDescriptor, 0, sizeof(this->hasDescriptor));
+}
+
+
+/*!
+ * \brief Destructor.
+ */
+LasWaveformReader::~LasWaveformReader()
+{
+    close();
+}
+
+
+/*!
+ * \brief Reads packet descriptors of a las-file and maps its waveform data packets.
+ * \param las Open las-file with point format 4, 5, 9 or 10.
+ * \param externalFileName External waveform data file, if empty the .wdp file of the las-file is used for external packets.
+ * \return True, if waveform data were mapped successfully.
+ * \remark Packets are read from the external file, if the name is given or the global encoding marks external packets.
+ *         Otherwise they are read from the waveform EVLR, or from offset_waveform of LAS 1.3 files.
+ *         The las-file may be closed after the reader is open.
+ */
+bool LasWaveformReader::open(LasFile &las, QString externalFileName)
+{
+    const LasFileHeader14 &header = las.dataFileHeader;
+    qint64 iEVLR, offset;
+    bool error;
+
+    close();
+    if (!las.isOpen() || !las.hasWaveform()) return false;
+
+    error = !readDescriptors(las);
+    if (!error)
+    {
+        iEVLR = las.vlrDirectory.findEVLR(LAS_WAVEFORM_EVLR_USERID, LAS_WAVEFORM_EVLR_RECORDID);
+        if (!externalFileName.isEmpty() || (header.globalEncoding & LAS_GLOBAL_ENCODING_WAVEFORM_EXTERNAL) || (iEVLR < 0 && header.offset_waveform == 0))
+        {
+            // the external file starts with the header of the waveform data packet record
+            if (externalFileName.isEmpty()) externalFileName = waveformFileName(las.getFileName());
+            error = !mapRecord(externalFileName, 0, QFileInfo(externalFileName).size());
+        }
+        else if (0 <= iEVLR)
+        {
+            const LasVLREntry &entry = las.vlrDirectory.getEVLR(iEVLR);
+            error = !mapRecord(las.evlrSpill.isOpen() ? las.evlrSpill.fileName() : las.getFileName(),
+                               entry.headerOffset, entry.dataOffset - entry.headerOffset + qint64(entry.recordLength));
+        }
+        else
+        {
+            // the waveform record of LAS 1.3 is not counted among EVLRs
+            offset = qint64(header.offset_waveform);
+            error = !mapRecord(las.getFileName(), offset, QFileInfo(las.getFileName()).size() - offset);
+        }
+    }
+
+    if (error) close();
+    return !error;
+}
+
+
+/*!
+ * \brief Releases the mapping and closes the waveform data file.
+ */
+void LasWaveformReader::close()
+{
+    if (this->mappedData != nullptr)
+    {
+        this->waveformFile.unmap(const_cast<uchar*>(this->mappedData));
+        this->mappedData = nullptr;
+    }
+    this->mappedLength = 0;
+    if (this->waveformFile.isOpen()) this->waveformFile.close();
+    memset(this->descriptors, 0, sizeof(this->descriptors));
+    memset(this->hasDescriptor, 0, sizeof(this->hasDescriptor));
+}
+
+
+/*!
+ * \brief Checks if waveform data are mapped.
+ * \return True, if packets can be read.
+ */
+bool LasWaveformReader::isOpen()
+{
+    return (this->mappedData != nullptr);
+}
+
+
+/*!
+ * \brief Gets a waveform data packet.
+ * \param packetIndex Wave packet descriptor index of the point.
+ * \param dataOffset Byte offset to waveform data of the point, relative to the header of the waveform data packet record.
+ * \param packetSize Waveform packet size in bytes.
+ * \param packet Returns the view of the packet.
+ * \return True, if the packet index has a descriptor and the packet is stored within waveform data.
+ */
+bool LasWaveformReader::getPacket(quint8 packetIndex, quint64 dataOffset, quint32 packetSize, LasWaveformPacket &packet)
+{
+    packet = LasWaveformPacket();
+    if (this->mappedData == nullptr || !this->hasDescriptor[packetIndex]) return false;
+    if (quint64(this->mappedLength) < dataOffset || quint64(this->mappedLength) - dataOffset < packetSize) return false;
+
+    packet.data = this->mappedData + dataOffset;
+    packet.size = packetSize;
+    packet.descriptor = &this->descriptors[packetIndex];
+    return true;
+}
+
+
+/*!
+ * \brief Gets the waveform data packet of a point.
+ * \param lasPoint Point of format 4, 5, 9 or 10.
+ * \param packet Returns the view of the packet.
+ * \return True, if the point has a waveform and the packet is stored within waveform data.
+ */
+bool LasWaveformReader::getPacket(LasPoint &lasPoint, LasWaveformPacket &packet)
+{
+    return getPacket(lasPoint.waveformPacketIndex, lasPoint.waveformDataOffset, lasPoint.waveformPacketSize, packet);
+}
+
+
+/*!
+ * \brief Returns the descriptor of a packet index.
+ * \param packetIndex Wave packet descriptor index.
+ * \return Descriptor, nullptr if the las-file does not define the index.
+ */
+const LasVLRPointWaveformPacketDescriptor *LasWaveformReader::getDescriptor(quint8 packetIndex)
+{
+    return (this->hasDescriptor[packetIndex] ? &this->descriptors[packetIndex] : nullptr);
+}
+
+
+/*!
+ * \brief Returns the name of the external waveform data file of a las-file.
+ * \param lasFileName Las-file name.
+ * \return File name with the extension replaced by LAS_WAVEFORM_FILE_EXTENSION.
+ */
+QString LasWaveformReader::waveformFileName(QString lasFileName)
+{
+    QFileInfo info(lasFileName);
+
+    return info.path() + "/" + info.completeBaseName() + LAS_WAVEFORM_FILE_EXTENSION;
+}
+
+
+/*!
+ * \brief Reads waveform packet descriptor VLRs.
+ * \param las Open las-file.
+ * \return True, if all descriptors were read successfully.
+ * \remark Descriptors are found by the VLR directory, packet indices without a descriptor VLR are not valid.
+ * \remark Descriptors with bits per sample out of LAS_WAVEFORM_MIN_BITS_PER_SAMPLE and LAS_WAVEFORM_MAX_BITS_PER_SAMPLE are ignored.
+ */
+bool LasWaveformReader::readDescriptors(LasFile &las)
+{
+    bool error = false;
+    qint64 iVLR;
+    LasVLR vlr;
+
+    for (int i = 1; i < LAS_WAVEFORM_NUMBER_OF_DESCRIPTORS && !error; i++)
+    {
+        iVLR = las.findVLR(LAS_WAVEFORM_DESCRIPTOR_USERID, quint16(LAS_WAVEFORM_DESCRIPTOR_RECORDID + i));
+        if (iVLR < 0) continue;
+        error = !las.readVLR(iVLR, vlr);
+        if (!error && sizeof(LasVLRPointWaveformPacketDescriptor) <= vlr.header.recordLength)
+        {
+            memcpy(&this->descriptors[i], vlr.data, sizeof(LasVLRPointWaveformPacketDescriptor));
+            this->hasDescriptor[i] = (LAS_WAVEFORM_MIN_BITS_PER_SAMPLE <= this->descriptors[i].bitsPerSample && this->descriptors[i].bitsPerSample <= LAS_WAVEFORM_MAX_BITS_PER_SAMPLE);
+        }
+    }
+
+    return !error;
+}
+
+
+/*!
+ * \brief Opens a file read-only and maps the waveform data packet record.
+ * \param fileName File name.
+ * \param offset Offset of the record header.
+ * \param length Size of the record including the header.
+ * \return True, if the record was mapped successfully.
+ */
+bool LasWaveformReader::mapRecord(QString fileName, qint64 offset, qint64 length)
+{
+    this->waveformFile.setFileName(fileName);
+    if (!this->waveformFile.open(QFile::ReadOnly)) return false;
+    if (offset < 0 || length < qint64(sizeof(LasEVLRHeader)) || this->waveformFile.size() - offset < length) return false;
+
+    this->mappedData = this->waveformFile.map(offset, length);
+    if (this->mappedData == nullptr) return false;
+
+    this->mappedLength = length;
+    return true;
+}
@@ -0,0 +1,84 @@
+#ifndef LASWAVEFORMREADER_H
+#define LASWAVEFORMREADER_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laswaveformreader.h
+ *
+ * \brief Reader of waveform data packets of point formats 4, 5, 9 and 10.
+ * \remark Waveform data packets are stored in the waveform EVLR of the las-file or in the external .wdp file,
+ *         packets are returned as views of the memory-mapped data.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QFile>
+#include "g3dtlas_global.h"
+#include "lasfile.h"
+
+#define LAS_WAVEFORM_FILE_EXTENSION ".wdp"                  //!< extension of the external waveform data file
+#define LAS_WAVEFORM_DESCRIPTOR_USERID "LASF_Spec"          //!< user ID of waveform packet descriptor VLRs
+#define LAS_WAVEFORM_DESCRIPTOR_RECORDID (99)               //!< record ID of the descriptor of packet index i is 99 + i
+#define LAS_WAVEFORM_NUMBER_OF_DESCRIPTORS (256)            //!< packet indices 1-255, 0 means the point has no waveform
+#define LAS_GLOBAL_ENCODING_WAVEFORM_INTERNAL (0x0002)      //!< bit of the global encoding, waveform data packets are stored in the las-file
+#define LAS_GLOBAL_ENCODING_WAVEFORM_EXTERNAL (0x0004)      //!< bit of the global encoding, waveform data packets are stored in the .wdp file
+#define LAS_WAVEFORM_MIN_BITS_PER_SAMPLE (2)                //!< smallest valid sample size of a descriptor
+#define LAS_WAVEFORM_MAX_BITS_PER_SAMPLE (32)               //!< largest valid sample size of a descriptor, samples are returned as quint32
+
+
+/*!
+ * \brief View of a waveform data packet in the mapped memory.
+ * \remark The view is valid while the reader is open.
+ */
+struct LasWaveformPacket
+{
+    const uchar *data = nullptr;                                        //!< raw samples
+    quint32 size = 0;                                                   //!< size of the packet in bytes
+    const LasVLRPointWaveformPacketDescriptor *descriptor = nullptr;    //!< bits per sample, number of samples, gain and offset
+
+    quint32 getNumberOfSamples() const;
+    quint32 getSample(quint32 iSample) const;
+    double getVolts(quint32 iSample) const;
+};
+
+
+/*!
+ * \brief The LasWaveformReader class.
+ * Zero-copy access to waveform data packets of a las-file.
+ * \remark Packets are read without system calls, getPacket is thread-safe.
+ */
+class G3DTLAS_EXPORT LasWaveformReader
+{
+protected:
+    QFile waveformFile;                     //!< las-file, spill file of its EVLRs or external waveform file, open read-only
+    const uchar *mappedData = nullptr;      //!< mapped waveform data packet record, starting with its header
+    qint64 mappedLength = 0;                //!< size of the mapped record
+    LasVLRPointWaveformPacketDescriptor descriptors[LAS_WAVEFORM_NUMBER_OF_DESCRIPTORS]; //!< descriptors of packet indices
+    bool hasDescriptor[LAS_WAVEFORM_NUMBER_OF_DESCRIPTORS];                               //!< true, if the descriptor of a packet index was read
+
+public:
+    LasWaveformReader();
+    ~LasWaveformReader();
+
+    bool open(LasFile &las, QString externalFileName = "");
+    void close();
+    bool isOpen();
+
+    bool getPacket(quint8 packetIndex, quint64 dataOffset, quint32 packetSize, LasWaveformPacket &packet);
+    bool getPacket(LasPoint &lasPoint, LasWaveformPacket &packet);
+    const LasVLRPointWaveformPacketDescriptor *getDescriptor(quint8 packetIndex);
+
+    static QString waveformFileName(QString lasFileName);
+
+protected:
+    bool readDescriptors(LasFile &las);
+    bool mapRecord(QString fileName, qint64 offset, qint64 length);
+};
+
+#endif // LASWAVEFORMREADER_H
@@ -0,0 +1,194 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laswritebehind.cpp
+ *
+ * \brief The implementation of the LasWriteBehind class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "laswritebehind.h"
+
+
+/*!
+ * \brief Default constructor.
+ */
+LasWriteBehind::LasWriteBehind()
+{
+    for (int i = 0; i < LAS_WRITE_BEHIND_RING_SIZE; i++)
+    {
+        this->freeBuffers[i] = nullptr;
+        this->queuedBuffers[i] = nullptr;
+        this->queuedFileOffset[i] = 0;
+        this->queuedLength[i] = 0;
+    }
+}
+
+
+/*!
+ * \brief Destructor. Writes queued buffers, stops the thread and releases buffers.
+ */
+LasWriteBehind::~LasWriteBehind()
+{
+    end();
+}
+
+
+/*!
+ * \brief Opens the las-file for writing and starts the thread.
+ * \param fileName Las-file name, the file must exist.
+ * \param length Length of buffers in bytes, must be equal to the length of the point cache.
+ * \return True, if the file was open and the thread started.
+ */
+bool LasWriteBehind::begin(QString fileName, qint64 length)
+{
+    end();
+    if (length <= 0) return false;
+
+    this->dataFile.setFileName(fileName);
+    if (!this->dataFile.open(QFile::ReadWrite | QFile::Unbuffered)) return false;
+
+    this->bufferLength = length;
+    for (int i = 0; i < LAS_WRITE_BEHIND_NUMBER_OF_BUFFERS; i++)
+        this->freeBuffers[i] = new char[quint64(length)];
+    this->numberOfFreeBuffers = LAS_WRITE_BEHIND_NUMBER_OF_BUFFERS;
+    this->firstQueued = 0;
+    this->numberOfQueued = 0;
+    this->writeError = false;
+    this->stopRequested = false;
+
+    start();
+    return true;
+}
+
+
+/*!
+ * \brief Writes queued buffers, stops the thread, closes the file and releases buffers.
+ * \return True, if all buffers were written successfully.
+ */
+bool LasWriteBehind::end()
+{
+    bool error;
+
+    error = !flush();
+
+    this->mutex.lock();
+    this->stopRequested = true;
+    this->bufferQueued.wakeAll();
+    this->mutex.unlock();
+    wait();
+
+    for (int i = 0; i < this->numberOfFreeBuffers; i++)
+    {
+        delete [] this->freeBuffers[i];
+        this->freeBuffers[i] = nullptr;
+    }
+    this->numberOfFreeBuffers = 0;
+    if (this->dataFile.isOpen()) this->dataFile.close();
+
+    return !error;
+}
+
+
+/*!
+ * \brief Queues a buffer for writing and takes a free buffer.
+ * \param fileOffset Offset in the file, where the buffer will be written.
+ * \param buffer Input: buffer to write, output: free buffer of the same length.
+ * \param length Number of bytes to write.
+ * \return True, if the buffer was queued and no previous write failed.
+ * \remark The producer waits only if all pool buffers are queued.
+ */
+bool LasWriteBehind::submit(qint64 fileOffset, char *&buffer, qint64 length)
+{
+    int iQueued;
+    bool error = true;
+
+    if (buffer == nullptr || length < 0 || this->bufferLength < length) return false;
+
+    this->mutex.lock();
+    if (!this->writeError && this->isRunning())
+    {
+        iQueued = (this->firstQueued + this->numberOfQueued) % LAS_WRITE_BEHIND_RING_SIZE;
+        this->queuedBuffers[iQueued] = buffer;
+        this->queuedFileOffset[iQueued] = fileOffset;
+        this->queuedLength[iQueued] = length;
+        this->numberOfQueued++;
+        this->bufferQueued.wakeAll();
+
+        while (this->numberOfFreeBuffers == 0)
+            this->bufferWritten.wait(&this->mutex);
+        this->numberOfFreeBuffers--;
+        buffer = this->freeBuffers[this->numberOfFreeBuffers];
+        this->freeBuffers[this->numberOfFreeBuffers] = nullptr;
+        error = this->writeError;
+    }
+    this->mutex.unlock();
+
+    return !error;
+}
+
+
+/*!
+ * \brief Waits until all queued buffers are written.
+ * \return True, if all buffers were written successfully.
+ */
+bool LasWriteBehind::flush()
+{
+    bool error;
+
+    this->mutex.lock();
+    while (0 < this->numberOfQueued && this->isRunning())
+        this->bufferWritten.wait(&this->mutex);
+    error = this->writeError;
+    this->mutex.unlock();
+
+    return !error;
+}
+
+
+/*!
+ * \brief Thread function, writes queued buffers and returns them to the pool.
+ * \remark After a write error the following buffers are not written.
+ */
+void LasWriteBehind::run()
+{
+    char *buffer;
+    qint64 fileOffset, length;
+    bool error;
+
+    this->mutex.lock();
+    while (!this->stopRequested || 0 < this->numberOfQueued)
+    {
+        if (this->numberOfQueued == 0)
+        {
+            this->bufferQueued.wait(&this->mutex);
+            continue;
+        }
+
+        // the queued buffer is not accessed by the producer, write it unlocked
+        buffer = this->queuedBuffers[this->firstQueued];
+        fileOffset = this->queuedFileOffset[this->firstQueued];
+        length = this->queuedLength[this->firstQueued];
+        error = this->writeError;
+        this->mutex.unlock();
+
+        if (!error) error = !this->dataFile.seek(fileOffset);
+        if (!error) error = (this->dataFile.write(buffer, length) != length);
+
+        this->mutex.lock();
+        this->writeError = error;
+        this->queuedBuffers[this->firstQueued] = nullptr;
+        this->firstQueued = (this->firstQueued + 1) % LAS_WRITE_BEHIND_RING_SIZE;
+        this->numberOfQueued--;
+        this->freeBuffers[this->numberOfFreeBuffers] = buffer;
+        this->numberOfFreeBuffers++;
+        this->bufferWritten.wakeAll();
+    }
+    this->mutex.unlock();
+}
@@ -0,0 +1,70 @@
+#ifndef LASWRITEBEHIND_H
+#define LASWRITEBEHIND_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laswritebehind.h
+ *
+ * \brief Background writer of point cache windows.
+ * \remark Full point caches are handed over to a worker thread
+ *         and the producer continues with a free buffer from a pool.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include "g3dtlas_global.h"
+
+#define LAS_WRITE_BEHIND_NUMBER_OF_BUFFERS (2) //!< number of pool buffers, the point cache is the additional buffer
+#define LAS_WRITE_BEHIND_RING_SIZE (LAS_WRITE_BEHIND_NUMBER_OF_BUFFERS + 1)
+
+
+/*!
+ * \brief The LasWriteBehind class.
+ * Writes buffers of point records in a background thread.
+ * \remark The thread uses its own file handle, the caller must call flush before accessing written records.
+ */
+class G3DTLAS_EXPORT LasWriteBehind : public QThread
+{
+protected:
+    QFile dataFile;                     //!< own handle of the las-file
+    qint64 bufferLength = 0;            //!< length of every buffer in bytes
+
+    QMutex mutex;                       //!< guards queues of buffers
+    QWaitCondition bufferQueued;        //!< signalled by the producer when a buffer was queued or the thread should stop
+    QWaitCondition bufferWritten;       //!< signalled by the thread when a buffer was written
+
+    char *freeBuffers[LAS_WRITE_BEHIND_RING_SIZE];         //!< buffers available to the producer
+    int numberOfFreeBuffers = 0;                            //!< number of free buffers
+    char *queuedBuffers[LAS_WRITE_BEHIND_RING_SIZE];       //!< ring of buffers waiting for writing
+    qint64 queuedFileOffset[LAS_WRITE_BEHIND_RING_SIZE];   //!< file offsets of queued buffers
+    qint64 queuedLength[LAS_WRITE_BEHIND_RING_SIZE];       //!< number of bytes to write from queued buffers
+    int firstQueued = 0;                //!< index of the oldest queued buffer
+    int numberOfQueued = 0;             //!< number of queued buffers, including the buffer being written
+    bool writeError = false;            //!< write error flag
+    bool stopRequested = false;         //!< thread termination flag
+
+public:
+    LasWriteBehind();
+    ~LasWriteBehind();
+
+    bool begin(QString fileName, qint64 length);
+    bool end();
+
+    bool submit(qint64 fileOffset, char *&buffer, qint64 length);
+    bool flush();
+
+protected:
+    void run();
+};
+
+#endif // LASWRITEBEHIND_H
@@ -0,0 +1,37 @@
+#ifndef LASFILESTAMP_H
+#define LASFILESTAMP_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasfilestamp.h
+ *
+ * \brief Stamp of a las-file stored in sidecar files.
+ * \remark A sidecar file describes the las-file only if the stamp of the las-file is equal to the stored stamp.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+
+#pragma pack(1)
+
+/*!
+ * \brief Stamp of a las-file.
+ * \remark size = 24
+ */
+struct LasFileStamp
+{
+    qint64 lasFileSize;             //!< size of the las-file
+    qint64 lasFileModified;         //!< last modification time of the las-file, milliseconds since epoch
+    quint64 headerChecksum;         //!< FNV-1a hash of the file header stored in the las-file
+};
+
+#pragma pack()
+
+#endif // LASFILESTAMP_H
@@ -0,0 +1,35 @@
+#ifndef LASPOINTINTERVAL_H
+#define LASPOINTINTERVAL_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laspointinterval.h
+ *
+ * \brief Interval of consecutive point records.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+
+#pragma pack(1)
+
+/*!
+ * \brief Interval of consecutive point records.
+ * \remark size = 16
+ */
+struct LasPointInterval
+{
+    qint64 firstPoint;          //!< index of the first point
+    qint64 lastPoint;           //!< index of the last point (inclusive)
+};
+
+#pragma pack()
+
+#endif // LASPOINTINTERVAL_H
@@ -0,0 +1,93 @@
+#ifndef LASSPACEFILLINGCURVE_H
+#define LASSPACEFILLINGCURVE_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasspacefillingcurve.h
+ *
+ * \brief Keys of 2D space filling curves.
+ * \remark Keys are computed from unsigned 32-bit grid coordinates.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+
+
+/*!
+ * \brief Space filling curves.
+ */
+enum LasSpaceFillingCurve
+{
+    LAS_CURVE_MORTON = 0,   //!< Z-order curve
+    LAS_CURVE_HILBERT = 1   //!< Hilbert curve
+};
+
+
+/*!
+ * \brief Spreads bits of a 32-bit value to even bits of a 64-bit value.
+ * \param v Value.
+ * \return Value with zero bits inserted.
+ */
+inline quint64 lasSpreadBits(quint32 v)
+{
+    quint64 x = v;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+}
+
+
+/*!
+ * \brief Returns the position of a cell on the Morton curve.
+ * \param x Column.
+ * \param y Row.
+ * \return Key with interleaved bits of y and x.
+ */
+inline quint64 lasMortonKey(quint32 x, quint32 y)
+{
+    return lasSpreadBits(x) | (lasSpreadBits(y) << 1);
+}
+
+
+/*!
+ * \brief Returns the position of a cell on the Hilbert curve of order 32.
+ * \param x Column.
+ * \param y Row.
+ * \return Distance from the beginning of the curve.
+ */
+inline quint64 lasHilbertKey(quint32 x, quint32 y)
+{
+    quint64 d = 0;
+    quint32 rx, ry, t;
+
+    for (quint32 s = 0x80000000u; 0 < s; s >>= 1)
+    {
+        rx = (x & s) ? 1 : 0;
+        ry = (y & s) ? 1 : 0;
+        d += quint64(s) * quint64(s) * quint64((3 * rx) ^ ry);
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = ~x;
+                y = ~y;
+            }
+            t = x;
+            x = y;
+            y = t;
+        }
+    }
+    return d;
+}
+
+#endif // LASSPACEFILLINGCURVE_H
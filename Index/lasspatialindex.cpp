@@ -0,0 +1,479 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasspatialindex.cpp
+ *
+ * \brief The implementation of the LasSpatialIndex class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "lasspatialindex.h"
+#include "lasfile.h"
+
+
+/*!
+ * \brief Constructor.
+ */
+LasSpatialIndex::LasSpatialIndex()
+{
+    memset(&this->header, 0, sizeof(LasSpatialIndexHeader));
+}
+
+
+/*!
+ * \brief Destructor.
+ */
+LasSpatialIndex::~LasSpatialIndex()
+{
+    this->destroy();
+}
+
+
+/*!
+ * \brief Releases the index and closes the index file.
+ */
+void LasSpatialIndex::destroy()
+{
+    if (this->indexFile.isOpen()) this->indexFile.close();
+    if (this->cellOffsets) delete[] this->cellOffsets;
+    if (this->intervals) delete[] this->intervals;
+    this->cellOffsets = nullptr;
+    this->intervals = nullptr;
+    memset(&this->header, 0, sizeof(LasSpatialIndexHeader));
+}
+
+
+/*!
+ * \brief Checks if the index was built or read.
+ * \return True, if the index can be queried.
+ */
+bool LasSpatialIndex::isValid()
+{
+    return this->cellOffsets != nullptr && (this->intervals != nullptr || this->indexFile.isOpen());
+}
+
+
+/*!
+ * \brief Returns the number of grid columns.
+ * \return Number of columns.
+ */
+quint32 LasSpatialIndex::getNumberOfColumns()
+{
+    return this->header.nCols;
+}
+
+
+/*!
+ * \brief Returns the number of grid rows.
+ * \return Number of rows.
+ */
+quint32 LasSpatialIndex::getNumberOfRows()
+{
+    return this->header.nRows;
+}
+
+
+/*!
+ * \brief Returns the number of point intervals stored in the index.
+ * \return Number of intervals.
+ */
+quint64 LasSpatialIndex::getNumberOfIntervals()
+{
+    return this->header.numberOfIntervals;
+}
+
+
+/*!
+ * \brief Builds the index of a las-file in one pass over the point records.
+ * \param las Opened las-file.
+ * \param pointsPerCell Average number of points in a grid cell.
+ * \return True, if the index was built successfully.
+ * \remark Points outside the extent given in the las-file header are assigned to the boundary cells.
+ *         Intervals of a cell bridge up to LAS_SPATIAL_INDEX_MAX_GAP points lying in other cells.
+ */
+bool LasSpatialIndex::build(LasFile &las, qint64 pointsPerCell)
+{
+    qint64 *openFirst, *openLast;
+    quint32 *runCells;
+    LasPointInterval *runIntervals;
+    qint64 nRuns = 0, runCapacity = 1024;
+    quint64 nCells, i, *cellCursor;
+    bool error = false;
+
+    this->destroy();
+    if (!las.isOpen()) return false;
+    this->setupGrid(las, pointsPerCell);
+    nCells = quint64(this->header.nCols) * this->header.nRows;
+
+    openFirst = new qint64[nCells];
+    openLast = new qint64[nCells];
+    for (i = 0; i < nCells; i++) openLast[i] = -1;
+    runCells = new quint32[runCapacity];
+    runIntervals = new LasPointInterval[runCapacity];
+
+    auto appendRun = [&](quint32 cell)
+    {
+        if (nRuns >= runCapacity)
+        {
+            quint32 *cells = new quint32[2 * runCapacity];
+            LasPointInterval *intervals = new LasPointInterval[2 * runCapacity];
+            memcpy(cells, runCells, size_t(nRuns) * sizeof(quint32));
+            memcpy(intervals, runIntervals, size_t(nRuns) * sizeof(LasPointInterval));
+            delete[] runCells;
+            delete[] runIntervals;
+            runCells = cells;
+            runIntervals = intervals;
+            runCapacity *= 2;
+        }
+        runCells[nRuns] = cell;
+        runIntervals[nRuns].firstPoint = openFirst[cell];
+        runIntervals[nRuns].lastPoint = openLast[cell];
+        nRuns++;
+    };
+
+    error = !las.forEachPoint(0, qint64(this->header.numberOfPoints), [&](qint64 iPoint, LasPoint &lasPoint)
+    {
+        quint32 cell = quint32(this->cellRow(lasPoint.iy) * this->header.nCols + this->cellColumn(lasPoint.ix));
+        if (0 <= openLast[cell] && iPoint - openLast[cell] <= LAS_SPATIAL_INDEX_MAX_GAP + 1)
+            openLast[cell] = iPoint;
+        else
+        {
+            if (0 <= openLast[cell]) appendRun(cell);
+            openFirst[cell] = openLast[cell] = iPoint;
+        }
+        return true;
+    }, LAS_FIELD_XYZ);
+
+    if (!error)
+    {
+        for (i = 0; i < nCells; i++)
+            if (0 <= openLast[i]) appendRun(quint32(i));
+
+        this->cellOffsets = new quint64[nCells + 1];
+        memset(this->cellOffsets, 0, size_t(nCells + 1) * sizeof(quint64));
+        for (qint64 j = 0; j < nRuns; j++) this->cellOffsets[runCells[j] + 1]++;
+        for (i = 0; i < nCells; i++) this->cellOffsets[i + 1] += this->cellOffsets[i];
+
+        cellCursor = new quint64[nCells];
+        memcpy(cellCursor, this->cellOffsets, size_t(nCells) * sizeof(quint64));
+        this->intervals = new LasPointInterval[nRuns > 0 ? nRuns : 1];
+        for (qint64 j = 0; j < nRuns; j++)
+            this->intervals[cellCursor[runCells[j]]++] = runIntervals[j];
+        delete[] cellCursor;
+        this->header.numberOfIntervals = quint64(nRuns);
+    }
+
+    delete[] openFirst;
+    delete[] openLast;
+    delete[] runCells;
+    delete[] runIntervals;
+
+    if (error) this->destroy();
+    return !error;
+}
+
+
+/*!
+ * \brief Writes the index to a sidecar file.
+ * \param fileName Name of the index file.
+ * \return True, if the index was written successfully.
+ * \remark Only a built index can be written.
+ */
+bool LasSpatialIndex::write(QString fileName)
+{
+    QFile file(fileName);
+    qint64 nCells, nBytes;
+    bool error = false;
+
+    if (!this->cellOffsets || !this->intervals) return false;
+    nCells = qint64(this->header.nCols) * this->header.nRows;
+
+    if (file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        error = file.write((char *)&this->header, sizeof(LasSpatialIndexHeader)) != sizeof(LasSpatialIndexHeader);
+        if (!error)
+        {
+            nBytes = (nCells + 1) * qint64(sizeof(quint64));
+            error = file.write((char *)this->cellOffsets, nBytes) != nBytes;
+        }
+        if (!error)
+        {
+            nBytes = qint64(this->header.numberOfIntervals) * qint64(sizeof(LasPointInterval));
+            error = file.write((char *)this->intervals, nBytes) != nBytes;
+        }
+        file.close();
+        if (error) QFile::remove(fileName);
+    }
+    else error = true;
+
+    return !error;
+}
+
+
+/*!
+ * \brief Reads the index from a sidecar file.
+ * \param fileName Name of the index file.
+ * \return True, if the index was read successfully.
+ * \remark Only the grid is loaded, intervals are read on demand, the index file stays open.
+ */
+bool LasSpatialIndex::read(QString fileName)
+{
+    qint64 nCells, nBytes;
+    bool error = false;
+
+    this->destroy();
+    this->indexFile.setFileName(fileName);
+    if (!this->indexFile.open(QFile::ReadOnly)) return false;
+
+    error = this->indexFile.read((char *)&this->header, sizeof(LasSpatialIndexHeader)) != sizeof(LasSpatialIndexHeader);
+    if (!error) error = memcmp(this->header.signature, "LSXI", LAS_SPATIAL_INDEX_SIGNATURE_LENGTH) != 0;
+    if (!error) error = this->header.version != LAS_SPATIAL_INDEX_VERSION;
+    if (!error) error = this->header.nCols == 0 || this->header.nRows == 0 || this->header.cellSize <= 0;
+    if (!error)
+    {
+        nCells = qint64(this->header.nCols) * this->header.nRows;
+        error = LAS_SPATIAL_INDEX_MAX_CELLS < nCells;
+    }
+    if (!error)
+    {
+        nBytes = qint64(sizeof(LasSpatialIndexHeader)) + (nCells + 1) * qint64(sizeof(quint64))
+                + qint64(this->header.numberOfIntervals) * qint64(sizeof(LasPointInterval));
+        error = this->indexFile.size() != nBytes;
+    }
+    if (!error)
+    {
+        nBytes = (nCells + 1) * qint64(sizeof(quint64));
+        this->cellOffsets = new quint64[nCells + 1];
+        error = this->indexFile.read((char *)this->cellOffsets, nBytes) != nBytes;
+        if (!error) error = this->cellOffsets[nCells] != this->header.numberOfIntervals;
+    }
+
+    if (error) this->destroy();
+    return !error;
+}
+
+
+/*!
+ * \brief Opens the index of a las-file.
+ * \param las Opened las-file.
+ * \param buildMissing Builds the index, if the sidecar file is missing or outdated.
+ * \return True, if the index is ready for queries.
+ * \remark A newly built index is written to the sidecar file,
+ *         the index is usable even if the sidecar file cannot be written.
+ */
+bool LasSpatialIndex::open(LasFile &las, bool buildMissing)
+{
+    QString fileName = indexFileName(las.getFileName());
+
+    if (QFile::exists(fileName) && this->read(fileName) && this->isCompatible(las)) return true;
+    this->destroy();
+    if (!buildMissing) return false;
+
+    if (!this->build(las)) return false;
+    this->write(fileName);
+    return true;
+}
+
+
+/*!
+ * \brief Checks if the index corresponds to a las-file.
+ * \param las Opened las-file.
+ * \return True, if the index was built for the las-file.
+ * \remark The las-file must not be changed after the index was built, its size, modification time and header are compared.
+ */
+bool LasSpatialIndex::isCompatible(LasFile &las)
+{
+    LasFileStamp stamp;
+
+    return las.getFileStamp(stamp)
+            && this->header.numberOfPoints == las.getNumberOfPoints()
+            && this->header.pointRecordLength == las.getPointRecordLength()
+            && this->header.pointFormat == las.getPointFormat()
+            && this->header.scaleX == las.getScaleX()
+            && this->header.scaleY == las.getScaleY()
+            && this->header.offsetX == las.getOffsetX()
+            && this->header.offsetY == las.getOffsetY()
+            && memcmp(&this->header.lasFileStamp, &stamp, sizeof(LasFileStamp)) == 0;
+}
+
+
+/*!
+ * \brief Finds point intervals inside a box.
+ * \param x0 Minimal x-coordinate of the box.
+ * \param y0 Minimal y-coordinate of the box.
+ * \param x1 Maximal x-coordinate of the box.
+ * \param y1 Maximal y-coordinate of the box.
+ * \param pointIntervals Sorted disjoint intervals of points, which may lie inside the box.
+ * \return True, if the query was successful.
+ * \remark Reading of intervals from the index file is not thread safe.
+ */
+bool LasSpatialIndex::queryBox(double x0, double y0, double x1, double y1, QVector<LasPointInterval> &pointIntervals)
+{
+    qint64 c0, r0, c1, r1, r, n;
+    bool error = false;
+
+    pointIntervals.clear();
+    if (!this->isValid()) return false;
+    if (x1 < x0 || y1 < y0) return true;
+
+    c0 = this->cellColumn(floor((x0 - this->header.offsetX) / this->header.scaleX) - 1.0);
+    c1 = this->cellColumn(ceil((x1 - this->header.offsetX) / this->header.scaleX) + 1.0);
+    r0 = this->cellRow(floor((y0 - this->header.offsetY) / this->header.scaleY) - 1.0);
+    r1 = this->cellRow(ceil((y1 - this->header.offsetY) / this->header.scaleY) + 1.0);
+
+    for (r = r0; r <= r1 && !error; r++)
+        error = !this->readCellIntervals(quint64(r * this->header.nCols + c0), quint64(r * this->header.nCols + c1), pointIntervals);
+
+    if (!error && 1 < pointIntervals.size())
+    {
+        std::sort(pointIntervals.begin(), pointIntervals.end(), [](const LasPointInterval &a, const LasPointInterval &b)
+        {
+            return a.firstPoint < b.firstPoint;
+        });
+        n = 0;
+        for (int i = 1; i < pointIntervals.size(); i++)
+        {
+            if (pointIntervals[i].firstPoint <= pointIntervals[int(n)].lastPoint + 1)
+            {
+                if (pointIntervals[int(n)].lastPoint < pointIntervals[i].lastPoint)
+                    pointIntervals[int(n)].lastPoint = pointIntervals[i].lastPoint;
+            }
+            else pointIntervals[int(++n)] = pointIntervals[i];
+        }
+        pointIntervals.resize(int(n + 1));
+    }
+
+    if (error) pointIntervals.clear();
+    return !error;
+}
+
+
+/*!
+ * \brief Returns the name of the index file of a las-file.
+ * \param lasFileName Name of the las-file.
+ * \return Name of the index file.
+ */
+QString LasSpatialIndex::indexFileName(QString lasFileName)
+{
+    return lasFileName + LAS_SPATIAL_INDEX_FILE_EXTENSION;
+}
+
+
+/*!
+ * \brief Sets up the grid from the header of a las-file.
+ * \param las Opened las-file.
+ * \param pointsPerCell Average number of points in a grid cell.
+ * \remark Cells are squares in scaled coordinates, the number of cells is limited by LAS_SPATIAL_INDEX_MAX_CELLS.
+ */
+void LasSpatialIndex::setupGrid(LasFile &las, qint64 pointsPerCell)
+{
+    double gx0, gy0, gx1, gy1;
+    qint64 width, height, nCells, cellSize;
+
+    memcpy(this->header.signature, "LSXI", LAS_SPATIAL_INDEX_SIGNATURE_LENGTH);
+    this->header.version = LAS_SPATIAL_INDEX_VERSION;
+    las.getFileStamp(this->header.lasFileStamp);
+    this->header.numberOfPoints = las.getNumberOfPoints();
+    this->header.pointRecordLength = las.getPointRecordLength();
+    this->header.pointFormat = las.getPointFormat();
+    this->header.scaleX = las.getScaleX();
+    this->header.scaleY = las.getScaleY();
+    this->header.offsetX = las.getOffsetX();
+    this->header.offsetY = las.getOffsetY();
+
+    gx0 = floor((las.getX0() - this->header.offsetX) / this->header.scaleX);
+    gy0 = floor((las.getY0() - this->header.offsetY) / this->header.scaleY);
+    gx1 = ceil((las.getX1() - this->header.offsetX) / this->header.scaleX);
+    gy1 = ceil((las.getY1() - this->header.offsetY) / this->header.scaleY);
+    if (!(gx0 <= gx1 && gy0 <= gy1 && -2147483648.0 <= gx0 && gx1 <= 2147483647.0 && -2147483648.0 <= gy0 && gy1 <= 2147483647.0))
+        gx0 = gy0 = gx1 = gy1 = 0.0;
+
+    width = qint64(gx1 - gx0) + 1;
+    height = qint64(gy1 - gy0) + 1;
+    if (pointsPerCell < 1) pointsPerCell = 1;
+    nCells = qint64(this->header.numberOfPoints) / pointsPerCell;
+    if (nCells < 1) nCells = 1;
+    if (LAS_SPATIAL_INDEX_MAX_CELLS < nCells) nCells = LAS_SPATIAL_INDEX_MAX_CELLS;
+
+    cellSize = qint64(ceil(sqrt(double(width) * double(height) / double(nCells))));
+    if (cellSize < 1) cellSize = 1;
+    while (LAS_SPATIAL_INDEX_MAX_CELLS < ((width + cellSize - 1) / cellSize) * ((height + cellSize - 1) / cellSize))
+        cellSize *= 2;
+
+    this->header.gridX0 = qint64(gx0);
+    this->header.gridY0 = qint64(gy0);
+    this->header.cellSize = cellSize;
+    this->header.nCols = quint32((width + cellSize - 1) / cellSize);
+    this->header.nRows = quint32((height + cellSize - 1) / cellSize);
+    this->header.numberOfIntervals = 0;
+}
+
+
+/*!
+ * \brief Returns the grid column of a scaled x-coordinate.
+ * \param ix Scaled x-coordinate.
+ * \return Column clamped to the grid.
+ */
+inline qint64 LasSpatialIndex::cellColumn(double ix)
+{
+    double c = floor((ix - double(this->header.gridX0)) / double(this->header.cellSize));
+    if (c < 0.0) return 0;
+    if (double(this->header.nCols) <= c) return qint64(this->header.nCols) - 1;
+    return qint64(c);
+}
+
+
+/*!
+ * \brief Returns the grid row of a scaled y-coordinate.
+ * \param iy Scaled y-coordinate.
+ * \return Row clamped to the grid.
+ */
+inline qint64 LasSpatialIndex::cellRow(double iy)
+{
+    double r = floor((iy - double(this->header.gridY0)) / double(this->header.cellSize));
+    if (r < 0.0) return 0;
+    if (double(this->header.nRows) <= r) return qint64(this->header.nRows) - 1;
+    return qint64(r);
+}
+
+
+/*!
+ * \brief Appends intervals of consecutive cells.
+ * \param firstCell Index of the first cell.
+ * \param lastCell Index of the last cell.
+ * \param pointIntervals Intervals are appended to this vector.
+ * \return True, if the intervals were read successfully.
+ */
+bool LasSpatialIndex::readCellIntervals(quint64 firstCell, quint64 lastCell, QVector<LasPointInterval> &pointIntervals)
+{
+    quint64 first = this->cellOffsets[firstCell];
+    qint64 n = qint64(this->cellOffsets[lastCell + 1] - first), nBytes, position;
+    int size = pointIntervals.size();
+    bool error = false;
+
+    if (n <= 0) return true;
+    pointIntervals.resize(size + int(n));
+
+    if (this->intervals)
+        memcpy(pointIntervals.data() + size, this->intervals + first, size_t(n) * sizeof(LasPointInterval));
+    else
+    {
+        nBytes = n * qint64(sizeof(LasPointInterval));
+        position = qint64(sizeof(LasSpatialIndexHeader))
+                + (qint64(this->header.nCols) * this->header.nRows + 1) * qint64(sizeof(quint64))
+                + qint64(first) * qint64(sizeof(LasPointInterval));
+        error = !this->indexFile.seek(position);
+        if (!error) error = this->indexFile.read((char *)(pointIntervals.data() + size), nBytes) != nBytes;
+    }
+
+    return !error;
+}
@@ -0,0 +1,78 @@
+#ifndef LASSPATIALINDEX_H
+#define LASSPATIALINDEX_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasspatialindex.h
+ *
+ * \brief Persistent spatial index of a las-file.
+ * \remark The index is a regular grid over the XY extent of the file.
+ *         Every cell holds sorted intervals of point records
+ *         with points inside the cell.
+ *         The index is stored in a sidecar file next to the las-file.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QFile>
+#include <QVector>
+#include "g3dtlas_global.h"
+#include "Index/laspointinterval.h"
+#include "Index/lasspatialindexheader.h"
+
+#define LAS_SPATIAL_INDEX_FILE_EXTENSION ".lsx"     //!< extension appended to the las-file name
+#define LAS_SPATIAL_INDEX_POINTS_PER_CELL (65536)   //!< default average number of points in a cell
+#define LAS_SPATIAL_INDEX_MAX_CELLS (4*1024*1024)   //!< maximal number of grid cells
+#define LAS_SPATIAL_INDEX_MAX_GAP (64)              //!< maximal number of foreign points bridged by an interval
+
+class LasFile;
+
+
+/*!
+ * \brief The LasSpatialIndex class.
+ * Grid of point intervals persisted in a sidecar file.
+ * \remark Queries are conservative, returned intervals contain all points inside the query box,
+ *         but may contain also points outside the box.
+ */
+class G3DTLAS_EXPORT LasSpatialIndex
+{
+protected:
+    LasSpatialIndexHeader header;       //!< header of the index
+    quint64 *cellOffsets = nullptr;     //!< index of the first interval of every cell, nCols * nRows + 1 items
+    LasPointInterval *intervals = nullptr; //!< intervals ordered by cells, nullptr if read on demand from the index file
+    QFile indexFile;                    //!< opened index file, used if intervals are not loaded
+
+public:
+    LasSpatialIndex();
+    ~LasSpatialIndex();
+
+    void destroy();
+    bool isValid();
+    quint32 getNumberOfColumns();
+    quint32 getNumberOfRows();
+    quint64 getNumberOfIntervals();
+
+    bool build(LasFile &las, qint64 pointsPerCell = LAS_SPATIAL_INDEX_POINTS_PER_CELL);
+    bool write(QString fileName);
+    bool read(QString fileName);
+    bool open(LasFile &las, bool buildMissing = true);
+    bool isCompatible(LasFile &las);
+
+    bool queryBox(double x0, double y0, double x1, double y1, QVector<LasPointInterval> &pointIntervals);
+
+    static QString indexFileName(QString lasFileName);
+
+protected:
+    void setupGrid(LasFile &las, qint64 pointsPerCell);
+    inline qint64 cellColumn(double ix);
+    inline qint64 cellRow(double iy);
+    bool readCellIntervals(quint64 firstCell, quint64 lastCell, QVector<LasPointInterval> &pointIntervals);
+};
+
+#endif // LASSPATIALINDEX_H
@@ -0,0 +1,56 @@
+#ifndef LASSPATIALINDEXHEADER_H
+#define LASSPATIALINDEXHEADER_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasspatialindexheader.h
+ *
+ * \brief Header of the spatial index sidecar file.
+ * \remark The header is followed by nCols * nRows + 1 cell offsets (quint64)
+ *         and numberOfIntervals intervals (LasPointInterval).
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+#include "Index/lasfilestamp.h"
+
+#define LAS_SPATIAL_INDEX_SIGNATURE_LENGTH (4)
+#define LAS_SPATIAL_INDEX_VERSION (2)
+
+#pragma pack(1)
+
+/*!
+ * \brief Header of the spatial index sidecar file.
+ * \remark size = 116
+ */
+struct LasSpatialIndexHeader
+{
+    char signature[LAS_SPATIAL_INDEX_SIGNATURE_LENGTH]; //!< "LSXI"
+    quint32 version;                //!< LAS_SPATIAL_INDEX_VERSION
+    LasFileStamp lasFileStamp;      //!< stamp of the indexed las-file
+    quint64 numberOfPoints;         //!< number of points of the indexed las-file
+    quint16 pointRecordLength;      //!< point record length of the indexed las-file
+    quint8 pointFormat;             //!< point format of the indexed las-file
+    quint8 reserved;                //!< set to zero
+    double scaleX;                  //!< scale factors and offsets of the indexed las-file
+    double scaleY;
+    double offsetX;
+    double offsetY;
+    qint64 gridX0;                  //!< scaled x-coordinate of the grid origin
+    qint64 gridY0;                  //!< scaled y-coordinate of the grid origin
+    qint64 cellSize;                //!< size of a cell in scaled coordinates
+    quint32 nCols;                  //!< number of grid columns
+    quint32 nRows;                  //!< number of grid rows
+    quint64 numberOfIntervals;      //!< number of point intervals
+};
+
+#pragma pack()
+
+#endif // LASSPATIALINDEXHEADER_H
@@ -0,0 +1,326 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasspatialsort.cpp
+ *
+ * \brief The implementation of the LasSpatialSort class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <vector>
+#include "lasspatialsort.h"
+#include "lasfile.h"
+
+
+/*!
+ * \brief Constructor.
+ * \param sortCurve Space filling curve.
+ * \param sortMemoryLimit Memory available for buffers in bytes.
+ */
+LasSpatialSort::LasSpatialSort(LasSpaceFillingCurve sortCurve, qint64 sortMemoryLimit)
+{
+    this->curve = sortCurve;
+    this->memoryLimit = sortMemoryLimit;
+    this->gridX0 = this->gridY0 = 0;
+    this->pointRecordLength = 0;
+}
+
+
+/*!
+ * \brief Rewrites a las-file with points sorted along the space filling curve.
+ * \param inputFileName Input las-file.
+ * \param outputFileName Output las-file, compatible with the input las-file.
+ * \return True, if the output las-file was written successfully.
+ * \remark Files larger than the memory limit are sorted in runs stored in a temporary file next to the output file.
+ *         Points with equal keys keep their order.
+ */
+bool LasSpatialSort::sortFile(QString inputFileName, QString outputFileName)
+{
+    bool error = false;
+    LasFile inLas;
+    LasFile outLas;
+    QFile runsFile(outputFileName + LAS_SPATIAL_SORT_RUNS_EXTENSION);
+    qint64 nRecords, runNRecords;
+    char *buf, *sortedBuf;
+    quint64 *keys;
+    qint64 *order;
+
+    if (inputFileName == outputFileName || !QFile::exists(inputFileName)) return false;
+    QFile::remove(outputFileName);
+
+    error = !inLas.open(inputFileName, 0);
+    if (!error) error = !outLas.createCompatible(outputFileName, inLas);
+    if (!error)
+    {
+        this->pointRecordLength = inLas.getPointRecordLength();
+        this->setupGrid(inLas);
+        nRecords = qint64(inLas.getNumberOfPoints());
+        runNRecords = this->memoryLimit / (2 * this->pointRecordLength + qint64(sizeof(quint64) + sizeof(qint64)));
+        if (runNRecords < 1) runNRecords = 1;
+
+        if (nRecords <= runNRecords)
+        {
+            // all records fit into the memory
+            buf = new char[size_t(nRecords * this->pointRecordLength) + 1];
+            sortedBuf = new char[size_t(nRecords * this->pointRecordLength) + 1];
+            keys = new quint64[size_t(nRecords) + 1];
+            order = new qint64[size_t(nRecords) + 1];
+            error = !inLas.readPoints(0, nRecords, buf);
+            if (!error) this->sortRecords(buf, nRecords, sortedBuf, keys, order);
+            for (qint64 i = 0; i < nRecords && !error; i++)
+                error = !outLas.appendPoint(sortedBuf + i * this->pointRecordLength);
+            delete[] buf;
+            delete[] sortedBuf;
+            delete[] keys;
+            delete[] order;
+        }
+        else
+        {
+            error = !this->writeRuns(inLas, runsFile, runNRecords);
+            if (!error) error = !this->mergeRuns(runsFile, nRecords, runNRecords, outLas);
+            runsFile.close();
+            QFile::remove(runsFile.fileName());
+        }
+    }
+    inLas.close();
+
+    if (!error)
+        error = !outLas.close();
+    else
+    {
+        outLas.close();
+        QFile::remove(outputFileName);
+    }
+
+    return !error;
+}
+
+
+/*!
+ * \brief Rewrites a las-file with points sorted along a space filling curve.
+ * \param inputFileName Input las-file.
+ * \param outputFileName Output las-file, compatible with the input las-file.
+ * \param sortCurve Space filling curve.
+ * \param sortMemoryLimit Memory available for buffers in bytes.
+ * \return True, if the output las-file was written successfully.
+ */
+bool LasSpatialSort::sort(QString inputFileName, QString outputFileName, LasSpaceFillingCurve sortCurve, qint64 sortMemoryLimit)
+{
+    LasSpatialSort spatialSort(sortCurve, sortMemoryLimit);
+    return spatialSort.sortFile(inputFileName, outputFileName);
+}
+
+
+/*!
+ * \brief Sets up the mapping of scaled coordinates to the grid of the curve.
+ * \param las Opened las-file.
+ * \remark The grid origin is the minimum given in the header, the full range of scaled coordinates is used if the header extent is not valid.
+ */
+void LasSpatialSort::setupGrid(LasFile &las)
+{
+    double gx0 = floor((las.getX0() - las.getOffsetX()) / las.getScaleX());
+    double gy0 = floor((las.getY0() - las.getOffsetY()) / las.getScaleY());
+
+    if (las.getX0() <= las.getX1() && -2147483648.0 <= gx0 && gx0 <= 2147483647.0)
+        this->gridX0 = qint64(gx0);
+    else
+        this->gridX0 = -2147483648LL;
+
+    if (las.getY0() <= las.getY1() && -2147483648.0 <= gy0 && gy0 <= 2147483647.0)
+        this->gridY0 = qint64(gy0);
+    else
+        this->gridY0 = -2147483648LL;
+}
+
+
+/*!
+ * \brief Returns the curve key of a point record.
+ * \param buf Point record.
+ * \return Position of the point on the curve.
+ */
+inline quint64 LasSpatialSort::pointKey(const char *buf)
+{
+    qint32 ix, iy;
+    qint64 dx, dy;
+
+    memcpy(&ix, buf, sizeof(qint32));
+    memcpy(&iy, buf + sizeof(qint32), sizeof(qint32));
+    dx = qint64(ix) - this->gridX0;
+    dy = qint64(iy) - this->gridY0;
+    if (dx < 0) dx = 0;
+    if (dy < 0) dy = 0;
+
+    if (this->curve == LAS_CURVE_MORTON)
+        return lasMortonKey(quint32(dx), quint32(dy));
+    else
+        return lasHilbertKey(quint32(dx), quint32(dy));
+}
+
+
+/*!
+ * \brief Sorts point records by curve keys.
+ * \param buf Point records.
+ * \param nRecords Number of records.
+ * \param sortedBuf Buffer for sorted records, of the same size as buf.
+ * \param keys Working array of nRecords keys.
+ * \param order Working array of nRecords indices.
+ */
+void LasSpatialSort::sortRecords(char *buf, qint64 nRecords, char *sortedBuf, quint64 *keys, qint64 *order)
+{
+    qint64 i;
+
+    for (i = 0; i < nRecords; i++)
+    {
+        keys[i] = this->pointKey(buf + i * this->pointRecordLength);
+        order[i] = i;
+    }
+
+    std::sort(order, order + nRecords, [keys](qint64 a, qint64 b)
+    {
+        return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+    });
+
+    for (i = 0; i < nRecords; i++)
+        memcpy(sortedBuf + i * this->pointRecordLength, buf + order[i] * this->pointRecordLength, this->pointRecordLength);
+}
+
+
+/*!
+ * \brief Reads the input las-file in runs and writes sorted runs to the temporary file.
+ * \param inLas Input las-file.
+ * \param runsFile Temporary file.
+ * \param runNRecords Number of records in a run.
+ * \return True, if all runs were written successfully.
+ */
+bool LasSpatialSort::writeRuns(LasFile &inLas, QFile &runsFile, qint64 runNRecords)
+{
+    bool error = false;
+    qint64 nRecords = qint64(inLas.getNumberOfPoints());
+    qint64 firstRecord, n, nBytes;
+    char *buf, *sortedBuf;
+    quint64 *keys;
+    qint64 *order;
+
+    if (!runsFile.open(QFile::ReadWrite | QFile::Truncate)) return false;
+
+    buf = new char[size_t(runNRecords * this->pointRecordLength)];
+    sortedBuf = new char[size_t(runNRecords * this->pointRecordLength)];
+    keys = new quint64[size_t(runNRecords)];
+    order = new qint64[size_t(runNRecords)];
+
+    for (firstRecord = 0; firstRecord < nRecords && !error; firstRecord += runNRecords)
+    {
+        n = qMin(runNRecords, nRecords - firstRecord);
+        error = !inLas.readPoints(firstRecord, n, buf);
+        if (!error)
+        {
+            this->sortRecords(buf, n, sortedBuf, keys, order);
+            nBytes = n * this->pointRecordLength;
+            error = runsFile.write(sortedBuf, nBytes) != nBytes;
+        }
+    }
+    if (!error) error = !runsFile.flush();
+
+    delete[] buf;
+    delete[] sortedBuf;
+    delete[] keys;
+    delete[] order;
+
+    return !error;
+}
+
+
+/*!
+ * \brief Merges sorted runs into the output las-file.
+ * \param runsFile Temporary file with sorted runs.
+ * \param nRecords Total number of records.
+ * \param runNRecords Number of records in a run, the last run may be shorter.
+ * \param outLas Output las-file.
+ * \return True, if all records were appended successfully.
+ * \remark Runs are buffered in equal parts of the memory limit, at least LAS_SPATIAL_SORT_MIN_RUN_BUFFER records per run.
+ */
+bool LasSpatialSort::mergeRuns(QFile &runsFile, qint64 nRecords, qint64 runNRecords, LasFile &outLas)
+{
+    typedef std::pair<quint64, qint64> RunKey;
+    std::priority_queue<RunKey, std::vector<RunKey>, std::greater<RunKey>> heap;
+    bool error = false;
+    qint64 nRuns = (nRecords + runNRecords - 1) / runNRecords;
+    qint64 bufferNRecords, i;
+    LasSpatialSortRun *runs;
+    char *rec;
+
+    bufferNRecords = this->memoryLimit / (nRuns * this->pointRecordLength);
+    if (bufferNRecords < LAS_SPATIAL_SORT_MIN_RUN_BUFFER) bufferNRecords = LAS_SPATIAL_SORT_MIN_RUN_BUFFER;
+    if (runNRecords < bufferNRecords) bufferNRecords = runNRecords;
+
+    runs = new LasSpatialSortRun[nRuns];
+    for (i = 0; i < nRuns; i++)
+    {
+        runs[i].fileOffset = i * runNRecords * this->pointRecordLength;
+        runs[i].nUnread = qMin(runNRecords, nRecords - i * runNRecords);
+        runs[i].buffer = new char[size_t(bufferNRecords * this->pointRecordLength)];
+        runs[i].nBuffered = runs[i].iBuffered = 0;
+        if (!error) error = !this->fillRunBuffer(runsFile, runs[i], bufferNRecords);
+        if (!error) heap.push(RunKey(this->pointKey(runs[i].buffer), i));
+    }
+
+    // equal keys are taken from runs in the input order
+    while (!heap.empty() && !error)
+    {
+        i = heap.top().second;
+        heap.pop();
+        rec = runs[i].buffer + runs[i].iBuffered * this->pointRecordLength;
+        error = !outLas.appendPoint(rec);
+        runs[i].iBuffered++;
+        if (!error && runs[i].nBuffered <= runs[i].iBuffered)
+            error = !this->fillRunBuffer(runsFile, runs[i], bufferNRecords);
+        if (!error && runs[i].iBuffered < runs[i].nBuffered)
+            heap.push(RunKey(this->pointKey(runs[i].buffer + runs[i].iBuffered * this->pointRecordLength), i));
+    }
+
+    for (i = 0; i < nRuns; i++)
+        delete[] runs[i].buffer;
+    delete[] runs;
+
+    return !error;
+}
+
+
+/*!
+ * \brief Reads next records of a run into its buffer.
+ * \param runsFile Temporary file with sorted runs.
+ * \param run Run.
+ * \param bufferNRecords Capacity of the run buffer.
+ * \return True, if records were read successfully.
+ */
+bool LasSpatialSort::fillRunBuffer(QFile &runsFile, LasSpatialSortRun &run, qint64 bufferNRecords)
+{
+    bool error = false;
+    qint64 n = qMin(bufferNRecords, run.nUnread);
+    qint64 nBytes = n * this->pointRecordLength;
+
+    run.nBuffered = run.iBuffered = 0;
+    if (n <= 0) return true;
+
+    error = !runsFile.seek(run.fileOffset);
+    if (!error) error = runsFile.read(run.buffer, nBytes) != nBytes;
+    if (!error)
+    {
+        run.fileOffset += nBytes;
+        run.nUnread -= n;
+        run.nBuffered = n;
+    }
+
+    return !error;
+}
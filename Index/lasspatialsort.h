@@ -0,0 +1,76 @@
+#ifndef LASSPATIALSORT_H
+#define LASSPATIALSORT_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasspatialsort.h
+ *
+ * \brief Rewriting of las-files with points ordered along a space filling curve.
+ * \remark The sort is external, sorted runs are stored in a temporary file and merged,
+ *         the memory usage is bounded.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QFile>
+#include "g3dtlas_global.h"
+#include "Index/lasspacefillingcurve.h"
+
+#define LAS_SPATIAL_SORT_MEMORY_LIMIT (512*1024*1024)   //!< default memory used by the sort
+#define LAS_SPATIAL_SORT_MIN_RUN_BUFFER (1024)          //!< minimal number of records buffered from a run while merging
+#define LAS_SPATIAL_SORT_RUNS_EXTENSION ".runs"         //!< extension of the temporary file with sorted runs
+
+class LasFile;
+
+
+/*!
+ * \brief Sorted run of point records stored in the temporary file.
+ */
+struct LasSpatialSortRun
+{
+    qint64 fileOffset;          //!< offset of the next unread record in the temporary file
+    qint64 nUnread;             //!< number of records not read into the buffer
+    char *buffer;               //!< buffered records
+    qint64 nBuffered;           //!< number of records in the buffer
+    qint64 iBuffered;           //!< index of the current record in the buffer
+};
+
+
+/*!
+ * \brief The LasSpatialSort class.
+ * Rewrites a las-file with points sorted along a Morton or Hilbert curve.
+ */
+class G3DTLAS_EXPORT LasSpatialSort
+{
+protected:
+    LasSpaceFillingCurve curve;         //!< space filling curve
+    qint64 gridX0;                      //!< scaled x-coordinate mapped to the column 0
+    qint64 gridY0;                      //!< scaled y-coordinate mapped to the row 0
+    qint64 memoryLimit;                 //!< memory available for buffers
+    quint16 pointRecordLength;          //!< length of point records
+
+public:
+    LasSpatialSort(LasSpaceFillingCurve sortCurve = LAS_CURVE_HILBERT, qint64 sortMemoryLimit = LAS_SPATIAL_SORT_MEMORY_LIMIT);
+
+    bool sortFile(QString inputFileName, QString outputFileName);
+
+    static bool sort(QString inputFileName, QString outputFileName,
+                     LasSpaceFillingCurve sortCurve = LAS_CURVE_HILBERT,
+                     qint64 sortMemoryLimit = LAS_SPATIAL_SORT_MEMORY_LIMIT);
+
+protected:
+    void setupGrid(LasFile &las);
+    inline quint64 pointKey(const char *buf);
+    void sortRecords(char *buf, qint64 nRecords, char *sortedBuf, quint64 *keys, qint64 *order);
+    bool writeRuns(LasFile &inLas, QFile &runsFile, qint64 runNRecords);
+    bool mergeRuns(QFile &runsFile, qint64 nRecords, qint64 runNRecords, LasFile &outLas);
+    bool fillRunBuffer(QFile &runsFile, LasSpatialSortRun &run, qint64 bufferNRecords);
+};
+
+#endif // LASSPATIALSORT_H
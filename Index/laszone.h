@@ -0,0 +1,43 @@
+#ifndef LASZONE_H
+#define LASZONE_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laszone.h
+ *
+ * \brief Bounds of point values in a chunk of point records.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+
+#pragma pack(1)
+
+/*!
+ * \brief Minimum and maximum of point values in a chunk of point records.
+ * \remark size = 42
+ */
+struct LasZone
+{
+    qint32 ix0;                 //!< min scaled coordinates
+    qint32 iy0;
+    qint32 iz0;
+    qint32 ix1;                 //!< max scaled coordinates
+    qint32 iy1;
+    qint32 iz1;
+    double gpsTime0;            //!< min GPS time, zero for point formats without GPS time
+    double gpsTime1;            //!< max GPS time
+    quint8 classification0;     //!< min classification
+    quint8 classification1;     //!< max classification
+};
+
+#pragma pack()
+
+#endif // LASZONE_H
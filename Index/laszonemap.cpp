@@ -0,0 +1,352 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laszonemap.cpp
+ *
+ * \brief The implementation of the LasZoneMap class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <cstring>
+#include "laszonemap.h"
+#include "lasfile.h"
+
+
+/*!
+ * \brief Default constructor.
+ */
+LasZoneMap::LasZoneMap()
+{
+    clear();
+}
+
+
+/*!
+ * \brief Removes all zones.
+ * \param chunkNRecords Number of point records in a chunk.
+ */
+void LasZoneMap::clear(quint32 chunkNRecords)
+{
+    memset(&this->header, 0, sizeof(LasZoneMapHeader));
+    memcpy(this->header.signature, "LSZM", LAS_ZONE_MAP_SIGNATURE_LENGTH);
+    this->header.version = LAS_ZONE_MAP_VERSION;
+    this->header.chunkNRecords = (0 < chunkNRecords ? chunkNRecords : 1);
+    this->zones.clear();
+}
+
+
+/*!
+ * \brief Appends zones of following point records.
+ * \param zoneMap Zone map of appended points.
+ * \return True, if zones were appended. Zones can be appended only if chunks have the same size
+ *         and the last chunk of this zone map is complete.
+ */
+bool LasZoneMap::append(const LasZoneMap &zoneMap)
+{
+    if (zoneMap.header.chunkNRecords != this->header.chunkNRecords) return false;
+    if (this->header.numberOfPoints % this->header.chunkNRecords != 0) return false;
+
+    for (int i = 0; i < zoneMap.zones.size(); i++)
+        this->zones.append(zoneMap.zones[i]);
+    this->header.numberOfPoints += zoneMap.header.numberOfPoints;
+    this->header.numberOfZones += zoneMap.header.numberOfZones;
+    return true;
+}
+
+
+/*!
+ * \brief Appends the zone of a whole chunk.
+ * \param zone Zone of the chunk.
+ * \param nRecords Number of records of the chunk, only the last chunk may be shorter than chunkNRecords.
+ * \return True, if the zone was appended, false if the map does not end at a chunk boundary.
+ */
+bool LasZoneMap::appendZone(const LasZone &zone, quint32 nRecords)
+{
+    if (nRecords == 0 || this->header.chunkNRecords < nRecords) return false;
+    if (this->header.numberOfPoints % this->header.chunkNRecords != 0) return false;
+
+    this->zones.append(zone);
+    this->header.numberOfPoints += nRecords;
+    this->header.numberOfZones++;
+    return true;
+}
+
+
+/*!
+ * \brief Returns the number of points covered by zones.
+ * \return Number of points.
+ */
+quint64 LasZoneMap::getNumberOfPoints()
+{
+    return this->header.numberOfPoints;
+}
+
+
+/*!
+ * \brief Returns the number of point records in a chunk.
+ * \return Number of records.
+ */
+quint32 LasZoneMap::getChunkNRecords()
+{
+    return this->header.chunkNRecords;
+}
+
+
+/*!
+ * \brief Returns the number of zones.
+ * \return Number of zones.
+ */
+qint64 LasZoneMap::getNumberOfZones()
+{
+    return qint64(this->header.numberOfZones);
+}
+
+
+/*!
+ * \brief Returns the zone of a chunk.
+ * \param iZone Index of the chunk.
+ * \return Zone.
+ */
+const LasZone &LasZoneMap::getZone(qint64 iZone)
+{
+    return this->zones[int(iZone)];
+}
+
+
+/*!
+ * \brief Builds the zone map from all point records.
+ * \param las Opened las-file.
+ * \param chunkNRecords Number of point records in a chunk.
+ * \return True, if all points were read successfully.
+ */
+bool LasZoneMap::build(LasFile &las, quint32 chunkNRecords)
+{
+    bool error;
+
+    this->clear(chunkNRecords);
+    error = !las.forEachPoint(0, qint64(las.getNumberOfPoints()), [this](qint64, LasPoint &lasPoint)
+    {
+        this->add(lasPoint.ix, lasPoint.iy, lasPoint.iz, lasPoint.gpsTime, lasPoint.classification);
+        return true;
+    }, LAS_FIELD_XYZ | LAS_FIELD_GPS_TIME | LAS_FIELD_CLASSIFICATION);
+
+    if (error) this->clear(chunkNRecords);
+    return !error;
+}
+
+
+/*!
+ * \brief Writes the zone map to a sidecar file.
+ * \param fileName Name of the zone map file.
+ * \param las Las-file described by the zone map, all point records must be written.
+ * \return True, if the zone map was written successfully.
+ * \remark The las-file is stamped by its current state, the zone map must be written after the las-file.
+ */
+bool LasZoneMap::write(QString fileName, LasFile &las)
+{
+    QFile file(fileName);
+    qint64 nBytes;
+    bool error = false;
+
+    if (this->header.numberOfPoints != las.getNumberOfPoints()) return false;
+    this->setLayout(las);
+
+    if (file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        error = file.write((char *)&this->header, sizeof(LasZoneMapHeader)) != sizeof(LasZoneMapHeader);
+        if (!error && 0 < this->zones.size())
+        {
+            nBytes = qint64(this->zones.size()) * qint64(sizeof(LasZone));
+            error = file.write((char *)this->zones.constData(), nBytes) != nBytes;
+        }
+        file.close();
+        if (error) QFile::remove(fileName);
+    }
+    else error = true;
+
+    return !error;
+}
+
+
+/*!
+ * \brief Reads the zone map from a sidecar file.
+ * \param fileName Name of the zone map file.
+ * \return True, if the zone map was read successfully.
+ */
+bool LasZoneMap::read(QString fileName)
+{
+    QFile file(fileName);
+    qint64 nBytes;
+    bool error = false;
+
+    this->clear();
+    if (!file.open(QFile::ReadOnly)) return false;
+
+    error = file.read((char *)&this->header, sizeof(LasZoneMapHeader)) != sizeof(LasZoneMapHeader);
+    if (!error) error = memcmp(this->header.signature, "LSZM", LAS_ZONE_MAP_SIGNATURE_LENGTH) != 0;
+    if (!error) error = this->header.version != LAS_ZONE_MAP_VERSION || this->header.chunkNRecords == 0;
+    if (!error) error = this->header.numberOfZones != (this->header.numberOfPoints + this->header.chunkNRecords - 1) / this->header.chunkNRecords;
+    if (!error)
+    {
+        nBytes = qint64(this->header.numberOfZones) * qint64(sizeof(LasZone));
+        error = file.size() != qint64(sizeof(LasZoneMapHeader)) + nBytes;
+        if (!error)
+        {
+            this->zones.resize(int(this->header.numberOfZones));
+            error = file.read((char *)this->zones.data(), nBytes) != nBytes;
+        }
+    }
+    file.close();
+
+    if (error) this->clear();
+    return !error;
+}
+
+
+/*!
+ * \brief Checks if the zone map corresponds to a las-file.
+ * \param las Opened las-file.
+ * \return True, if the zone map describes the las-file.
+ * \remark The las-file must not be changed after the zone map was written, its size, modification time and header are compared.
+ */
+bool LasZoneMap::isCompatible(LasFile &las)
+{
+    LasFileStamp stamp;
+
+    return las.getFileStamp(stamp)
+            && this->header.numberOfPoints == las.getNumberOfPoints()
+            && this->header.pointRecordLength == las.getPointRecordLength()
+            && this->header.pointFormat == las.getPointFormat()
+            && this->header.scaleX == las.getScaleX()
+            && this->header.scaleY == las.getScaleY()
+            && this->header.scaleZ == las.getScaleZ()
+            && this->header.offsetX == las.getOffsetX()
+            && this->header.offsetY == las.getOffsetY()
+            && this->header.offsetZ == las.getOffsetZ()
+            && memcmp(&this->header.lasFileStamp, &stamp, sizeof(LasFileStamp)) == 0;
+}
+
+
+/*!
+ * \brief Checks if a chunk may contain points accepted by a filter.
+ * \param iZone Index of the chunk.
+ * \param filter Point filter.
+ * \return False, if no point of the chunk is accepted by the filter.
+ * \remark Coordinates are unscaled in the same way as decoded points.
+ */
+bool LasZoneMap::mayMatch(qint64 iZone, LasPointFilter &filter)
+{
+    const LasZone &zone = this->zones[int(iZone)];
+    const double scaleX = this->header.scaleX != 0.0 ? this->header.scaleX : 1.0;
+    const double scaleY = this->header.scaleY != 0.0 ? this->header.scaleY : 1.0;
+    const double scaleZ = this->header.scaleZ != 0.0 ? this->header.scaleZ : 1.0;
+    double x0 = this->header.offsetX + scaleX * zone.ix0;
+    double y0 = this->header.offsetY + scaleY * zone.iy0;
+    double z0 = this->header.offsetZ + scaleZ * zone.iz0;
+    double x1 = this->header.offsetX + scaleX * zone.ix1;
+    double y1 = this->header.offsetY + scaleY * zone.iy1;
+    double z1 = this->header.offsetZ + scaleZ * zone.iz1;
+
+    if (x1 < x0) qSwap(x0, x1);
+    if (y1 < y0) qSwap(y0, y1);
+    if (z1 < z0) qSwap(z0, z1);
+
+    return filter.overlaps(x0, y0, z0, x1, y1, z1, zone.gpsTime0, zone.gpsTime1, zone.classification0, zone.classification1);
+}
+
+
+/*!
+ * \brief Returns the name of the zone map file of a las-file.
+ * \param lasFileName Name of the las-file.
+ * \return Name of the zone map file.
+ */
+QString LasZoneMap::zoneMapFileName(QString lasFileName)
+{
+    return lasFileName + LAS_ZONE_MAP_FILE_EXTENSION;
+}
+
+
+/*!
+ * \brief Computes the zone of all points of a batch.
+ * \param batch Batch with scaled coordinates, gps times and classifications.
+ * \param zone Returns the zone.
+ * \return True, if the batch is not empty.
+ * \remark Columns are reduced by separate loops, which can be vectorised by the compiler.
+ */
+bool LasZoneMap::batchZone(const LasPointBatch &batch, LasZone &zone)
+{
+    const qint64 n = batch.numberOfPoints;
+    qint32 ix0, iy0, iz0, ix1, iy1, iz1;
+    double gpsTime0, gpsTime1;
+    quint8 classification0, classification1;
+    qint64 i;
+
+    if (n <= 0) return false;
+
+    ix0 = ix1 = batch.ix[0];
+    iy0 = iy1 = batch.iy[0];
+    iz0 = iz1 = batch.iz[0];
+    gpsTime0 = gpsTime1 = batch.gpsTime[0];
+    classification0 = classification1 = batch.classification[0];
+    for (i = 1; i < n; i++)
+    {
+        ix0 = qMin(ix0, batch.ix[i]);
+        ix1 = qMax(ix1, batch.ix[i]);
+    }
+    for (i = 1; i < n; i++)
+    {
+        iy0 = qMin(iy0, batch.iy[i]);
+        iy1 = qMax(iy1, batch.iy[i]);
+    }
+    for (i = 1; i < n; i++)
+    {
+        iz0 = qMin(iz0, batch.iz[i]);
+        iz1 = qMax(iz1, batch.iz[i]);
+    }
+    for (i = 1; i < n; i++)
+    {
+        if (batch.gpsTime[i] < gpsTime0) gpsTime0 = batch.gpsTime[i];
+        if (gpsTime1 < batch.gpsTime[i]) gpsTime1 = batch.gpsTime[i];
+    }
+    for (i = 1; i < n; i++)
+    {
+        classification0 = qMin(classification0, batch.classification[i]);
+        classification1 = qMax(classification1, batch.classification[i]);
+    }
+
+    zone.ix0 = ix0;
+    zone.iy0 = iy0;
+    zone.iz0 = iz0;
+    zone.ix1 = ix1;
+    zone.iy1 = iy1;
+    zone.iz1 = iz1;
+    zone.gpsTime0 = gpsTime0;
+    zone.gpsTime1 = gpsTime1;
+    zone.classification0 = classification0;
+    zone.classification1 = classification1;
+    return true;
+}
+
+
+/*!
+ * \brief Stores the layout of a las-file in the header.
+ * \param las Opened las-file.
+ */
+void LasZoneMap::setLayout(LasFile &las)
+{
+    las.getFileStamp(this->header.lasFileStamp);
+    this->header.pointRecordLength = las.getPointRecordLength();
+    this->header.pointFormat = las.getPointFormat();
+    this->header.scaleX = las.getScaleX();
+    this->header.scaleY = las.getScaleY();
+    this->header.scaleZ = las.getScaleZ();
+    this->header.offsetX = las.getOffsetX();
+    this->header.offsetY = las.getOffsetY();
+    this->header.offsetZ = las.getOffsetZ();
+}
@@ -0,0 +1,140 @@
+#ifndef LASZONEMAP_H
+#define LASZONEMAP_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laszonemap.h
+ *
+ * \brief Zone map of a las-file.
+ * \remark Point records are split into chunks of a fixed number of records,
+ *         the zone of a chunk holds bounds of point values in the chunk.
+ *         The zone map is stored in a sidecar file next to the las-file.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QVector>
+#include "g3dtlas_global.h"
+#include "Index/laszone.h"
+#include "Index/laszonemapheader.h"
+#include "Point/laspointbatch.h"
+#include "Point/laspointfilter.h"
+
+#define LAS_ZONE_MAP_FILE_EXTENSION ".lzm"          //!< extension appended to the las-file name
+#define LAS_ZONE_MAP_CHUNK_NRECORDS (64*1024)       //!< default number of point records in a chunk
+
+class LasFile;
+
+
+/*!
+ * \brief The LasZoneMap class.
+ * Bounds of point values for every chunk of point records.
+ */
+class G3DTLAS_EXPORT LasZoneMap
+{
+protected:
+    LasZoneMapHeader header;            //!< header, numberOfPoints and numberOfZones describe added points
+    QVector<LasZone> zones;             //!< zones of chunks
+
+public:
+    LasZoneMap();
+
+    void clear(quint32 chunkNRecords = LAS_ZONE_MAP_CHUNK_NRECORDS);
+    inline void add(qint32 ix, qint32 iy, qint32 iz, double gpsTime, quint8 classification);
+    inline void expand(qint64 iRecord, qint32 ix, qint32 iy, qint32 iz, double gpsTime, quint8 classification);
+    bool append(const LasZoneMap &zoneMap);
+    bool appendZone(const LasZone &zone, quint32 nRecords);
+
+    quint64 getNumberOfPoints();
+    quint32 getChunkNRecords();
+    qint64 getNumberOfZones();
+    const LasZone &getZone(qint64 iZone);
+
+    bool build(LasFile &las, quint32 chunkNRecords = LAS_ZONE_MAP_CHUNK_NRECORDS);
+    bool write(QString fileName, LasFile &las);
+    bool read(QString fileName);
+    bool isCompatible(LasFile &las);
+
+    bool mayMatch(qint64 iZone, LasPointFilter &filter);
+
+    static QString zoneMapFileName(QString lasFileName);
+    static bool batchZone(const LasPointBatch &batch, LasZone &zone);
+
+protected:
+    void setLayout(LasFile &las);
+};
+
+
+/*!
+ * \brief Adds the next point record.
+ * \param ix Scaled x-coordinate.
+ * \param iy Scaled y-coordinate.
+ * \param iz Scaled z-coordinate.
+ * \param gpsTime GPS time.
+ * \param classification Classification.
+ */
+inline void LasZoneMap::add(qint32 ix, qint32 iy, qint32 iz, double gpsTime, quint8 classification)
+{
+    if (this->header.numberOfPoints % this->header.chunkNRecords == 0)
+    {
+        LasZone zone;
+        zone.ix0 = zone.ix1 = ix;
+        zone.iy0 = zone.iy1 = iy;
+        zone.iz0 = zone.iz1 = iz;
+        zone.gpsTime0 = zone.gpsTime1 = gpsTime;
+        zone.classification0 = zone.classification1 = classification;
+        this->zones.append(zone);
+        this->header.numberOfZones++;
+    }
+    else
+    {
+        LasZone &zone = this->zones.last();
+        if (ix < zone.ix0) zone.ix0 = ix;
+        if (zone.ix1 < ix) zone.ix1 = ix;
+        if (iy < zone.iy0) zone.iy0 = iy;
+        if (zone.iy1 < iy) zone.iy1 = iy;
+        if (iz < zone.iz0) zone.iz0 = iz;
+        if (zone.iz1 < iz) zone.iz1 = iz;
+        if (gpsTime < zone.gpsTime0) zone.gpsTime0 = gpsTime;
+        if (zone.gpsTime1 < gpsTime) zone.gpsTime1 = gpsTime;
+        if (classification < zone.classification0) zone.classification0 = classification;
+        if (zone.classification1 < classification) zone.classification1 = classification;
+    }
+    this->header.numberOfPoints++;
+}
+
+
+/*!
+ * \brief Expands the zone of a changed point record.
+ * \param iRecord Index of the record, records not added to the map are ignored.
+ * \param ix Scaled x-coordinate.
+ * \param iy Scaled y-coordinate.
+ * \param iz Scaled z-coordinate.
+ * \param gpsTime GPS time.
+ * \param classification Classification.
+ * \remark Zones are never shrunk, they stay conservative.
+ */
+inline void LasZoneMap::expand(qint64 iRecord, qint32 ix, qint32 iy, qint32 iz, double gpsTime, quint8 classification)
+{
+    if (iRecord < 0 || this->header.numberOfPoints <= quint64(iRecord)) return;
+
+    LasZone &zone = this->zones[int(iRecord / this->header.chunkNRecords)];
+    if (ix < zone.ix0) zone.ix0 = ix;
+    if (zone.ix1 < ix) zone.ix1 = ix;
+    if (iy < zone.iy0) zone.iy0 = iy;
+    if (zone.iy1 < iy) zone.iy1 = iy;
+    if (iz < zone.iz0) zone.iz0 = iz;
+    if (zone.iz1 < iz) zone.iz1 = iz;
+    if (gpsTime < zone.gpsTime0) zone.gpsTime0 = gpsTime;
+    if (zone.gpsTime1 < gpsTime) zone.gpsTime1 = gpsTime;
+    if (classification < zone.classification0) zone.classification0 = classification;
+    if (zone.classification1 < classification) zone.classification1 = classification;
+}
+
+#endif // LASZONEMAP_H
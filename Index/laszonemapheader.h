@@ -0,0 +1,53 @@
+#ifndef LASZONEMAPHEADER_H
+#define LASZONEMAPHEADER_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laszonemapheader.h
+ *
+ * \brief Header of the zone map sidecar file.
+ * \remark The header is followed by numberOfZones zones (LasZone).
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+#include "Index/lasfilestamp.h"
+
+#define LAS_ZONE_MAP_SIGNATURE_LENGTH (4)
+#define LAS_ZONE_MAP_VERSION (2)
+
+#pragma pack(1)
+
+/*!
+ * \brief Header of the zone map sidecar file.
+ * \remark size = 104
+ */
+struct LasZoneMapHeader
+{
+    char signature[LAS_ZONE_MAP_SIGNATURE_LENGTH]; //!< "LSZM"
+    quint32 version;                //!< LAS_ZONE_MAP_VERSION
+    LasFileStamp lasFileStamp;      //!< stamp of the las-file written after the zone map was updated
+    quint64 numberOfPoints;         //!< number of points of the las-file
+    quint16 pointRecordLength;      //!< point record length of the las-file
+    quint8 pointFormat;             //!< point format of the las-file
+    quint8 reserved;                //!< set to zero
+    quint32 chunkNRecords;          //!< number of point records in a chunk
+    double scaleX;                  //!< scale factors and offsets of the las-file
+    double scaleY;
+    double scaleZ;
+    double offsetX;
+    double offsetY;
+    double offsetZ;
+    quint64 numberOfZones;          //!< number of zones
+};
+
+#pragma pack()
+
+#endif // LASZONEMAPHEADER_H
@@ -0,0 +1,296 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lascoordinates.cpp
+ *
+ * \brief The implemenation of the LasCoordinates class.
+ * \remark SIMD kernels are compiled only for x86 processors with GCC, Clang or MSVC,
+ *         other platforms use the scalar kernels.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "lascoordinates.h"
+
+#if defined(Q_PROCESSOR_X86) && (defined(Q_CC_GNU) || defined(Q_CC_CLANG))
+#  define LAS_COORDINATES_SIMD
+#  define LAS_TARGET_SSE2 __attribute__((target("sse2")))
+#  define LAS_TARGET_AVX2 __attribute__((target("avx2")))
+#  include <immintrin.h>
+#elif defined(Q_PROCESSOR_X86) && defined(Q_CC_MSVC)
+#  define LAS_COORDINATES_SIMD
+#  define LAS_TARGET_SSE2
+#  define LAS_TARGET_AVX2
+#  include <intrin.h>
+#  include <immintrin.h>
+#endif
+
+#define LAS_ROUND_HALF (0.49999999999999994) //!< the largest double less than 0.5, round(v) == trunc(v + copysign(LAS_ROUND_HALF, v))
+
+
+const LasCoordinates::FUnscaleFunction LasCoordinates::UnscaleFunctions[3] =
+    { LasCoordinates::unscaleScalar, LasCoordinates::unscaleSSE2, LasCoordinates::unscaleAVX2 };
+
+const LasCoordinates::FScaleFunction LasCoordinates::ScaleFunctions[3] =
+    { LasCoordinates::scaleScalar, LasCoordinates::scaleSSE2, LasCoordinates::scaleAVX2 };
+
+const LasCoordinatesKernel LasCoordinates::Kernel = LasCoordinates::detectKernel();
+
+
+/*!
+ * \brief Kernel used on the current CPU.
+ * \return Instruction set of the coordinate kernels.
+ */
+LasCoordinatesKernel LasCoordinates::kernel()
+{
+    return LasCoordinates::Kernel;
+}
+
+
+/*!
+ * \brief Converts an array of scaled coordinates to not-scaled coordinates.
+ * \param ic Input scaled coordinates.
+ * \param c Output not-scaled coordinates.
+ * \param n Number of coordinates.
+ * \param scale Scale factor.
+ * \param offset Offset.
+ */
+void LasCoordinates::unscale(const qint32 *ic, double *c, qint64 n, double scale, double offset)
+{
+    if (n <= 0) return;
+    if (scale == 0.0) scale = 1.0;
+    UnscaleFunctions[Kernel](ic, c, n, scale, offset);
+}
+
+
+/*!
+ * \brief Converts an array of not-scaled coordinates to scaled coordinates.
+ * \param c Input not-scaled coordinates.
+ * \param ic Output scaled coordinates.
+ * \param n Number of coordinates.
+ * \param scale Scale factor.
+ * \param offset Offset.
+ */
+void LasCoordinates::scale(const double *c, qint32 *ic, qint64 n, double scale, double offset)
+{
+    if (n <= 0) return;
+    if (scale == 0.0) scale = 1.0;
+    ScaleFunctions[Kernel](c, ic, n, scale, offset);
+}
+
+
+/*!
+ * \brief Converts a scaled coordinate to not-scaled coordinate.
+ * \param ic Scaled coordinate.
+ * \param scale Scale factor.
+ * \param offset Offset.
+ * \return Not-scaled coordinate.
+ */
+double LasCoordinates::unscale(qint32 ic, double scale, double offset)
+{
+    return scale != 0.0 ? offset + scale * ic : offset + ic;
+}
+
+
+/*!
+ * \brief Converts a not-scaled coordinate to scaled coordinate.
+ * \param c Not-scaled coordinate.
+ * \param scale Scale factor.
+ * \param offset Offset.
+ * \return Scaled coordinate.
+ */
+qint32 LasCoordinates::scale(double c, double scale, double offset)
+{
+    return qint32(scale != 0.0 ? round((c - offset) / scale) : round(c - offset));
+}
+
+
+/*!
+ * \brief Selects coordinate kernels by CPU features.
+ * \return The best supported instruction set.
+ */
+LasCoordinatesKernel LasCoordinates::detectKernel()
+{
+#if defined(LAS_COORDINATES_SIMD) && (defined(Q_CC_GNU) || defined(Q_CC_CLANG))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return LAS_KERNEL_AVX2;
+    if (__builtin_cpu_supports("sse2")) return LAS_KERNEL_SSE2;
+#elif defined(LAS_COORDINATES_SIMD) && defined(Q_CC_MSVC)
+    int info[4];
+
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool osAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+    if (osAvx && 7 <= maxLeaf)
+    {
+        __cpuidex(info, 7, 0);
+        if (info[1] & (1 << 5)) return LAS_KERNEL_AVX2;
+    }
+    if (sse2) return LAS_KERNEL_SSE2;
+#endif
+    return LAS_KERNEL_SCALAR;
+}
+
+
+/*!
+ * \brief Scalar unscale kernel.
+ * \param ic Input scaled coordinates.
+ * \param c Output not-scaled coordinates.
+ * \param n Number of coordinates.
+ * \param scale Scale factor, must not be zero.
+ * \param offset Offset.
+ */
+void LasCoordinates::unscaleScalar(const qint32 *ic, double *c, qint64 n, double scale, double offset)
+{
+    for(qint64 i = 0; i < n; i++)
+        c[i] = offset + scale * ic[i];
+}
+
+
+/*!
+ * \brief Scalar scale kernel.
+ * \param c Input not-scaled coordinates.
+ * \param ic Output scaled coordinates.
+ * \param n Number of coordinates.
+ * \param scale Scale factor, must not be zero.
+ * \param offset Offset.
+ */
+void LasCoordinates::scaleScalar(const double *c, qint32 *ic, qint64 n, double scale, double offset)
+{
+    for(qint64 i = 0; i < n; i++)
+        ic[i] = qint32(round((c[i] - offset) / scale));
+}
+
+
+#if defined(LAS_COORDINATES_SIMD)
+
+/*!
+ * \brief SSE2 unscale kernel, 2 coordinates per iteration.
+ * \param ic Input scaled coordinates.
+ * \param c Output not-scaled coordinates.
+ * \param n Number of coordinates.
+ * \param scale Scale factor, must not be zero.
+ * \param offset Offset.
+ */
+LAS_TARGET_SSE2 void LasCoordinates::unscaleSSE2(const qint32 *ic, double *c, qint64 n, double scale, double offset)
+{
+    const __m128d vScale = _mm_set1_pd(scale);
+    const __m128d vOffset = _mm_set1_pd(offset);
+    qint64 i = 0;
+
+    for(; i + 2 <= n; i += 2)
+    {
+        __m128i vi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ic + i));
+        _mm_storeu_pd(c + i, _mm_add_pd(vOffset, _mm_mul_pd(vScale, _mm_cvtepi32_pd(vi))));
+    }
+    unscaleScalar(ic + i, c + i, n - i, scale, offset);
+}
+
+
+/*!
+ * \brief SSE2 scale kernel, 2 coordinates per iteration.
+ * \param c Input not-scaled coordinates.
+ * \param ic Output scaled coordinates.
+ * \param n Number of coordinates.
+ * \param scale Scale factor, must not be zero.
+ * \param offset Offset.
+ */
+LAS_TARGET_SSE2 void LasCoordinates::scaleSSE2(const double *c, qint32 *ic, qint64 n, double scale, double offset)
+{
+    const __m128d vScale = _mm_set1_pd(scale);
+    const __m128d vOffset = _mm_set1_pd(offset);
+    const __m128d vHalf = _mm_set1_pd(LAS_ROUND_HALF);
+    const __m128d vSign = _mm_set1_pd(-0.0);
+    qint64 i = 0;
+
+    for(; i + 2 <= n; i += 2)
+    {
+        __m128d v = _mm_div_pd(_mm_sub_pd(_mm_loadu_pd(c + i), vOffset), vScale);
+        v = _mm_add_pd(v, _mm_or_pd(vHalf, _mm_and_pd(v, vSign)));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(ic + i), _mm_cvttpd_epi32(v));
+    }
+    scaleScalar(c + i, ic + i, n - i, scale, offset);
+}
+
+
+/*!
+ * \brief AVX2 unscale kernel, 4 coordinates per iteration.
+ * \param ic Input scaled coordinates.
+ * \param c Output not-scaled coordinates.
+ * \param n Number of coordinates.
+ * \param scale Scale factor, must not be zero.
+ * \param offset Offset.
+ */
+LAS_TARGET_AVX2 void LasCoordinates::unscaleAVX2(const qint32 *ic, double *c, qint64 n, double scale, double offset)
+{
+    const __m256d vScale = _mm256_set1_pd(scale);
+    const __m256d vOffset = _mm256_set1_pd(offset);
+    qint64 i = 0;
+
+    for(; i + 4 <= n; i += 4)
+    {
+        __m128i vi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ic + i));
+        _mm256_storeu_pd(c + i, _mm256_add_pd(vOffset, _mm256_mul_pd(vScale, _mm256_cvtepi32_pd(vi))));
+    }
+    unscaleScalar(ic + i, c + i, n - i, scale, offset);
+}
+
+
+/*!
+ * \brief AVX2 scale kernel, 4 coordinates per iteration.
+ * \param c Input not-scaled coordinates.
+ * \param ic Output scaled coordinates.
+ * \param n Number of coordinates.
+ * \param scale Scale factor, must not be zero.
+ * \param offset Offset.
+ */
+LAS_TARGET_AVX2 void LasCoordinates::scaleAVX2(const double *c, qint32 *ic, qint64 n, double scale, double offset)
+{
+    const __m256d vScale = _mm256_set1_pd(scale);
+    const __m256d vOffset = _mm256_set1_pd(offset);
+    const __m256d vHalf = _mm256_set1_pd(LAS_ROUND_HALF);
+    const __m256d vSign = _mm256_set1_pd(-0.0);
+    qint64 i = 0;
+
+    for(; i + 4 <= n; i += 4)
+    {
+        __m256d v = _mm256_div_pd(_mm256_sub_pd(_mm256_loadu_pd(c + i), vOffset), vScale);
+        v = _mm256_add_pd(v, _mm256_or_pd(vHalf, _mm256_and_pd(v, vSign)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ic + i), _mm256_cvttpd_epi32(v));
+    }
+    scaleScalar(c + i, ic + i, n - i, scale, offset);
+}
+
+#else
+
+/*!
+ * \brief SIMD kernels are not available, scalar kernels are used.
+ */
+void LasCoordinates::unscaleSSE2(const qint32 *ic, double *c, qint64 n, double scale, double offset)
+{
+    unscaleScalar(ic, c, n, scale, offset);
+}
+
+void LasCoordinates::scaleSSE2(const double *c, qint32 *ic, qint64 n, double scale, double offset)
+{
+    scaleScalar(c, ic, n, scale, offset);
+}
+
+void LasCoordinates::unscaleAVX2(const qint32 *ic, double *c, qint64 n, double scale, double offset)
+{
+    unscaleScalar(ic, c, n, scale, offset);
+}
+
+void LasCoordinates::scaleAVX2(const double *c, qint32 *ic, qint64 n, double scale, double offset)
+{
+    scaleScalar(c, ic, n, scale, offset);
+}
+
+#endif
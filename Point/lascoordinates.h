@@ -0,0 +1,73 @@
+#ifndef LASCOORDINATES_H
+#define LASCOORDINATES_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lascoordinates.h
+ *
+ * \brief Batch transformation of point coordinates.
+ * \remark Vectorised kernels (SSE2, AVX2) with a scalar fallback,
+ *         the kernel is selected once by the CPU features.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+
+
+/*!
+ * \brief Instruction sets of coordinate kernels.
+ */
+enum LasCoordinatesKernel
+{
+    LAS_KERNEL_SCALAR = 0,
+    LAS_KERNEL_SSE2 = 1,
+    LAS_KERNEL_AVX2 = 2
+};
+
+
+/*!
+ * \brief The LasCoordinates class.
+ * Converts arrays of scaled (integer) coordinates to not-scaled (double) coordinates and back.
+ * \remark x = offset + scale * ix
+ *         ix = round((x - offset) / scale)
+ *         Zero scale is treated as 1.
+ */
+class G3DTLAS_EXPORT LasCoordinates
+{
+protected:
+    typedef void (*FUnscaleFunction)(const qint32 *ic, double *c, qint64 n, double scale, double offset); //!< unscale kernel template
+    typedef void (*FScaleFunction)(const double *c, qint32 *ic, qint64 n, double scale, double offset); //!< scale kernel template
+
+    static const LasCoordinatesKernel Kernel;   //!< kernel selected by the CPU features
+    static const FUnscaleFunction UnscaleFunctions[3]; //!< array of unscale kernels
+    static const FScaleFunction ScaleFunctions[3]; //!< array of scale kernels
+
+public:
+    static LasCoordinatesKernel kernel();
+
+    static void unscale(const qint32 *ic, double *c, qint64 n, double scale, double offset);
+    static void scale(const double *c, qint32 *ic, qint64 n, double scale, double offset);
+
+    static double unscale(qint32 ic, double scale, double offset);
+    static qint32 scale(double c, double scale, double offset);
+
+protected:
+    static LasCoordinatesKernel detectKernel();
+
+    static void unscaleScalar(const qint32 *ic, double *c, qint64 n, double scale, double offset);
+    static void unscaleSSE2(const qint32 *ic, double *c, qint64 n, double scale, double offset);
+    static void unscaleAVX2(const qint32 *ic, double *c, qint64 n, double scale, double offset);
+
+    static void scaleScalar(const double *c, qint32 *ic, qint64 n, double scale, double offset);
+    static void scaleSSE2(const double *c, qint32 *ic, qint64 n, double scale, double offset);
+    static void scaleAVX2(const double *c, qint32 *ic, qint64 n, double scale, double offset);
+};
+
+#endif // LASCOORDINATES_H
@@ -14,6 +14,7 @@
  */
 
 #include "laspoint.h"
+#include "lascoordinates.h"
 
 
 /*!
@@ -40,6 +41,7 @@ LasPoint::LasPoint(LasPoint &lasPoint)
 LasPoint::~LasPoint()
 {
     destroy();
+    if (this->heapExtraData != nullptr) delete [] this->heapExtraData;
 }
 
 
@@ -56,7 +58,8 @@ LasPoint &LasPoint::operator=(LasPoint &lasPoint)
 
 
 /*!
- * Releases allocated memory and sets properties to default values.
+ * Sets properties to default values.
+ * \remark Memory of extra data is kept for the following reads, a buffer assigned to extraData by the caller is deleted.
  */
 void LasPoint::destroy()
 {
@@ -95,11 +98,47 @@ void LasPoint::destroy()
     this->z = 0.0;
 
     this->extraDataLength = 0;
-    if (this->extraData != nullptr)
-    {
-        delete [] this->extraData;
+    releaseExtraData();
+}
+
+
+/*!
+ * \brief Allocates extra data.
+ * \param length Length of extra data in bytes.
+ * \return Pointer to extra data, nullptr if length is zero.
+ * \remark Short extra data are stored inside the point, memory is reallocated only if the length grows over the previous maximum.
+ */
+char *LasPoint::allocateExtraData(quint32 length)
+{
+    releaseExtraData();
+    this->extraDataLength = length;
+    if (length == 0)
         this->extraData = nullptr;
+    else if (length <= LAS_POINT_INLINE_EXTRA_DATA)
+        this->extraData = this->inlineExtraData;
+    else
+    {
+        if (this->heapExtraDataCapacity < length)
+        {
+            if (this->heapExtraData != nullptr) delete [] this->heapExtraData;
+            this->heapExtraData = new char[length];
+            this->heapExtraDataCapacity = length;
+        }
+        this->extraData = this->heapExtraData;
     }
+    return this->extraData;
+}
+
+
+/*!
+ * \brief Detaches extra data from the point.
+ * \remark A buffer assigned to extraData by the caller is deleted, storage of the point is kept.
+ */
+void LasPoint::releaseExtraData()
+{
+    if (this->extraData != nullptr && this->extraData != this->inlineExtraData && this->extraData != this->heapExtraData)
+        delete [] this->extraData;
+    this->extraData = nullptr;
 }
 
 
@@ -111,9 +150,9 @@ void LasPoint::destroy()
  */
 void LasPoint::scaleCoordinates(double offsetX, double offsetY, double offsetZ, double scaleX, double scaleY, double scaleZ)
 {
-    this->ix = qint32(scaleX != 0.0 ? round(this->x - offsetX) / scaleX : round(this->x - offsetX));
-    this->iy = qint32(scaleY != 0.0 ? round(this->y - offsetY) / scaleY : round(this->y - offsetY));
-    this->iz = qint32(scaleZ != 0.0 ? round(this->z - offsetZ) / scaleZ : round(this->z - offsetZ));
+    this->ix = LasCoordinates::scale(this->x, scaleX, offsetX);
+    this->iy = LasCoordinates::scale(this->y, scaleY, offsetY);
+    this->iz = LasCoordinates::scale(this->z, scaleZ, offsetZ);
 }
 
 
@@ -125,9 +164,9 @@ void LasPoint::scaleCoordinates(double offsetX, double offsetY, double offsetZ,
  */
 void LasPoint::unscaleCoordinates(double offsetX, double offsetY, double offsetZ, double scaleX, double scaleY, double scaleZ)
 {
-    this->x = scaleX != 0.0 ? offsetX + scaleX * this->ix : offsetX + this->ix;
-    this->y = scaleY != 0.0 ? offsetY + scaleY * this->iy : offsetY + this->iy;
-    this->z = scaleZ != 0.0 ? offsetZ + scaleZ * this->iz : offsetX + this->iz;
+    this->x = LasCoordinates::unscale(this->ix, scaleX, offsetX);
+    this->y = LasCoordinates::unscale(this->iy, scaleY, offsetY);
+    this->z = LasCoordinates::unscale(this->iz, scaleZ, offsetZ);
 }
 
 
@@ -137,6 +176,7 @@ void LasPoint::unscaleCoordinates(double offsetX, double offsetY, double offsetZ
  */
 void LasPoint::copyFrom(LasPoint &lasPoint)
 {
+    if (&lasPoint == this) return;
     destroy();
 
     this->ix = lasPoint.ix;
@@ -173,10 +213,6 @@ void LasPoint::copyFrom(LasPoint &lasPoint)
     this->y = lasPoint.y;
     this->z = lasPoint.z;
 
-    this->extraDataLength = lasPoint.extraDataLength;
-    if (0 < this->extraDataLength)
-    {
-        this->extraData = new char[this->extraDataLength];
-        memcpy(this->extraData, lasPoint.extraData, this->extraDataLength);
-    }
+    if (0 < lasPoint.extraDataLength)
+        memcpy(allocateExtraData(lasPoint.extraDataLength), lasPoint.extraData, lasPoint.extraDataLength);
 }
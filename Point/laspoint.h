@@ -34,6 +34,30 @@
 
 #define LAS_NUMBER_OF_POINT_RECORD_DATA_FORMATS (11)
 #define LAS_NUMBER_OF_DATA_TYPES (11)
+#define LAS_POINT_INLINE_EXTRA_DATA (32) //!< extra bytes up to this length are stored inside LasPoint
+
+
+/*!
+ * \brief Point fields.
+ * Bit mask used to select fields decoded from point records.
+ */
+enum LasPointFields
+{
+    LAS_FIELD_XYZ = 0x0001,             //!< scaled and not-scaled coordinates
+    LAS_FIELD_INTENSITY = 0x0002,
+    LAS_FIELD_RETURNS = 0x0004,         //!< return number and number of returns
+    LAS_FIELD_CLASSIFICATION = 0x0008,  //!< classification
+    LAS_FIELD_USER_DATA = 0x0010,
+    LAS_FIELD_SCAN_ANGLE = 0x0020,
+    LAS_FIELD_SOURCE_ID = 0x0040,
+    LAS_FIELD_GPS_TIME = 0x0080,
+    LAS_FIELD_RGB = 0x0100,
+    LAS_FIELD_NIR = 0x0200,
+    LAS_FIELD_WAVEFORM = 0x0400,
+    LAS_FIELD_EXTRA_DATA = 0x0800,
+    LAS_FIELD_CLASSIFICATION_FLAGS = 0x1000, //!< byte of classification flags, scanner channel, scan direction and edge of flight line of formats 6-10
+    LAS_FIELD_ALL = 0x1FFF
+};
 
 
 /*!
@@ -78,7 +102,12 @@ public:
     double z = 0.0;
 
     quint32 extraDataLength = 0;
-    char *extraData = nullptr;
+    char *extraData = nullptr;  //!< extra bytes owned by the point, use allocateExtraData; a buffer assigned by the caller must be allocated by new[], it is deleted by the point
+
+protected:
+    char inlineExtraData[LAS_POINT_INLINE_EXTRA_DATA]; //!< storage of short extra bytes
+    char *heapExtraData = nullptr;      //!< storage of long extra bytes, kept for following reads
+    quint32 heapExtraDataCapacity = 0;  //!< size of heapExtraData in bytes
 
 public:
     LasPoint();
@@ -87,12 +116,14 @@ public:
     LasPoint &operator=(LasPoint &lasPoint);
 
     void destroy();
+    char *allocateExtraData(quint32 length);
 
     void scaleCoordinates(double offsetX, double offsetY, double offsetZ, double scaleX, double scaleY, double scaleZ);
     void unscaleCoordinates(double offsetX, double offsetY, double offsetZ, double scaleX, double scaleY, double scaleZ);
 
 protected:
     void copyFrom(LasPoint &lasPoint);
+    void releaseExtraData();
 };
 
 #endif // LASPOINT_H
@@ -0,0 +1,238 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laspointbatch.cpp
+ *
+ * \brief The implemenation of the LasPointBatch class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "laspointbatch.h"
+
+
+/*!
+ * \brief Default constructor.
+ */
+LasPointBatch::LasPointBatch()
+{
+}
+
+
+/*!
+ * \brief Destructor. Releases allocated arrays.
+ */
+LasPointBatch::~LasPointBatch()
+{
+    destroy();
+}
+
+
+/*!
+ * \brief Allocates arrays for a given number of points.
+ * \param nPoints Number of points.
+ * \param pointExtraDataLength Length of extra data of one point.
+ * \param batchFields Bit mask of fields to be stored in the batch (LasPointFields).
+ * \return True, if arrays were allocated.
+ * \remark Arrays are reused if the batch is large enough. The batch is emptied.
+ */
+bool LasPointBatch::allocate(qint64 nPoints, quint32 pointExtraDataLength, quint32 batchFields)
+{
+    if (nPoints < 0) return false;
+
+    if (this->capacity < nPoints || this->extraDataLength != pointExtraDataLength)
+    {
+        destroy();
+        this->capacity = nPoints;
+        this->extraDataLength = pointExtraDataLength;
+    }
+
+    if (0 < this->capacity)
+    {
+        const quint64 n = quint64(this->capacity);
+
+        if (batchFields & LAS_FIELD_XYZ)
+        {
+            if (this->ix == nullptr) this->ix = new qint32[n];
+            if (this->iy == nullptr) this->iy = new qint32[n];
+            if (this->iz == nullptr) this->iz = new qint32[n];
+            if (this->x == nullptr) this->x = new double[n];
+            if (this->y == nullptr) this->y = new double[n];
+            if (this->z == nullptr) this->z = new double[n];
+        }
+        if ((batchFields & LAS_FIELD_INTENSITY) && this->intensity == nullptr) this->intensity = new quint16[n];
+        if (batchFields & LAS_FIELD_RETURNS)
+        {
+            if (this->returnNumber == nullptr) this->returnNumber = new quint8[n];
+            if (this->numberOfReturns == nullptr) this->numberOfReturns = new quint8[n];
+        }
+        if ((batchFields & LAS_FIELD_CLASSIFICATION) && this->classification == nullptr) this->classification = new quint8[n];
+        if ((batchFields & LAS_FIELD_CLASSIFICATION_FLAGS) && this->classificationFlag == nullptr) this->classificationFlag = new quint8[n]();
+        if ((batchFields & LAS_FIELD_USER_DATA) && this->userData == nullptr) this->userData = new quint8[n];
+        if ((batchFields & LAS_FIELD_SCAN_ANGLE) && this->scanAngle == nullptr) this->scanAngle = new qint16[n];
+        if ((batchFields & LAS_FIELD_SOURCE_ID) && this->sourceID == nullptr) this->sourceID = new quint16[n];
+        if ((batchFields & LAS_FIELD_GPS_TIME) && this->gpsTime == nullptr) this->gpsTime = new double[n];
+        if (batchFields & LAS_FIELD_RGB)
+        {
+            if (this->r == nullptr) this->r = new quint16[n];
+            if (this->g == nullptr) this->g = new quint16[n];
+            if (this->b == nullptr) this->b = new quint16[n];
+        }
+        if ((batchFields & LAS_FIELD_NIR) && this->ir == nullptr) this->ir = new quint16[n];
+        if ((batchFields & LAS_FIELD_EXTRA_DATA) && 0 < this->extraDataLength && this->extraData == nullptr) this->extraData = new char[n * this->extraDataLength];
+    }
+
+    this->fields = batchFields & ~quint32(LAS_FIELD_WAVEFORM);
+    if (this->extraDataLength == 0) this->fields &= ~quint32(LAS_FIELD_EXTRA_DATA);
+    this->firstPoint = -1;
+    this->numberOfPoints = 0;
+    return true;
+}
+
+
+/*!
+ * \brief Releases allocated arrays.
+ */
+void LasPointBatch::destroy()
+{
+    delete [] this->ix;
+    delete [] this->iy;
+    delete [] this->iz;
+    delete [] this->x;
+    delete [] this->y;
+    delete [] this->z;
+    delete [] this->intensity;
+    delete [] this->returnNumber;
+    delete [] this->numberOfReturns;
+    delete [] this->classificationFlag;
+    delete [] this->classification;
+    delete [] this->userData;
+    delete [] this->scanAngle;
+    delete [] this->sourceID;
+    delete [] this->gpsTime;
+    delete [] this->r;
+    delete [] this->g;
+    delete [] this->b;
+    delete [] this->ir;
+    delete [] this->extraData;
+
+    this->ix = this->iy = this->iz = nullptr;
+    this->x = this->y = this->z = nullptr;
+    this->intensity = nullptr;
+    this->returnNumber = this->numberOfReturns = nullptr;
+    this->classificationFlag = this->classification = nullptr;
+    this->userData = nullptr;
+    this->scanAngle = nullptr;
+    this->sourceID = nullptr;
+    this->gpsTime = nullptr;
+    this->r = this->g = this->b = this->ir = nullptr;
+    this->extraData = nullptr;
+
+    this->firstPoint = -1;
+    this->numberOfPoints = 0;
+    this->capacity = 0;
+    this->fields = 0;
+    this->extraDataLength = 0;
+}
+
+
+/*!
+ * \brief Copies a point from the batch.
+ * \param i Index of the point in the batch.
+ * \param lasPoint Target las-point.
+ * \remark Fields not stored in the batch are set to default values.
+ */
+void LasPointBatch::getPoint(qint64 i, LasPoint &lasPoint)
+{
+    lasPoint.destroy();
+    if (i < 0 || this->numberOfPoints <= i) return;
+
+    if (this->fields & LAS_FIELD_XYZ)
+    {
+        lasPoint.ix = this->ix[i];
+        lasPoint.iy = this->iy[i];
+        lasPoint.iz = this->iz[i];
+        lasPoint.x = this->x[i];
+        lasPoint.y = this->y[i];
+        lasPoint.z = this->z[i];
+    }
+    if (this->fields & LAS_FIELD_INTENSITY) lasPoint.intensity = this->intensity[i];
+    if (this->fields & LAS_FIELD_RETURNS)
+    {
+        lasPoint.returnNumber = this->returnNumber[i];
+        lasPoint.numberOfReturns = this->numberOfReturns[i];
+    }
+    if (this->fields & LAS_FIELD_CLASSIFICATION) lasPoint.classification = this->classification[i];
+    if (this->fields & LAS_FIELD_CLASSIFICATION_FLAGS) lasPoint.classificationFlag = this->classificationFlag[i];
+    if (this->fields & LAS_FIELD_USER_DATA) lasPoint.userData = this->userData[i];
+    if (this->fields & LAS_FIELD_SCAN_ANGLE) lasPoint.scanAngle = this->scanAngle[i];
+    if (this->fields & LAS_FIELD_SOURCE_ID) lasPoint.sourceID = this->sourceID[i];
+    if (this->fields & LAS_FIELD_GPS_TIME) lasPoint.gpsTime = this->gpsTime[i];
+    if (this->fields & LAS_FIELD_RGB)
+    {
+        lasPoint.r = this->r[i];
+        lasPoint.g = this->g[i];
+        lasPoint.b = this->b[i];
+    }
+    if (this->fields & LAS_FIELD_NIR) lasPoint.ir = this->ir[i];
+
+    if (this->fields & LAS_FIELD_EXTRA_DATA)
+    {
+        memcpy(lasPoint.allocateExtraData(this->extraDataLength), this->extraData + i * this->extraDataLength, this->extraDataLength);
+    }
+}
+
+
+/*!
+ * \brief Stores a point into the batch.
+ * \param i Index of the point in the batch, must be less than capacity.
+ * \param lasPoint Source las-point.
+ * \remark Only fields stored in the batch are copied. The number of points is extended to include the point.
+ */
+void LasPointBatch::setPoint(qint64 i, LasPoint &lasPoint)
+{
+    if (i < 0 || this->capacity <= i) return;
+
+    if (this->fields & LAS_FIELD_XYZ)
+    {
+        this->ix[i] = lasPoint.ix;
+        this->iy[i] = lasPoint.iy;
+        this->iz[i] = lasPoint.iz;
+        this->x[i] = lasPoint.x;
+        this->y[i] = lasPoint.y;
+        this->z[i] = lasPoint.z;
+    }
+    if (this->fields & LAS_FIELD_INTENSITY) this->intensity[i] = lasPoint.intensity;
+    if (this->fields & LAS_FIELD_RETURNS)
+    {
+        this->returnNumber[i] = lasPoint.returnNumber;
+        this->numberOfReturns[i] = lasPoint.numberOfReturns;
+    }
+    if (this->fields & LAS_FIELD_CLASSIFICATION) this->classification[i] = lasPoint.classification;
+    if (this->fields & LAS_FIELD_CLASSIFICATION_FLAGS) this->classificationFlag[i] = lasPoint.classificationFlag;
+    if (this->fields & LAS_FIELD_USER_DATA) this->userData[i] = lasPoint.userData;
+    if (this->fields & LAS_FIELD_SCAN_ANGLE) this->scanAngle[i] = lasPoint.scanAngle;
+    if (this->fields & LAS_FIELD_SOURCE_ID) this->sourceID[i] = lasPoint.sourceID;
+    if (this->fields & LAS_FIELD_GPS_TIME) this->gpsTime[i] = lasPoint.gpsTime;
+    if (this->fields & LAS_FIELD_RGB)
+    {
+        this->r[i] = lasPoint.r;
+        this->g[i] = lasPoint.g;
+        this->b[i] = lasPoint.b;
+    }
+    if (this->fields & LAS_FIELD_NIR) this->ir[i] = lasPoint.ir;
+
+    if (this->fields & LAS_FIELD_EXTRA_DATA)
+    {
+        memset(this->extraData + i * this->extraDataLength, 0, this->extraDataLength);
+        if (0 < lasPoint.extraDataLength)
+            memcpy(this->extraData + i * this->extraDataLength, lasPoint.extraData, qMin(this->extraDataLength, lasPoint.extraDataLength));
+    }
+
+    if (this->numberOfPoints <= i) this->numberOfPoints = i + 1;
+}
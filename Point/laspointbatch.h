@@ -0,0 +1,80 @@
+#ifndef LASPOINTBATCH_H
+#define LASPOINTBATCH_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laspointbatch.h
+ *
+ * \brief Columnar batch of LAS points.
+ * \remark Every point attribute is stored in a separate contiguous array
+ *         (structure of arrays), waveform attributes are not stored.
+ *         Arrays are allocated only for the selected fields (LasPointFields).
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+#include "laspoint.h"
+
+
+/*!
+ * \brief The LasPointBatch class.
+ * Columnar container used to read and process large runs of points.
+ * \sa LasPoint
+ */
+class G3DTLAS_EXPORT LasPointBatch
+{
+public:
+    qint64 firstPoint = -1;             //!< index of the first point of the batch in las-file
+    qint64 numberOfPoints = 0;          //!< number of points stored in the batch
+    qint64 capacity = 0;                //!< number of points allocated in every array
+    quint32 fields = 0;                 //!< bit mask of fields stored in the batch (LasPointFields)
+
+    qint32 *ix = nullptr;               //!< scaled coordinates, stored in las-file
+    qint32 *iy = nullptr;
+    qint32 *iz = nullptr;
+
+    double *x = nullptr;                //!< not-scaled coordinates, ready to use
+    double *y = nullptr;
+    double *z = nullptr;
+
+    quint16 *intensity = nullptr;
+    quint8 *returnNumber = nullptr;
+    quint8 *numberOfReturns = nullptr;
+    quint8 *classificationFlag = nullptr;   //!< zeros for formats 0-5
+    quint8 *classification = nullptr;
+
+    quint8 *userData = nullptr;
+    qint16 *scanAngle = nullptr;
+    quint16 *sourceID = nullptr;
+    double *gpsTime = nullptr;
+
+    quint16 *r = nullptr;
+    quint16 *g = nullptr;
+    quint16 *b = nullptr;
+    quint16 *ir = nullptr;
+
+    quint32 extraDataLength = 0;        //!< length of extra data of one point
+    char *extraData = nullptr;          //!< extra data of all points, extraDataLength bytes per point
+
+public:
+    LasPointBatch();
+    ~LasPointBatch();
+
+    bool allocate(qint64 nPoints, quint32 pointExtraDataLength = 0, quint32 batchFields = LAS_FIELD_ALL);
+    void destroy();
+
+    void getPoint(qint64 i, LasPoint &lasPoint);
+    void setPoint(qint64 i, LasPoint &lasPoint);
+
+private:
+    Q_DISABLE_COPY(LasPointBatch)
+};
+
+#endif // LASPOINTBATCH_H
@@ -0,0 +1,284 @@
+#ifndef LASPOINTCODEC_H
+#define LASPOINTCODEC_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laspointcodec.h
+ *
+ * \brief Compile-time specialised point record decoders and encoders.
+ * \remark Template LasPointCodec<Format> reads and writes the record structures
+ *         LasPoint0, LasPoint1, ... LasPoint10. All functions are inline,
+ *         so a loop over records of one format is compiled without indirect calls.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+#include "laspoint.h"
+
+
+/*!
+ * \brief Point data record format traits.
+ * \remark Extended: formats 6-10 (4-bit returns, classification flags, 16-bit scan angle).
+ */
+template<int Format> struct LasPointFormat;
+
+template<> struct LasPointFormat<0> { typedef LasPoint0 Record; enum { Extended = 0, HasGpsTime = 0, HasColor = 0, HasNir = 0, HasWaveform = 0 }; };
+template<> struct LasPointFormat<1> { typedef LasPoint1 Record; enum { Extended = 0, HasGpsTime = 1, HasColor = 0, HasNir = 0, HasWaveform = 0 }; };
+template<> struct LasPointFormat<2> { typedef LasPoint2 Record; enum { Extended = 0, HasGpsTime = 0, HasColor = 1, HasNir = 0, HasWaveform = 0 }; };
+template<> struct LasPointFormat<3> { typedef LasPoint3 Record; enum { Extended = 0, HasGpsTime = 1, HasColor = 1, HasNir = 0, HasWaveform = 0 }; };
+template<> struct LasPointFormat<4> { typedef LasPoint4 Record; enum { Extended = 0, HasGpsTime = 1, HasColor = 0, HasNir = 0, HasWaveform = 1 }; };
+template<> struct LasPointFormat<5> { typedef LasPoint5 Record; enum { Extended = 0, HasGpsTime = 1, HasColor = 1, HasNir = 0, HasWaveform = 1 }; };
+template<> struct LasPointFormat<6> { typedef LasPoint6 Record; enum { Extended = 1, HasGpsTime = 1, HasColor = 0, HasNir = 0, HasWaveform = 0 }; };
+template<> struct LasPointFormat<7> { typedef LasPoint7 Record; enum { Extended = 1, HasGpsTime = 1, HasColor = 1, HasNir = 0, HasWaveform = 0 }; };
+template<> struct LasPointFormat<8> { typedef LasPoint8 Record; enum { Extended = 1, HasGpsTime = 1, HasColor = 1, HasNir = 1, HasWaveform = 0 }; };
+template<> struct LasPointFormat<9> { typedef LasPoint9 Record; enum { Extended = 1, HasGpsTime = 1, HasColor = 0, HasNir = 0, HasWaveform = 1 }; };
+template<> struct LasPointFormat<10> { typedef LasPoint10 Record; enum { Extended = 1, HasGpsTime = 1, HasColor = 1, HasNir = 1, HasWaveform = 1 }; };
+
+
+/*!
+ * \brief Codec of fields common to all formats.
+ * \remark x, y, z, intensity, flag, classification, userData, scanAngle, sourceId
+ */
+template<bool Extended> struct LasPointCoreCodec
+{
+    template<class R> static inline void decode(const R *rec, LasPoint &lasPoint, quint32 fields)
+    {
+        if (fields & LAS_FIELD_XYZ)
+        {
+            lasPoint.ix = rec->x;
+            lasPoint.iy = rec->y;
+            lasPoint.iz = rec->z;
+        }
+        if (fields & LAS_FIELD_INTENSITY) lasPoint.intensity = rec->intensity;
+        if (fields & LAS_FIELD_RETURNS)
+        {
+            lasPoint.returnNumber = (rec->flag & 7);
+            lasPoint.numberOfReturns = ((rec->flag >> 3) & 7);
+        }
+        if (fields & LAS_FIELD_CLASSIFICATION) lasPoint.classification = rec->classification;
+        if (fields & LAS_FIELD_SCAN_ANGLE) lasPoint.scanAngle = rec->scanAngle;
+        if (fields & LAS_FIELD_USER_DATA) lasPoint.userData = rec->userData;
+        if (fields & LAS_FIELD_SOURCE_ID) lasPoint.sourceID = rec->sourceID;
+    }
+
+    template<class R> static inline void encode(LasPoint &lasPoint, R *rec)
+    {
+        rec->x = lasPoint.ix;
+        rec->y = lasPoint.iy;
+        rec->z = lasPoint.iz;
+        rec->intensity = lasPoint.intensity;
+        rec->flag = quint8((lasPoint.returnNumber & 7) | ((lasPoint.numberOfReturns & 7) << 3));
+        rec->classification = lasPoint.classification;
+        rec->scanAngle = qint8(lasPoint.scanAngle & 255);
+        rec->userData = lasPoint.userData;
+        rec->sourceID = lasPoint.sourceID;
+    }
+};
+
+template<> struct LasPointCoreCodec<true>
+{
+    template<class R> static inline void decode(const R *rec, LasPoint &lasPoint, quint32 fields)
+    {
+        if (fields & LAS_FIELD_XYZ)
+        {
+            lasPoint.ix = rec->x;
+            lasPoint.iy = rec->y;
+            lasPoint.iz = rec->z;
+        }
+        if (fields & LAS_FIELD_INTENSITY) lasPoint.intensity = rec->intensity;
+        if (fields & LAS_FIELD_RETURNS)
+        {
+            lasPoint.returnNumber = (rec->flag & 15);
+            lasPoint.numberOfReturns = ((rec->flag >> 4) & 15);
+        }
+        if (fields & LAS_FIELD_CLASSIFICATION_FLAGS) lasPoint.classificationFlag = rec->classificationFlag;
+        if (fields & LAS_FIELD_CLASSIFICATION) lasPoint.classification = rec->classification;
+        if (fields & LAS_FIELD_USER_DATA) lasPoint.userData = rec->userData;
+        if (fields & LAS_FIELD_SCAN_ANGLE) lasPoint.scanAngle = rec->scanAngle;
+        if (fields & LAS_FIELD_SOURCE_ID) lasPoint.sourceID = rec->sourceID;
+    }
+
+    template<class R> static inline void encode(LasPoint &lasPoint, R *rec)
+    {
+        rec->x = lasPoint.ix;
+        rec->y = lasPoint.iy;
+        rec->z = lasPoint.iz;
+        rec->intensity = lasPoint.intensity;
+        rec->flag = quint8((lasPoint.returnNumber & 15) | ((lasPoint.numberOfReturns & 15) << 4));
+        rec->classificationFlag = lasPoint.classificationFlag;
+        rec->classification = lasPoint.classification;
+        rec->userData = lasPoint.userData;
+        rec->scanAngle = lasPoint.scanAngle;
+        rec->sourceID = lasPoint.sourceID;
+    }
+};
+
+
+/*!
+ * \brief Codec of gps time, does nothing for formats without gps time.
+ */
+template<bool Enabled> struct LasPointGpsTimeCodec
+{
+    template<class R> static inline void decode(const R *, LasPoint &, quint32) {}
+    template<class R> static inline void encode(LasPoint &, R *) {}
+};
+
+template<> struct LasPointGpsTimeCodec<true>
+{
+    template<class R> static inline void decode(const R *rec, LasPoint &lasPoint, quint32 fields)
+    {
+        if (fields & LAS_FIELD_GPS_TIME) lasPoint.gpsTime = rec->gpsTime;
+    }
+
+    template<class R> static inline void encode(LasPoint &lasPoint, R *rec)
+    {
+        rec->gpsTime = lasPoint.gpsTime;
+    }
+};
+
+
+/*!
+ * \brief Codec of r, g, b, does nothing for formats without colors.
+ */
+template<bool Enabled> struct LasPointColorCodec
+{
+    template<class R> static inline void decode(const R *, LasPoint &, quint32) {}
+    template<class R> static inline void encode(LasPoint &, R *) {}
+};
+
+template<> struct LasPointColorCodec<true>
+{
+    template<class R> static inline void decode(const R *rec, LasPoint &lasPoint, quint32 fields)
+    {
+        if (fields & LAS_FIELD_RGB)
+        {
+            lasPoint.r = rec->r;
+            lasPoint.g = rec->g;
+            lasPoint.b = rec->b;
+        }
+    }
+
+    template<class R> static inline void encode(LasPoint &lasPoint, R *rec)
+    {
+        rec->r = lasPoint.r;
+        rec->g = lasPoint.g;
+        rec->b = lasPoint.b;
+    }
+};
+
+
+/*!
+ * \brief Codec of near infrared, does nothing for formats without near infrared.
+ */
+template<bool Enabled> struct LasPointNirCodec
+{
+    template<class R> static inline void decode(const R *, LasPoint &, quint32) {}
+    template<class R> static inline void encode(LasPoint &, R *) {}
+};
+
+template<> struct LasPointNirCodec<true>
+{
+    template<class R> static inline void decode(const R *rec, LasPoint &lasPoint, quint32 fields)
+    {
+        if (fields & LAS_FIELD_NIR) lasPoint.ir = rec->ir;
+    }
+
+    template<class R> static inline void encode(LasPoint &lasPoint, R *rec)
+    {
+        rec->ir = lasPoint.ir;
+    }
+};
+
+
+/*!
+ * \brief Codec of waveform packets, does nothing for formats without waveform.
+ */
+template<bool Enabled> struct LasPointWaveformCodec
+{
+    template<class R> static inline void decode(const R *, LasPoint &, quint32) {}
+    template<class R> static inline void encode(LasPoint &, R *) {}
+};
+
+template<> struct LasPointWaveformCodec<true>
+{
+    template<class R> static inline void decode(const R *rec, LasPoint &lasPoint, quint32 fields)
+    {
+        if (fields & LAS_FIELD_WAVEFORM)
+        {
+            lasPoint.waveformPacketIndex = rec->waveformPacketIndex;
+            lasPoint.waveformDataOffset = rec->waveformDataOffset;
+            lasPoint.waveformPacketSize = rec->waveformPacketSize;
+            lasPoint.waveformLocation = rec->waveformLocation;
+            lasPoint.xt = rec->xT;
+            lasPoint.yt = rec->yT;
+            lasPoint.zt = rec->zT;
+        }
+    }
+
+    template<class R> static inline void encode(LasPoint &lasPoint, R *rec)
+    {
+        rec->waveformPacketIndex = lasPoint.waveformPacketIndex;
+        rec->waveformDataOffset = lasPoint.waveformDataOffset;
+        rec->waveformPacketSize = lasPoint.waveformPacketSize;
+        rec->waveformLocation = lasPoint.waveformLocation;
+        rec->xT = lasPoint.xt;
+        rec->yT = lasPoint.yt;
+        rec->zT = lasPoint.zt;
+    }
+};
+
+
+/*!
+ * \brief The LasPointCodec class.
+ * Decoder and encoder of point records of one point data record format.
+ * \remark Extra bytes are not decoded nor encoded.
+ * \remark Coordinates are not scaled nor unscaled.
+ */
+template<int Format> class LasPointCodec
+{
+public:
+    typedef LasPointFormat<Format> Traits;
+    typedef typename Traits::Record Record;
+
+    /*!
+     * \brief Decodes a point record from byte array.
+     * \param buf Buffer.
+     * \param lasPoint LAS point to be loaded with data.
+     * \param fields Bit mask of decoded fields (LasPointFields).
+     */
+    static inline void decode(const char *buf, LasPoint &lasPoint, quint32 fields)
+    {
+        const Record *rec = reinterpret_cast<const Record*>(buf);
+
+        LasPointCoreCodec<Traits::Extended>::decode(rec, lasPoint, fields);
+        LasPointGpsTimeCodec<Traits::HasGpsTime>::decode(rec, lasPoint, fields);
+        LasPointColorCodec<Traits::HasColor>::decode(rec, lasPoint, fields);
+        LasPointNirCodec<Traits::HasNir>::decode(rec, lasPoint, fields);
+        LasPointWaveformCodec<Traits::HasWaveform>::decode(rec, lasPoint, fields);
+    }
+
+    /*!
+     * \brief Encodes a point record to byte array.
+     * \param lasPoint LAS point with scaled coordinates.
+     * \param buf Buffer.
+     */
+    static inline void encode(LasPoint &lasPoint, char *buf)
+    {
+        Record *rec = reinterpret_cast<Record*>(buf);
+
+        LasPointCoreCodec<Traits::Extended>::encode(lasPoint, rec);
+        LasPointGpsTimeCodec<Traits::HasGpsTime>::encode(lasPoint, rec);
+        LasPointColorCodec<Traits::HasColor>::encode(lasPoint, rec);
+        LasPointNirCodec<Traits::HasNir>::encode(lasPoint, rec);
+        LasPointWaveformCodec<Traits::HasWaveform>::encode(lasPoint, rec);
+    }
+};
+
+#endif // LASPOINTCODEC_H
@@ -0,0 +1,133 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laspointfilter.cpp
+ *
+ * \brief The implementation of the LasPointFilter class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "laspointfilter.h"
+
+
+/*!
+ * \brief Default constructor, the filter accepts all points.
+ */
+LasPointFilter::LasPointFilter()
+{
+}
+
+
+/*!
+ * \brief Removes all criteria.
+ */
+void LasPointFilter::clear()
+{
+    this->criteria = LAS_FILTER_NONE;
+}
+
+
+/*!
+ * \brief Sets the box of x and y coordinates.
+ * \param xMin Minimal x-coordinate.
+ * \param yMin Minimal y-coordinate.
+ * \param xMax Maximal x-coordinate.
+ * \param yMax Maximal y-coordinate.
+ */
+void LasPointFilter::setBox(double xMin, double yMin, double xMax, double yMax)
+{
+    this->x0 = xMin;
+    this->y0 = yMin;
+    this->x1 = xMax;
+    this->y1 = yMax;
+    this->criteria |= LAS_FILTER_XY;
+}
+
+
+/*!
+ * \brief Sets the range of z coordinates.
+ * \param zMin Minimal z-coordinate.
+ * \param zMax Maximal z-coordinate.
+ */
+void LasPointFilter::setZRange(double zMin, double zMax)
+{
+    this->z0 = zMin;
+    this->z1 = zMax;
+    this->criteria |= LAS_FILTER_Z;
+}
+
+
+/*!
+ * \brief Sets the range of GPS time.
+ * \param gpsTimeMin Minimal GPS time.
+ * \param gpsTimeMax Maximal GPS time.
+ */
+void LasPointFilter::setGpsTimeRange(double gpsTimeMin, double gpsTimeMax)
+{
+    this->gpsTime0 = gpsTimeMin;
+    this->gpsTime1 = gpsTimeMax;
+    this->criteria |= LAS_FILTER_GPS_TIME;
+}
+
+
+/*!
+ * \brief Sets the range of classification.
+ * \param classificationMin Minimal classification.
+ * \param classificationMax Maximal classification.
+ */
+void LasPointFilter::setClassificationRange(quint8 classificationMin, quint8 classificationMax)
+{
+    this->classification0 = classificationMin;
+    this->classification1 = classificationMax;
+    this->criteria |= LAS_FILTER_CLASSIFICATION;
+}
+
+
+/*!
+ * \brief Returns fields which must be decoded to evaluate the filter.
+ * \return Bit mask of fields (LasPointFields).
+ */
+quint32 LasPointFilter::requiredFields()
+{
+    quint32 fields = 0;
+
+    if (this->criteria & (LAS_FILTER_XY | LAS_FILTER_Z)) fields |= LAS_FIELD_XYZ;
+    if (this->criteria & LAS_FILTER_GPS_TIME) fields |= LAS_FIELD_GPS_TIME;
+    if (this->criteria & LAS_FILTER_CLASSIFICATION) fields |= LAS_FIELD_CLASSIFICATION;
+    return fields;
+}
+
+
+/*!
+ * \brief Checks if a set of points with given bounds may contain a point meeting all criteria.
+ * \param xMin Minimal x-coordinate.
+ * \param yMin Minimal y-coordinate.
+ * \param zMin Minimal z-coordinate.
+ * \param xMax Maximal x-coordinate.
+ * \param yMax Maximal y-coordinate.
+ * \param zMax Maximal z-coordinate.
+ * \param gpsTimeMin Minimal GPS time.
+ * \param gpsTimeMax Maximal GPS time.
+ * \param classificationMin Minimal classification.
+ * \param classificationMax Maximal classification.
+ * \return False, if no point inside the bounds meets the criteria.
+ */
+bool LasPointFilter::overlaps(double xMin, double yMin, double zMin, double xMax, double yMax, double zMax,
+                              double gpsTimeMin, double gpsTimeMax, quint8 classificationMin, quint8 classificationMax)
+{
+    if ((this->criteria & LAS_FILTER_XY) && (xMax < this->x0 || this->x1 < xMin || yMax < this->y0 || this->y1 < yMin))
+        return false;
+    if ((this->criteria & LAS_FILTER_Z) && (zMax < this->z0 || this->z1 < zMin))
+        return false;
+    if ((this->criteria & LAS_FILTER_GPS_TIME) && (gpsTimeMax < this->gpsTime0 || this->gpsTime1 < gpsTimeMin))
+        return false;
+    if ((this->criteria & LAS_FILTER_CLASSIFICATION) && (classificationMax < this->classification0 || this->classification1 < classificationMin))
+        return false;
+    return true;
+}
@@ -0,0 +1,89 @@
+#ifndef LASPOINTFILTER_H
+#define LASPOINTFILTER_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laspointfilter.h
+ *
+ * \brief Predicate on point coordinates, GPS time and classification.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+#include "laspoint.h"
+
+
+/*!
+ * \brief Criteria of the point filter, a point must meet all set criteria.
+ */
+enum LasPointFilterCriteria
+{
+    LAS_FILTER_NONE = 0x0000,
+    LAS_FILTER_XY = 0x0001,             //!< x and y inside a box
+    LAS_FILTER_Z = 0x0002,              //!< z inside a range
+    LAS_FILTER_GPS_TIME = 0x0004,       //!< GPS time inside a range
+    LAS_FILTER_CLASSIFICATION = 0x0008  //!< classification inside a range
+};
+
+
+/*!
+ * \brief The LasPointFilter class.
+ * Closed ranges of point values, used to select points and to skip chunks of point records.
+ */
+class G3DTLAS_EXPORT LasPointFilter
+{
+public:
+    quint32 criteria = LAS_FILTER_NONE; //!< bit mask of set criteria (LasPointFilterCriteria)
+    double x0 = 0.0;                    //!< box of not-scaled coordinates
+    double y0 = 0.0;
+    double z0 = 0.0;
+    double x1 = 0.0;
+    double y1 = 0.0;
+    double z1 = 0.0;
+    double gpsTime0 = 0.0;              //!< range of GPS time
+    double gpsTime1 = 0.0;
+    quint8 classification0 = 0;         //!< range of classification
+    quint8 classification1 = 0;
+
+public:
+    LasPointFilter();
+
+    void clear();
+    void setBox(double xMin, double yMin, double xMax, double yMax);
+    void setZRange(double zMin, double zMax);
+    void setGpsTimeRange(double gpsTimeMin, double gpsTimeMax);
+    void setClassificationRange(quint8 classificationMin, quint8 classificationMax);
+
+    quint32 requiredFields();
+    inline bool matches(const LasPoint &lasPoint);
+    bool overlaps(double xMin, double yMin, double zMin, double xMax, double yMax, double zMax,
+                  double gpsTimeMin, double gpsTimeMax, quint8 classificationMin, quint8 classificationMax);
+};
+
+
+/*!
+ * \brief Checks if a point meets all criteria.
+ * \param lasPoint Point with decoded required fields.
+ * \return True, if the point meets the criteria.
+ */
+inline bool LasPointFilter::matches(const LasPoint &lasPoint)
+{
+    if ((this->criteria & LAS_FILTER_XY) && (lasPoint.x < this->x0 || this->x1 < lasPoint.x || lasPoint.y < this->y0 || this->y1 < lasPoint.y))
+        return false;
+    if ((this->criteria & LAS_FILTER_Z) && (lasPoint.z < this->z0 || this->z1 < lasPoint.z))
+        return false;
+    if ((this->criteria & LAS_FILTER_GPS_TIME) && (lasPoint.gpsTime < this->gpsTime0 || this->gpsTime1 < lasPoint.gpsTime))
+        return false;
+    if ((this->criteria & LAS_FILTER_CLASSIFICATION) && (lasPoint.classification < this->classification0 || this->classification1 < lasPoint.classification))
+        return false;
+    return true;
+}
+
+#endif // LASPOINTFILTER_H
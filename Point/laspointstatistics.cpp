@@ -0,0 +1,232 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laspointstatistics.cpp
+ *
+ * \brief The implementation of the LasPointStatistics class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <cstring>
+#include "laspointstatistics.h"
+#include "lascoordinates.h"
+#include "laspointbatch.h"
+
+
+/*!
+ * \brief Default constructor.
+ */
+LasPointStatistics::LasPointStatistics()
+{
+    clear();
+}
+
+
+/*!
+ * \brief Sets statistics of an empty set of points.
+ */
+void LasPointStatistics::clear()
+{
+    this->numberOfPoints = 0;
+    this->ix0 = this->iy0 = this->iz0 = 0;
+    this->ix1 = this->iy1 = this->iz1 = 0;
+    for (int i = 0; i < LAS14_NUMBER_OF_POINTS_BY_RETURN_FIELDS; i++)
+        this->numberOfPointsByReturn[i] = 0;
+}
+
+
+/*!
+ * \brief Adds all points of a batch.
+ * \param batch Batch with scaled coordinates and returns (LAS_FIELD_XYZ, LAS_FIELD_RETURNS).
+ * \remark Columns are reduced by separate loops, which can be vectorised by the compiler.
+ */
+void LasPointStatistics::addBatch(const LasPointBatch &batch)
+{
+    const qint64 n = batch.numberOfPoints;
+    quint64 returnCounts[256];
+    qint32 x0, y0, z0, x1, y1, z1;
+    qint64 i;
+
+    if (n <= 0) return;
+
+    x0 = x1 = batch.ix[0];
+    y0 = y1 = batch.iy[0];
+    z0 = z1 = batch.iz[0];
+    for (i = 1; i < n; i++)
+    {
+        x0 = qMin(x0, batch.ix[i]);
+        x1 = qMax(x1, batch.ix[i]);
+    }
+    for (i = 1; i < n; i++)
+    {
+        y0 = qMin(y0, batch.iy[i]);
+        y1 = qMax(y1, batch.iy[i]);
+    }
+    for (i = 1; i < n; i++)
+    {
+        z0 = qMin(z0, batch.iz[i]);
+        z1 = qMax(z1, batch.iz[i]);
+    }
+
+    if (this->numberOfPoints == 0)
+    {
+        this->ix0 = x0;
+        this->iy0 = y0;
+        this->iz0 = z0;
+        this->ix1 = x1;
+        this->iy1 = y1;
+        this->iz1 = z1;
+    }
+    else
+    {
+        this->ix0 = qMin(this->ix0, x0);
+        this->iy0 = qMin(this->iy0, y0);
+        this->iz0 = qMin(this->iz0, z0);
+        this->ix1 = qMax(this->ix1, x1);
+        this->iy1 = qMax(this->iy1, y1);
+        this->iz1 = qMax(this->iz1, z1);
+    }
+    this->numberOfPoints += quint64(n);
+
+    // histogram of all byte values, invalid return numbers are folded into the last field
+    memset(returnCounts, 0, sizeof(returnCounts));
+    for (i = 0; i < n; i++)
+        returnCounts[batch.returnNumber[i]]++;
+    this->numberOfPointsByReturn[LAS14_NUMBER_OF_POINTS_BY_RETURN_FIELDS - 1] += returnCounts[0];
+    for (i = 1; i < 256; i++)
+    {
+        if (i <= LAS14_NUMBER_OF_POINTS_BY_RETURN_FIELDS)
+            this->numberOfPointsByReturn[i - 1] += returnCounts[i];
+        else
+            this->numberOfPointsByReturn[LAS14_NUMBER_OF_POINTS_BY_RETURN_FIELDS - 1] += returnCounts[i];
+    }
+}
+
+
+/*!
+ * \brief Adds statistics of another set of points.
+ * \param statistics Statistics of points with the same scale and offset.
+ */
+void LasPointStatistics::merge(const LasPointStatistics &statistics)
+{
+    if (statistics.numberOfPoints == 0) return;
+
+    if (this->numberOfPoints == 0)
+    {
+        this->ix0 = statistics.ix0;
+        this->iy0 = statistics.iy0;
+        this->iz0 = statistics.iz0;
+        this->ix1 = statistics.ix1;
+        this->iy1 = statistics.iy1;
+        this->iz1 = statistics.iz1;
+    }
+    else
+    {
+        this->ix0 = qMin(this->ix0, statistics.ix0);
+        this->iy0 = qMin(this->iy0, statistics.iy0);
+        this->iz0 = qMin(this->iz0, statistics.iz0);
+        this->ix1 = qMax(this->ix1, statistics.ix1);
+        this->iy1 = qMax(this->iy1, statistics.iy1);
+        this->iz1 = qMax(this->iz1, statistics.iz1);
+    }
+    this->numberOfPoints += statistics.numberOfPoints;
+
+    for (int i = 0; i < LAS14_NUMBER_OF_POINTS_BY_RETURN_FIELDS; i++)
+        this->numberOfPointsByReturn[i] += statistics.numberOfPointsByReturn[i];
+}
+
+
+/*!
+ * \brief Loads statistics of points stored in a las-file from its header.
+ * \param header Las-file header.
+ * \return False, if header bounds cannot be represented in scaled coordinates
+ *         or the histogram of return numbers does not match the number of points.
+ * \remark Bounds are converted to scaled coordinates.
+ */
+bool LasPointStatistics::fromHeader(const LasFileHeader14 &header)
+{
+    quint64 nPoints = 0;
+
+    clear();
+    this->numberOfPoints = header.number_of_points;
+    if (this->numberOfPoints == 0) return true;
+
+    if (!scaleBounds(header.x0, header.x1, header.scale_x, header.offset_x, this->ix0, this->ix1)) return false;
+    if (!scaleBounds(header.y0, header.y1, header.scale_y, header.offset_y, this->iy0, this->iy1)) return false;
+    if (!scaleBounds(header.z0, header.z1, header.scale_z, header.offset_z, this->iz0, this->iz1)) return false;
+
+    for (int i = 0; i < LAS14_NUMBER_OF_POINTS_BY_RETURN_FIELDS; i++)
+    {
+        this->numberOfPointsByReturn[i] = header.number_of_points_by_return[i];
+        nPoints += header.number_of_points_by_return[i];
+    }
+    return (nPoints == this->numberOfPoints);
+}
+
+
+/*!
+ * \brief Stores bounds and the histogram of return numbers into the las-file header.
+ * \param header Las-file header.
+ * \remark The number of points in the header is not changed. Bounds of an empty set are zero.
+ */
+void LasPointStatistics::toHeader(LasFileHeader14 &header) const
+{
+    double a, b;
+
+    if (this->numberOfPoints == 0)
+    {
+        header.x0 = header.x1 = 0.0;
+        header.y0 = header.y1 = 0.0;
+        header.z0 = header.z1 = 0.0;
+    }
+    else
+    {
+        a = LasCoordinates::unscale(this->ix0, header.scale_x, header.offset_x);
+        b = LasCoordinates::unscale(this->ix1, header.scale_x, header.offset_x);
+        header.x0 = qMin(a, b);
+        header.x1 = qMax(a, b);
+        a = LasCoordinates::unscale(this->iy0, header.scale_y, header.offset_y);
+        b = LasCoordinates::unscale(this->iy1, header.scale_y, header.offset_y);
+        header.y0 = qMin(a, b);
+        header.y1 = qMax(a, b);
+        a = LasCoordinates::unscale(this->iz0, header.scale_z, header.offset_z);
+        b = LasCoordinates::unscale(this->iz1, header.scale_z, header.offset_z);
+        header.z0 = qMin(a, b);
+        header.z1 = qMax(a, b);
+    }
+
+    for (int i = 0; i < LAS14_NUMBER_OF_POINTS_BY_RETURN_FIELDS; i++)
+        header.number_of_points_by_return[i] = this->numberOfPointsByReturn[i];
+}
+
+
+/*!
+ * \brief Converts bounds of a coordinate to scaled coordinates.
+ * \param c0 Min not-scaled coordinate.
+ * \param c1 Max not-scaled coordinate.
+ * \param scale Scale factor.
+ * \param offset Offset.
+ * \param ic0 Returns min scaled coordinate.
+ * \param ic1 Returns max scaled coordinate.
+ * \return False, if bounds are out of the range of scaled coordinates.
+ */
+bool LasPointStatistics::scaleBounds(double c0, double c1, double scale, double offset, qint32 &ic0, qint32 &ic1)
+{
+    double a, b;
+
+    if (scale == 0.0) scale = 1.0;
+    a = (c0 - offset) / scale;
+    b = (c1 - offset) / scale;
+    if (!(-2147483648.0 <= qMin(a, b) && qMax(a, b) <= 2147483647.0)) return false;
+
+    ic0 = LasCoordinates::scale(qMin(c0, c1), scale, offset);
+    ic1 = LasCoordinates::scale(qMax(c0, c1), scale, offset);
+    if (ic1 < ic0) qSwap(ic0, ic1);
+    return true;
+}
@@ -0,0 +1,91 @@
+#ifndef LASPOINTSTATISTICS_H
+#define LASPOINTSTATISTICS_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file laspointstatistics.h
+ *
+ * \brief Statistics of point records stored in the las-file header.
+ * \remark Bounds are tracked in scaled (integer) coordinates,
+ *         so that they are exact regardless of the order of points.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+#include "Fileheader/lasfileheader14.h"
+
+class LasPointBatch;
+
+
+/*!
+ * \brief The LasPointStatistics class.
+ * Bounds and the histogram of return numbers of a set of points.
+ */
+class G3DTLAS_EXPORT LasPointStatistics
+{
+public:
+    quint64 numberOfPoints = 0;     //!< number of points
+    qint32 ix0 = 0;                 //!< min scaled x, valid if numberOfPoints > 0
+    qint32 iy0 = 0;
+    qint32 iz0 = 0;
+    qint32 ix1 = 0;                 //!< max scaled x, valid if numberOfPoints > 0
+    qint32 iy1 = 0;
+    qint32 iz1 = 0;
+    quint64 numberOfPointsByReturn[LAS14_NUMBER_OF_POINTS_BY_RETURN_FIELDS]; //!< invalid return numbers are counted in the last field
+
+public:
+    LasPointStatistics();
+
+    void clear();
+    inline void add(qint32 ix, qint32 iy, qint32 iz, quint8 returnNumber);
+    void addBatch(const LasPointBatch &batch);
+    void merge(const LasPointStatistics &statistics);
+
+    bool fromHeader(const LasFileHeader14 &header);
+    void toHeader(LasFileHeader14 &header) const;
+
+protected:
+    static bool scaleBounds(double c0, double c1, double scale, double offset, qint32 &ic0, qint32 &ic1);
+};
+
+
+/*!
+ * \brief Adds a point.
+ * \param ix Scaled x-coordinate.
+ * \param iy Scaled y-coordinate.
+ * \param iz Scaled z-coordinate.
+ * \param returnNumber Return number.
+ */
+inline void LasPointStatistics::add(qint32 ix, qint32 iy, qint32 iz, quint8 returnNumber)
+{
+    if (this->numberOfPoints == 0)
+    {
+        this->ix0 = this->ix1 = ix;
+        this->iy0 = this->iy1 = iy;
+        this->iz0 = this->iz1 = iz;
+    }
+    else
+    {
+        if (ix < this->ix0) this->ix0 = ix;
+        if (this->ix1 < ix) this->ix1 = ix;
+        if (iy < this->iy0) this->iy0 = iy;
+        if (this->iy1 < iy) this->iy1 = iy;
+        if (iz < this->iz0) this->iz0 = iz;
+        if (this->iz1 < iz) this->iz1 = iz;
+    }
+    this->numberOfPoints++;
+
+    if (0 < returnNumber && returnNumber <= LAS14_NUMBER_OF_POINTS_BY_RETURN_FIELDS)
+        this->numberOfPointsByReturn[returnNumber - 1]++;
+    else
+        this->numberOfPointsByReturn[LAS14_NUMBER_OF_POINTS_BY_RETURN_FIELDS - 1]++;
+}
+
+#endif // LASPOINTSTATISTICS_H
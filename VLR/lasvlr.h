@@ -25,6 +25,7 @@
 
 #include "g3dtlas_global.h"
 #include "lasvlrheader.h"
+#include "lasvlrchunkcodec.h"
 #include "lasvlrgeokeyentry.h"
 #include "lasvlrgeokeys.h"
 #include "lasvlrclassificationlookup.h"
@@ -0,0 +1,45 @@
+#ifndef LASVLRCHUNKCODEC_H
+#define LASVLRCHUNKCODEC_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasvlrchunkcodec.h
+ *
+ * \brief Chunk Codec. VLR of las-files with point records compressed by G3DTLas.
+ *
+ * Chunk Codec
+ * User ID: G3DTLas
+ * Record ID: 1
+ * Marks point records compressed by G3DTLas, the point format in the file header is not changed.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include "g3dtlas_global.h"
+
+#define LAS_VLR_CHUNK_CODEC_USERID "G3DTLas"
+#define LAS_VLR_CHUNK_CODEC_RECORDID (1)
+#define LAS_VLR_CHUNK_CODEC_VERSION (1)
+
+#pragma pack(1)
+
+/*!
+ * \brief Chunk Codec VLR.
+ * \remark size = 12
+ */
+struct LasVLRChunkCodec
+{
+    quint32 version;                    //!< LAS_VLR_CHUNK_CODEC_VERSION
+    quint32 chunkNRecords;              //!< number of point records in a chunk, equal to the chunk table
+    quint32 reserved;                   //!< set to zero
+};
+
+#pragma pack()
+
+#endif // LASVLRCHUNKCODEC_H
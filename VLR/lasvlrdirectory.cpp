@@ -0,0 +1,253 @@
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasvlrdirectory.cpp
+ *
+ * \brief The implementation of the LasVLRDirectory class.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <cstring>
+#include "lasvlrdirectory.h"
+
+
+/*!
+ * \brief Constructor.
+ */
+LasVLRDirectory::LasVLRDirectory()
+{
+}
+
+
+/*!
+ * \brief Removes all records from the directory.
+ */
+void LasVLRDirectory::clear()
+{
+    this->vlrs.clear();
+    this->evlrs.clear();
+    this->vlrKeys.clear();
+    this->evlrKeys.clear();
+}
+
+
+/*!
+ * \brief Reads headers of all VLRs and EVLRs of a las-file.
+ * \param file Open las-file.
+ * \param header File header.
+ * \return True, if all headers were read and all records are stored within the file.
+ * \remark VLRs follow the file header, EVLRs start at offset_evlrs.
+ */
+bool LasVLRDirectory::read(QFile &file, const LasFileHeader14 &header)
+{
+    bool error = false;
+    LasVLRHeader vlrHeader;
+    LasEVLRHeader evlrHeader;
+    qint64 fileSize = file.size();
+    qint64 offset;
+    quint64 i;
+
+    clear();
+
+    offset = header.headerSize;
+    for (i = 0; i < header.number_of_vlrs && !error; i++)
+    {
+        error = (fileSize < offset + qint64(sizeof(LasVLRHeader)) || !file.seek(offset));
+        if (!error) error = (file.read(reinterpret_cast<char*>(&vlrHeader), sizeof(LasVLRHeader)) != sizeof(LasVLRHeader));
+        if (!error) error = (fileSize < offset + qint64(sizeof(LasVLRHeader)) + vlrHeader.recordLength);
+        if (!error)
+        {
+            appendVLR(vlrHeader, offset);
+            offset += sizeof(LasVLRHeader) + vlrHeader.recordLength;
+        }
+    }
+
+    offset = qint64(header.offset_evlrs);
+    for (i = 0; i < header.number_of_evlrs && !error; i++)
+    {
+        error = (offset < 0 || fileSize < offset + qint64(sizeof(LasEVLRHeader)) || !file.seek(offset));
+        if (!error) error = (file.read(reinterpret_cast<char*>(&evlrHeader), sizeof(LasEVLRHeader)) != sizeof(LasEVLRHeader));
+        if (!error) error = (quint64(fileSize - offset) - sizeof(LasEVLRHeader) < evlrHeader.recordLength);
+        if (!error)
+        {
+            appendEVLR(evlrHeader, offset);
+            offset += sizeof(LasEVLRHeader) + evlrHeader.recordLength;
+        }
+    }
+
+    if (error) clear();
+    return !error;
+}
+
+
+/*!
+ * \brief Adds a VLR to the directory.
+ * \param header Header of the VLR.
+ * \param headerOffset Offset of the VLR header in the file.
+ */
+void LasVLRDirectory::appendVLR(const LasVLRHeader &header, qint64 headerOffset)
+{
+    LasVLREntry entry;
+    QString key;
+
+    entry.headerOffset = headerOffset;
+    entry.dataOffset = headerOffset + qint64(sizeof(LasVLRHeader));
+    entry.recordLength = header.recordLength;
+    memcpy(entry.userID, header.userID, LAS_VLR_USERID_LENGTH);
+    entry.recordID = header.recordID;
+    entry.extended = false;
+
+    key = recordKey(entry.userID, entry.recordID);
+    if (!this->vlrKeys.contains(key)) this->vlrKeys.insert(key, this->vlrs.size());
+    this->vlrs.append(entry);
+}
+
+
+/*!
+ * \brief Adds an EVLR to the directory.
+ * \param header Header of the EVLR.
+ * \param headerOffset Offset of the EVLR header in the file.
+ */
+void LasVLRDirectory::appendEVLR(const LasEVLRHeader &header, qint64 headerOffset)
+{
+    LasVLREntry entry;
+    QString key;
+
+    entry.headerOffset = headerOffset;
+    entry.dataOffset = headerOffset + qint64(sizeof(LasEVLRHeader));
+    entry.recordLength = header.recordLength;
+    memcpy(entry.userID, header.userID, LAS_VLR_USERID_LENGTH);
+    entry.recordID = header.recordID;
+    entry.extended = true;
+
+    key = recordKey(entry.userID, entry.recordID);
+    if (!this->evlrKeys.contains(key)) this->evlrKeys.insert(key, this->evlrs.size());
+    this->evlrs.append(entry);
+}
+
+
+/*!
+ * \brief Returns the number of VLRs.
+ * \return Number of VLRs.
+ */
+qint64 LasVLRDirectory::getNumberOfVLRs()
+{
+    return this->vlrs.size();
+}
+
+
+/*!
+ * \brief Returns the number of EVLRs.
+ * \return Number of EVLRs.
+ */
+qint64 LasVLRDirectory::getNumberOfEVLRs()
+{
+    return this->evlrs.size();
+}
+
+
+/*!
+ * \brief Returns a VLR.
+ * \param iVLR Index of the VLR, must be valid.
+ * \return Directory entry of the VLR.
+ */
+const LasVLREntry &LasVLRDirectory::getVLR(qint64 iVLR)
+{
+    return this->vlrs[int(iVLR)];
+}
+
+
+/*!
+ * \brief Returns an EVLR.
+ * \param iEVLR Index of the EVLR, must be valid.
+ * \return Directory entry of the EVLR.
+ */
+const LasVLREntry &LasVLRDirectory::getEVLR(qint64 iEVLR)
+{
+    return this->evlrs[int(iEVLR)];
+}
+
+
+/*!
+ * \brief Returns the offset following the last EVLR.
+ * \param evlrOffset Offset of the first EVLR, used if there are no EVLRs.
+ * \return Offset of the next EVLR.
+ */
+qint64 LasVLRDirectory::getEVLRsEnd(qint64 evlrOffset)
+{
+    if (this->evlrs.isEmpty()) return evlrOffset;
+    const LasVLREntry &entry = this->evlrs[this->evlrs.size() - 1];
+    return entry.dataOffset + qint64(entry.recordLength);
+}
+
+
+/*!
+ * \brief Changes offsets of all EVLRs, after the EVLRs were moved.
+ * \param shift Distance, by which the EVLRs were moved.
+ */
+void LasVLRDirectory::moveEVLRs(qint64 shift)
+{
+    for (int i = 0; i < this->evlrs.size(); i++)
+    {
+        this->evlrs[i].headerOffset += shift;
+        this->evlrs[i].dataOffset += shift;
+    }
+}
+
+
+/*!
+ * \brief Finds a VLR by its user ID and record ID.
+ * \param userID User ID.
+ * \param recordID Record ID.
+ * \return Index of the first matching VLR, -1 if there is no such VLR.
+ */
+qint64 LasVLRDirectory::findVLR(QString userID, quint16 recordID)
+{
+    return this->vlrKeys.value(recordKey(userID, recordID), -1);
+}
+
+
+/*!
+ * \brief Finds an EVLR by its user ID and record ID.
+ * \param userID User ID.
+ * \param recordID Record ID.
+ * \return Index of the first matching EVLR, -1 if there is no such EVLR.
+ */
+qint64 LasVLRDirectory::findEVLR(QString userID, quint16 recordID)
+{
+    return this->evlrKeys.value(recordKey(userID, recordID), -1);
+}
+
+
+/*!
+ * \brief Returns the lookup key of a record.
+ * \param userID User ID field of a record header, padded by zeros.
+ * \param recordID Record ID.
+ * \return Key of the record.
+ */
+QString LasVLRDirectory::recordKey(const char *userID, quint16 recordID)
+{
+    int n = 0;
+
+    while (n < LAS_VLR_USERID_LENGTH && userID[n] != 0) n++;
+    return recordKey(QString::fromLocal8Bit(userID, n), recordID);
+}
+
+
+/*!
+ * \brief Returns the lookup key of a record.
+ * \param userID User ID.
+ * \param recordID Record ID.
+ * \return Key of the record.
+ * \remark The record ID follows the last separator, keys of different records are always different.
+ */
+QString LasVLRDirectory::recordKey(QString userID, quint16 recordID)
+{
+    return userID.trimmed() + "/" + QString::number(recordID);
+}
@@ -0,0 +1,81 @@
+#ifndef LASVLRDIRECTORY_H
+#define LASVLRDIRECTORY_H
+
+/*!
+ * *****************************************************************
+ *                               G3DTLas
+ * *****************************************************************
+ * \file lasvlrdirectory.h
+ *
+ * \brief Directory of VLRs and EVLRs of a las-file.
+ * \remark Headers of all records are read once when the las-file is opened,
+ *         records are found by index or by user ID and record ID without reading the file.
+ *
+ * \author M. Koren, milan.koren3@gmail.com
+ * Source: https:\\github.com/milan-koren/G3DTLas
+ * Licence: EUPL v. 1.2
+ * https://joinup.ec.europa.eu/collection/eupl
+ * *****************************************************************
+ */
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include "g3dtlas_global.h"
+#include "Fileheader/lasfileheader14.h"
+#include "VLR/lasvlrheader.h"
+#include "EVLR/lasevlr.h"
+
+
+/*!
+ * \brief Location and identification of a VLR or an EVLR in the las-file.
+ */
+struct LasVLREntry
+{
+    qint64 headerOffset;                    //!< offset of the record header in the file
+    qint64 dataOffset;                      //!< offset of the record data in the file
+    quint64 recordLength;                   //!< size of data after the record header
+    char userID[LAS_VLR_USERID_LENGTH];     //!< user ID of the record
+    quint16 recordID;                       //!< record ID of the record
+    bool extended;                          //!< true, if the record is an EVLR
+};
+
+
+/*!
+ * \brief The LasVLRDirectory class.
+ * In-memory directory of VLRs and EVLRs with the lookup by index and by (user ID, record ID).
+ */
+class G3DTLAS_EXPORT LasVLRDirectory
+{
+protected:
+    QVector<LasVLREntry> vlrs;          //!< VLRs in the order of the file
+    QVector<LasVLREntry> evlrs;         //!< EVLRs in the order of the file
+    QHash<QString, qint64> vlrKeys;     //!< index of the first VLR of a (user ID, record ID) key
+    QHash<QString, qint64> evlrKeys;    //!< index of the first EVLR of a (user ID, record ID) key
+
+public:
+    LasVLRDirectory();
+
+    void clear();
+    bool read(QFile &file, const LasFileHeader14 &header);
+
+    void appendVLR(const LasVLRHeader &header, qint64 headerOffset);
+    void appendEVLR(const LasEVLRHeader &header, qint64 headerOffset);
+
+    qint64 getNumberOfVLRs();
+    qint64 getNumberOfEVLRs();
+    const LasVLREntry &getVLR(qint64 iVLR);
+    const LasVLREntry &getEVLR(qint64 iEVLR);
+    qint64 getEVLRsEnd(qint64 evlrOffset);
+    void moveEVLRs(qint64 shift);
+
+    qint64 findVLR(QString userID, quint16 recordID);
+    qint64 findEVLR(QString userID, quint16 recordID);
+
+protected:
+    static QString recordKey(const char *userID, quint16 recordID);
+    static QString recordKey(QString userID, quint16 recordID);
+};
+
+#endif // LASVLRDIRECTORY_H
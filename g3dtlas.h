@@ -18,7 +18,37 @@
 
 #include "lasdatatypes.h"
 #include "Point/laspoint.h"
+#include "Point/laspointbatch.h"
+#include "Point/laspointcodec.h"
+#include "Point/laspointfilter.h"
+#include "Point/laspointstatistics.h"
+#include "Point/lascoordinates.h"
+#include "IO/laschunkcodec.h"
+#include "IO/laschunkdecoder.h"
+#include "IO/laschunkencoder.h"
+#include "IO/laschunkpipeline.h"
+#include "IO/laschunkscheduler.h"
+#include "IO/laschunktable.h"
+#include "IO/laschunktableheader.h"
+#include "IO/lascompressedchunk.h"
+#include "IO/lascopytask.h"
+#include "IO/lasfilereader.h"
+#include "IO/laspagecache.h"
+#include "IO/lasreadahead.h"
+#include "IO/lasscantask.h"
+#include "IO/laswaveformreader.h"
+#include "IO/laswritebehind.h"
+#include "Index/lasfilestamp.h"
+#include "Index/laspointinterval.h"
+#include "Index/lasspatialindexheader.h"
+#include "Index/lasspatialindex.h"
+#include "Index/lasspacefillingcurve.h"
+#include "Index/lasspatialsort.h"
+#include "Index/laszone.h"
+#include "Index/laszonemapheader.h"
+#include "Index/laszonemap.h"
 #include "VLR/lasvlr.h"
+#include "VLR/lasvlrdirectory.h"
 #include "EVLR/lasevlr.h"
 #include "Fileheader/lasfileheader14.h"
 #include "lasfile.h"
@@ -14,7 +14,15 @@
  * *****************************************************************
  */
 
+#include <cstddef>
+#include <QFileInfo>
+#include <QThreadPool>
 #include "lasfile.h"
+#include "IO/laschunkscheduler.h"
+#include "Index/lasspatialindex.h"
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
 
 
 const quint16 LasFile::StandardPointRecordLength[LAS_NUMBER_OF_POINT_RECORD_DATA_FORMATS ] =
@@ -24,19 +32,14 @@ const quint16 LasFile::StandardPointRecordLength[LAS_NUMBER_OF_POINT_RECORD_DATA
       sizeof(LasPoint9), sizeof(LasPoint10)
     };
 
-const LasFile::FPointFromBufferFunction LasFile::PointFromBufferFunctions[LAS_NUMBER_OF_POINT_RECORD_DATA_FORMATS ] =
-    { LasFile::decodePoint0, LasFile::decodePoint1, LasFile::decodePoint2,
-      LasFile::decodePoint3, LasFile::decodePoint4, LasFile::decodePoint5,
-      LasFile::decodePoint6, LasFile::decodePoint7, LasFile::decodePoint8,
-      LasFile::decodePoint9, LasFile::decodePoint10
-    };
+const qint8 LasFile::GpsTimeOffset[LAS_NUMBER_OF_POINT_RECORD_DATA_FORMATS ] =
+    { -1, 20, -1, 20, 20, 20, 22, 22, 22, 22, 22 };
 
-const LasFile::FPointToBufferFunction LasFile::PointToBufferFunctions[LAS_NUMBER_OF_POINT_RECORD_DATA_FORMATS ] =
-    { LasFile::encodePoint0, LasFile::encodePoint1, LasFile::encodePoint2,
-      LasFile::encodePoint3, LasFile::encodePoint4, LasFile::encodePoint5,
-      LasFile::encodePoint6, LasFile::encodePoint7, LasFile::encodePoint8,
-      LasFile::encodePoint9, LasFile::encodePoint10
-    };
+const qint8 LasFile::ColorOffset[LAS_NUMBER_OF_POINT_RECORD_DATA_FORMATS ] =
+    { -1, -1, 20, 28, -1, 28, -1, 30, 30, -1, 30 };
+
+const qint8 LasFile::NirOffset[LAS_NUMBER_OF_POINT_RECORD_DATA_FORMATS ] =
+    { -1, -1, -1, -1, -1, -1, -1, -1, 36, -1, 36 };
 
 
 /*!
@@ -59,26 +62,54 @@ LasFile::~LasFile()
 /*!
  * \brief Opens las-file for reading.
  * \param fileName Input las-file name.
+ * \param pointcache_number_of_records Number of records in the cache of appended points and in all pages of the point cache.
+ * \param accessMode Access mode to point data. If the file cannot be mapped or read ahead, points are read through the point cache.
+ * \param pointCacheNPages Number of pages the point cache is split into, pages are evicted in LRU order.
  * \return If las-file was successfully open, returns true.
- */
-bool LasFile::open(QString fileName, qint64 pointcache_number_of_records, qint64 pointcache_offset)
+ * \remark Pages are aligned to multiples of the page size.
+ * \remark In LAS_ACCESS_MAPPED and LAS_ACCESS_CONCURRENT modes pages of the point cache are allocated only if the file cannot be mapped,
+ *         points appended after mapping are read directly from the file.
+ * \remark LAS_ACCESS_CONCURRENT opens the file read-only for LasFileReader objects of several threads.
+ * \remark Compressed point data are read through the point cache, chunks are pages of the cache.
+ *         In LAS_ACCESS_READ_AHEAD mode following chunks are decompressed by worker threads.
+ *         Points can be appended to a compressed file only if it is empty.
+ * \remark EVLRs left in the spill file by a crash or a failed close are recovered and written back on close,
+ *         a file with such EVLRs is not opened in LAS_ACCESS_CONCURRENT mode, see getEVLRSpillFileName.
+ *         While another session holds detached EVLRs, the file is opened without them.
+ */
+bool LasFile::open(QString fileName, qint64 pointcache_number_of_records, LasFileAccessMode accessMode, int pointCacheNPages)
 {
     bool error = true;
 
     close();
+    this->evlrSpill.setFileName(QString());
+    this->waveformSourceFileName = QFileInfo(fileName).absoluteFilePath();
     this->dataFile.setFileName(fileName);
-    if (this->dataFile.open(QFile::ReadWrite))
+    if (this->dataFile.open(accessMode == LAS_ACCESS_CONCURRENT ? QFile::ReadOnly : QFile::ReadWrite))
         if (this->dataFileHeader.read(dataFile))
         {
-            if (this->dataFileHeader.point_format <= 10)
-            {
-                this->pointToBufFn = PointToBufferFunctions[this->dataFileHeader.point_format];
-                this->pointFromBufFn = PointFromBufferFunctions[this->dataFileHeader.point_format];
-                error = false;
-            }
+            // LAZ files are not supported
+            if (!(this->dataFileHeader.point_format & LAS_LAZ_FORMAT_MASK) && this->dataFileHeader.point_format <= 10) error = false;
+            this->pointStatisticsTracked = this->pointStatistics.fromHeader(this->dataFileHeader);
+        }
+
+    if (!error) error = !this->vlrDirectory.read(this->dataFile, this->dataFileHeader);
+    if (!error) error = !readChunkCodecVLR();
+    if (!error) error = !recoverEVLRs();
+    if (!error)
+    {
+        this->zoneMapTracked = this->zoneMap.read(LasZoneMap::zoneMapFileName(fileName)) && this->zoneMap.isCompatible(*this);
+        if (!this->zoneMapTracked)
+        {
+            this->zoneMap.clear();
+            this->zoneMapTracked = (this->dataFileHeader.number_of_points == 0);
         }
+    }
 
-    if (!error) error = !allocatePointCache(pointcache_number_of_records, pointcache_offset);
+    if (!error && (accessMode == LAS_ACCESS_MAPPED || accessMode == LAS_ACCESS_CONCURRENT)) mapPointData();
+    if (!error) error = !allocatePointCache(pointcache_number_of_records, pointCacheNPages);
+    if (!error && accessMode == LAS_ACCESS_READ_AHEAD) startReadAhead();
+    if (!error && accessMode == LAS_ACCESS_WRITE_BEHIND) startWriteBehind();
 
     if (error) close();
     return !error;
@@ -89,29 +120,59 @@ bool LasFile::open(QString fileName, qint64 pointcache_number_of_records, qint64
  * \brief Closes las-file and releases allocated resources.
  * \return If las-file was successfully closed, returns true.
  * \remark Input stream is always closed.
+ * \remark If EVLRs moved into the spill file were not written back, the spill file is kept, see getEVLRSpillFileName.
  */
 bool LasFile::close()
 {
     bool error;
 
+    stopReadAhead();
     error = !writePointCache();
+    if (!stopWriteBehind()) error = true;
+    if (!error) error = !writeChunkTable();
+    if (!error) error = !attachEVLRs();
     if (!error) error = !updateHeader();
     if (!error) error = !writeHeader();
+    if (!error && this->dataFile.isOpen() && this->dataFile.isWritable()) error = !this->dataFile.flush();
 
     if (this->cacheData != nullptr)
     {
         delete [] this->cacheData;
         this->cacheData = nullptr;
     }
+    if (this->recordData != nullptr)
+    {
+        delete [] this->recordData;
+        this->recordData = nullptr;
+    }
 
     this->cacheFirstRecord = -1;
     this->cacheLastRecord = -1;
     this->cacheNumberOfRecords = 0;
     this->cacheLength = 0;
-    this->cacheOffset = 0;
+    this->pageCache.release();
+
+    // EVLRs are kept in the spill file, if they were not written back
+    if (this->evlrSpill.isOpen()) this->evlrSpill.close();
+    if (!error && !this->evlrSpill.fileName().isEmpty())
+    {
+        QFile::remove(this->evlrSpill.fileName());
+        this->evlrSpill.setFileName(QString());
+    }
+    unlockEVLRSpill();
 
+    // the zone map is stamped by the las-file after its last change
+    unmapPointData();
+    if (!error && this->zoneMapChanged) error = !writeZoneMap();
+    this->zoneMapChanged = false;
     if (this->dataFile.isOpen()) this->dataFile.close();
     this->dataFileHeader.setNull();
+    this->zoneMap.clear();
+    this->zoneMapTracked = false;
+    this->spatialIndexRemoved = false;
+    this->compression = LAS_COMPRESSION_NONE;
+    this->chunkTable.clear();
+    this->vlrDirectory.clear();
 
     return !error;
 }
@@ -121,25 +182,92 @@ bool LasFile::close()
  * \brief Checks if las-file is open.
  * \return True, if las-file is open.
  */
-inline bool LasFile::isOpen()
+bool LasFile::isOpen()
 {
     return this->dataFile.isOpen();
 }
 
 
+/*!
+ * \brief Checks if point data are memory-mapped.
+ * \return True, if points are decoded directly from the mapped las-file.
+ */
+bool LasFile::isMapped()
+{
+    return (this->mappedData != nullptr);
+}
+
+
+/*!
+ * \brief Checks, if point cache windows are read by a background thread or compressed chunks are decompressed ahead.
+ * \return True, if the file is open in read-ahead mode and no points were appended.
+ */
+bool LasFile::isReadingAhead()
+{
+    return ((this->readAhead != nullptr || this->chunkDecoder != nullptr) && !this->pointsChanged);
+}
+
+
+/*!
+ * \brief Checks if point records are stored in compressed chunks.
+ * \return True, if point data are compressed.
+ */
+bool LasFile::isCompressed()
+{
+    return (this->compression != LAS_COMPRESSION_NONE);
+}
+
+
+/*!
+ * \brief Returns the number of point reads served from cached pages.
+ * \return Number of cache hits.
+ */
+quint64 LasFile::getPointCacheHits()
+{
+    return this->pageCache.getHits();
+}
+
+
+/*!
+ * \brief Returns the number of pages read into the point cache.
+ * \return Number of cache misses.
+ */
+quint64 LasFile::getPointCacheMisses()
+{
+    return this->pageCache.getMisses();
+}
+
+
+/*!
+ * \brief Sets point cache hit and miss counters to zero.
+ */
+void LasFile::resetPointCacheCounters()
+{
+    this->pageCache.resetCounters();
+}
+
+
 /*!
  * \brief Creates a new las-file 1.4 compatible with a given template.
  * \param fileName New las-file name.
  * \param lasTemplate Las-file template, open for reading.
+ * \param accessMode Access mode to point data, LAS_ACCESS_WRITE_BEHIND writes appended points in a background thread.
+ * \param pointCacheNPages Number of pages the point cache is split into.
+ * \param pointCompression Storage of point records, LAS_COMPRESSION_CHUNKED compresses chunks of appended points.
  * \return True, if compatible las-file was created successfuly.
+ * \remark Chunks of a compressed file are always compressed by worker threads and written by a background writer.
+ * \remark EVLRs of the template are copied into the spill file and written behind the point data on close.
  */
-bool LasFile::createCompatible(QString fileName, LasFile &lasTemplate, qint64 pointcache_number_of_records, qint64 pointcache_offset)
+bool LasFile::createCompatible(QString fileName, LasFile &lasTemplate, qint64 pointcache_number_of_records, LasFileAccessMode accessMode, int pointCacheNPages, LasPointCompression pointCompression)
 {
     bool error = true;
     QDate dt;
 
     close();
+    this->evlrSpill.setFileName(QString());
+    this->waveformSourceFileName = QFileInfo(lasTemplate.getFileName()).absoluteFilePath();
     QFile::remove(fileName);
+    QFile::remove(fileName + LAS_EVLR_SPILL_EXTENSION);
     if (!lasTemplate.isOpen()) return false;
 
     this->dataFile.setFileName(fileName);
@@ -158,11 +286,6 @@ bool LasFile::createCompatible(QString fileName, LasFile &lasTemplate, qint64 po
         this->dataFileHeader.offset_to_point_data = sizeof(LasFileHeader14);
         this->dataFileHeader.number_of_evlrs = 0;
         this->dataFileHeader.point_format = lasTemplate.dataFileHeader.point_format;
-        if (this->dataFileHeader.point_format <= 10)
-        {
-            this->pointToBufFn = PointToBufferFunctions[this->dataFileHeader.point_format];
-            this->pointFromBufFn = PointFromBufferFunctions[this->dataFileHeader.point_format];
-        }
         this->dataFileHeader.point_record_length = lasTemplate.dataFileHeader.point_record_length;
         this->dataFileHeader.scale_x = lasTemplate.dataFileHeader.scale_x;
         this->dataFileHeader.scale_y = lasTemplate.dataFileHeader.scale_y;
@@ -170,24 +293,55 @@ bool LasFile::createCompatible(QString fileName, LasFile &lasTemplate, qint64 po
         this->dataFileHeader.offset_x = lasTemplate.dataFileHeader.offset_x;
         this->dataFileHeader.offset_y = lasTemplate.dataFileHeader.offset_y;
         this->dataFileHeader.offset_z = lasTemplate.dataFileHeader.offset_z;
+        this->pointStatistics.clear();
+        this->pointStatisticsTracked = true;
+        this->zoneMap.clear();
+        this->zoneMapTracked = true;
+        this->compression = pointCompression;
+        this->chunkTable.clear();
 
         this->headerChanged = true;
         error = (!writeHeader()); // write partial las-file header
         if (!error) error = (!copyVRLs(lasTemplate));
+        if (!error && isCompressed()) error = (!appendChunkCodecVLR());
+        if (!error) error = (!copyEVRLs(lasTemplate));
     }
 
-    if (!error) error = !allocatePointCache(pointcache_number_of_records, pointcache_offset);
+    if (!error) error = !allocatePointCache(pointcache_number_of_records, pointCacheNPages);
+    if (!error && (accessMode == LAS_ACCESS_WRITE_BEHIND || isCompressed())) startWriteBehind();
     if (error) close();
 
     return !error;
 }
 
 
+/*!
+ * \brief Opens las-file for reading.
+ * \deprecated The offset of the point cache is not used, use open without pointcache_offset.
+ */
+bool LasFile::open(QString fileName, qint64 pointcache_number_of_records, qint64 pointcache_offset, LasFileAccessMode accessMode, int pointCacheNPages)
+{
+    Q_UNUSED(pointcache_offset);
+    return open(fileName, pointcache_number_of_records, accessMode, pointCacheNPages);
+}
+
+
+/*!
+ * \brief Creates a new las-file 1.4 compatible with a given template.
+ * \deprecated The offset of the point cache is not used, use createCompatible without pointcache_offset.
+ */
+bool LasFile::createCompatible(QString fileName, LasFile &lasTemplate, qint64 pointcache_number_of_records, qint64 pointcache_offset, LasFileAccessMode accessMode, int pointCacheNPages, LasPointCompression pointCompression)
+{
+    Q_UNUSED(pointcache_offset);
+    return createCompatible(fileName, lasTemplate, pointcache_number_of_records, accessMode, pointCacheNPages, pointCompression);
+}
+
+
 /*!
  * \brief Standard file signature.
  * \return Las-file signature string ("LASF").
  */
-inline QString LasFile::getFileSignature()
+QString LasFile::getFileSignature()
 {
     return this->dataFileHeader.getFileSignature();
 }
@@ -198,7 +352,7 @@ inline QString LasFile::getFileSignature()
  * \return Major verion of las-file.
  * \remark Inline function.
  */
-inline quint8 LasFile::getMajorVersion()
+quint8 LasFile::getMajorVersion()
 {
     return this->dataFileHeader.versionMajor;
 }
@@ -209,7 +363,7 @@ inline quint8 LasFile::getMajorVersion()
  * \return Minor verion of las-file.
  * \remark Inline function.
  */
-inline quint8 LasFile::getMinorVersion()
+quint8 LasFile::getMinorVersion()
 {
     return this->dataFileHeader.versionMinor;
 }
@@ -230,7 +384,7 @@ QString LasFile::getFileVersion()
  * \return Identification of hardware or process used to generate point cloud.
  * \value scanner name; MERGE; MODIFICATION; EXTRACTION; TRANSFORMATION; OTHER
  */
-inline QString LasFile::getSystemID()
+QString LasFile::getSystemID()
 {
     return this->dataFileHeader.getSystemID();
 }
@@ -240,7 +394,7 @@ inline QString LasFile::getSystemID()
  * \brief Generating software.
  * \return Name of generating software.
  */
-inline QString LasFile::getGeneratingSoftware()
+QString LasFile::getGeneratingSoftware()
 {
     return this->dataFileHeader.getGeneratingSoftware();
 }
@@ -250,7 +404,7 @@ inline QString LasFile::getGeneratingSoftware()
  * \brief Day-of-year of file creation.
  * \return LAS-file creation day of the year (DOY).
  */
-inline quint16 LasFile::getCreationDOY()
+quint16 LasFile::getCreationDOY()
 {
     return this->dataFileHeader.creationDayOfYear;
 }
@@ -260,7 +414,7 @@ inline quint16 LasFile::getCreationDOY()
  * \brief Year of file creation.
  * \return Year of the las-file creation.
  */
-inline quint16 LasFile::getCreationYear()
+quint16 LasFile::getCreationYear()
 {
     return this->dataFileHeader.creationYear;
 }
@@ -287,7 +441,7 @@ QString LasFile::getCreationDate()
  * \brief Header size in bytes.
  * \return Size of the las-file this->header.
  */
-inline quint16 LasFile::getHeaderSize()
+quint16 LasFile::getHeaderSize()
 {
     return this->dataFileHeader.headerSize;
 }
@@ -297,7 +451,7 @@ inline quint16 LasFile::getHeaderSize()
  * \brief Offset to point data in bytes.
  * \return Offset to point data from the las-file beginning.
  */
-inline quint32 LasFile::getOffsetToPointData()
+quint32 LasFile::getOffsetToPointData()
 {
     return this->dataFileHeader.offset_to_point_data;
 }
@@ -307,7 +461,7 @@ inline quint32 LasFile::getOffsetToPointData()
  * \brief Number of VLRs.
  * \return Number of variable length records (VLR).
  */
-inline quint32 LasFile::getNumberOfVLRs()
+quint32 LasFile::getNumberOfVLRs()
 {
     return this->dataFileHeader.number_of_vlrs;
 }
@@ -317,7 +471,7 @@ inline quint32 LasFile::getNumberOfVLRs()
  * \brief Number of EVLRs.
  * \return Number of extended variable length records (EVLR).
  */
-inline quint32 LasFile::getNumberOfEVLRs()
+quint32 LasFile::getNumberOfEVLRs()
 {
     return this->dataFileHeader.number_of_evlrs;
 }
@@ -327,7 +481,7 @@ inline quint32 LasFile::getNumberOfEVLRs()
  * \brief The code of point format.
  * \return Format of points in las-file (0-10 form LAS 1.4).
  */
-inline quint8 LasFile::getPointFormat()
+quint8 LasFile::getPointFormat()
 {
     return this->dataFileHeader.point_format;
 }
@@ -337,7 +491,7 @@ inline quint8 LasFile::getPointFormat()
  * \brief The length of point record in bytes.
  * \return Point record length in the file.
  */
-inline quint16 LasFile::getPointRecordLength()
+quint16 LasFile::getPointRecordLength()
 {
     return this->dataFileHeader.point_record_length;
 }
@@ -347,7 +501,7 @@ inline quint16 LasFile::getPointRecordLength()
  * \brief The standard length of point record in bytes.
  * \return Record length of point defined by standard (may be shorter than actual point record length in the file).
  */
-inline quint16 LasFile::getStandardPointRecordLength()
+quint16 LasFile::getStandardPointRecordLength()
 {
     return LasFile::StandardPointRecordLength[this->dataFileHeader.point_format];
 }
@@ -357,7 +511,7 @@ inline quint16 LasFile::getStandardPointRecordLength()
  * \brief The number of points in the las-file.
  * \return Number of points stored in the las-file.
  */
-inline quint64 LasFile::getNumberOfPoints()
+quint64 LasFile::getNumberOfPoints()
 {
     return this->dataFileHeader.number_of_points;
 }
@@ -367,7 +521,7 @@ inline quint64 LasFile::getNumberOfPoints()
  * \brief The number of point by return fields.
  * \return Number of fields used to store the number of points by returns.
  */
-inline quint32 LasFile::getNumberOfPointByReturnFields()
+quint32 LasFile::getNumberOfPointByReturnFields()
 {
     return LAS14_NUMBER_OF_POINTS_BY_RETURN_FIELDS;
 }
@@ -390,7 +544,7 @@ quint64 LasFile::getPointsByReturn(qint64 n)
  * \brief Returns minimum x-coordinate.
  * \return Minimum x-coordinate.
  */
-inline double LasFile::getX0()
+double LasFile::getX0()
 {
     return this->dataFileHeader.x0;
 }
@@ -400,7 +554,7 @@ inline double LasFile::getX0()
  * \brief Returns minimum y-coordinate.
  * \return Minimum y-coordinate.
  */
-inline double LasFile::getY0()
+double LasFile::getY0()
 {
     return this->dataFileHeader.y0;
 }
@@ -409,7 +563,7 @@ inline double LasFile::getY0()
  * \brief Returns minimum z-coordinate.
  * \return Minimum z-coordinate.
  */
-inline double LasFile::getZ0()
+double LasFile::getZ0()
 {
     return this->dataFileHeader.z0;
 }
@@ -418,7 +572,7 @@ inline double LasFile::getZ0()
  * \brief Returns maximum x-coordinate.
  * \return Maximum x-coordinate.
  */
-inline double LasFile::getX1()
+double LasFile::getX1()
 {
     return this->dataFileHeader.x1;
 }
@@ -427,7 +581,7 @@ inline double LasFile::getX1()
  * \brief Returns maximum y-coordinate.
  * \return Maximum y-coordinate.
  */
-inline double LasFile::getY1()
+double LasFile::getY1()
 {
     return this->dataFileHeader.y1;
 }
@@ -436,14 +590,85 @@ inline double LasFile::getY1()
  * \brief Returns maximum z-coordinate.
  * \return Maximum z-coordinates.
  */
-inline double LasFile::getZ1()
+double LasFile::getZ1()
 {
     return this->dataFileHeader.z1;
 }
 
+/*!
+ * \brief Returns the scale factor of x-coordinates.
+ * \return Scale factor.
+ */
+double LasFile::getScaleX()
+{
+    return this->dataFileHeader.scale_x;
+}
+
+
+/*!
+ * \brief Returns the offset of x-coordinates.
+ * \return Offset.
+ */
+double LasFile::getOffsetX()
+{
+    return this->dataFileHeader.offset_x;
+}
+
+
+/*!
+ * \brief Returns the scale factor of y-coordinates.
+ * \return Scale factor.
+ */
+double LasFile::getScaleY()
+{
+    return this->dataFileHeader.scale_y;
+}
+
+
+/*!
+ * \brief Returns the offset of y-coordinates.
+ * \return Offset.
+ */
+double LasFile::getOffsetY()
+{
+    return this->dataFileHeader.offset_y;
+}
+
+
+/*!
+ * \brief Returns the scale factor of z-coordinates.
+ * \return Scale factor.
+ */
+double LasFile::getScaleZ()
+{
+    return this->dataFileHeader.scale_z;
+}
+
+
+/*!
+ * \brief Returns the offset of z-coordinates.
+ * \return Offset.
+ */
+double LasFile::getOffsetZ()
+{
+    return this->dataFileHeader.offset_z;
+}
+
+
+/*!
+ * \brief Returns the name of the las-file.
+ * \return File name.
+ */
+QString LasFile::getFileName()
+{
+    return this->dataFile.fileName();
+}
+
+
 /*!
  * \brief Waveform flag.
  * \return True, if wafe-form is included in the las-file.
+ * \sa LasWaveformReader
  */
 bool LasFile::hasWaveform()
 {
@@ -451,42 +676,227 @@ bool LasFile::hasWaveform()
 }
 
 
+/*!
+ * \brief Builds the zone map from all point records and writes it to the sidecar file.
+ * \param chunkNRecords Number of point records in a chunk.
+ * \return True, if the zone map was built and written successfully.
+ * \remark Zone maps of files written by this library are maintained automatically,
+ *         the zone map must be built only for files written by other software.
+ */
+bool LasFile::buildZoneMap(quint32 chunkNRecords)
+{
+    bool error = false;
+
+    if (!this->dataFile.isOpen()) return false;
+
+    error = !writePointCache();
+    if (!error) error = !this->zoneMap.build(*this, chunkNRecords);
+    this->zoneMapTracked = !error;
+    if (!error) error = !writeZoneMap();
+    this->zoneMapChanged = true;
+
+    return !error;
+}
+
+
+/*!
+ * \brief Checks if the zone map covers all point records.
+ * \return True, if chunks of point records can be skipped by filtered scans.
+ */
+bool LasFile::hasZoneMap()
+{
+    return (this->zoneMapTracked && this->zoneMap.getNumberOfPoints() == this->dataFileHeader.number_of_points);
+}
+
+
 /*!
  * \brief Reads a VLR record.
  * \param iVLR VLR record index.
  * \param vlr Target CVLR object.
  * \return True, if VLR was successfuly read.
+ * \remark The record is located by the VLR directory, its header and data are read by one read.
  */
 bool LasFile::readVLR(qint64 iVLR, LasVLR &vlr)
 {
-    bool error = false;
-    qint64 vlrOffset;
-    qint64 i;
+    bool error;
+    char *buf;
+    qint64 nLength;
 
     vlr.destroy();
-    if (iVLR < 0 || this->dataFileHeader.number_of_vlrs <= iVLR) return false;
+    if (iVLR < 0 || this->vlrDirectory.getNumberOfVLRs() <= iVLR) return false;
 
-    vlrOffset = this->dataFileHeader.headerSize - sizeof(LasVLRHeader);
-    i = -1;
-    while (i < iVLR && !error)
+    const LasVLREntry &entry = this->vlrDirectory.getVLR(iVLR);
+    nLength = qint64(sizeof(LasVLRHeader) + entry.recordLength);
+    buf = new char[size_t(nLength)];
+    error = !this->dataFile.seek(entry.headerOffset);
+    if (!error) error = (this->dataFile.read(buf, nLength) != nLength);
+    if (!error)
     {
-        vlrOffset += vlr.header.recordLength + sizeof(LasVLRHeader);
-        error = !this->dataFile.seek(vlrOffset);
-        if (!error)
-            error = (this->dataFile.read(reinterpret_cast<char*>(&vlr), sizeof(LasVLRHeader)) != sizeof(LasVLRHeader));
-        i++;
+        memcpy(reinterpret_cast<char*>(&vlr.header), buf, sizeof(LasVLRHeader));
+        vlr.data = new char[vlr.header.recordLength];
+        memcpy(vlr.data, buf + sizeof(LasVLRHeader), vlr.header.recordLength);
     }
+    delete[] buf;
+
+    return !error;
+}
+
+
+/*!
+ * \brief Finds a VLR by its user ID and record ID.
+ * \param userID User ID.
+ * \param recordID Record ID.
+ * \return Index of the first matching VLR, -1 if the file contains no such VLR.
+ * \remark The file is not read.
+ */
+qint64 LasFile::findVLR(QString userID, quint16 recordID)
+{
+    return this->vlrDirectory.findVLR(userID, recordID);
+}
+
+
+/*!
+ * \brief Finds an EVLR by its user ID and record ID.
+ * \param userID User ID.
+ * \param recordID Record ID.
+ * \return Index of the first matching EVLR, -1 if the file contains no such EVLR.
+ * \remark The file is not read.
+ */
+qint64 LasFile::findEVLR(QString userID, quint16 recordID)
+{
+    return this->vlrDirectory.findEVLR(userID, recordID);
+}
+
+
+/*!
+ * \brief Returns the directory of VLRs and EVLRs.
+ * \return Offsets, lengths and identification of all VLRs and EVLRs of the open file.
+ */
+LasVLRDirectory &LasFile::getVLRDirectory()
+{
+    return this->vlrDirectory;
+}
+
+/*!
+ * \brief Reads the header of an EVLR.
+ * \param iEVLR EVLR index.
+ * \param header Returns the EVLR header.
+ * \return True, if the header was read successfully.
+ */
+bool LasFile::readEVLR(qint64 iEVLR, LasEVLRHeader &header)
+{
+    QFile &file = (this->evlrSpill.isOpen() ? this->evlrSpill : this->dataFile);
+    bool error;
+
+    memset(&header, 0, sizeof(LasEVLRHeader));
+    if (iEVLR < 0 || this->vlrDirectory.getNumberOfEVLRs() <= iEVLR) return false;
+
+    error = !file.seek(this->vlrDirectory.getEVLR(iEVLR).headerOffset);
+    if (!error) error = (file.read(reinterpret_cast<char*>(&header), sizeof(LasEVLRHeader)) != sizeof(LasEVLRHeader));
+    return !error;
+}
+
+
+/*!
+ * \brief Reads a part of EVLR data.
+ * \param iEVLR EVLR index.
+ * \param dataOffset Offset of the first byte read from the EVLR data.
+ * \param buf Buffer of nBytes bytes.
+ * \param nBytes Number of bytes, the part must be within the EVLR data.
+ * \return True, if data were read successfully.
+ * \remark Large EVLRs are read in parts. Thread-safe, if the file is not written.
+ */
+bool LasFile::readEVLRData(qint64 iEVLR, quint64 dataOffset, char *buf, qint64 nBytes)
+{
+    bool error;
+
+    if (iEVLR < 0 || this->vlrDirectory.getNumberOfEVLRs() <= iEVLR || nBytes < 0) return false;
+
+    const LasVLREntry &entry = this->vlrDirectory.getEVLR(iEVLR);
+    if (entry.recordLength < dataOffset || entry.recordLength - dataOffset < quint64(nBytes)) return false;
+
+    if (!this->evlrSpill.isOpen()) return readAt(entry.dataOffset + qint64(dataOffset), buf, nBytes);
 
-    if (!error && i == iVLR)
+    error = !this->evlrSpill.seek(entry.dataOffset + qint64(dataOffset));
+    if (!error) error = (this->evlrSpill.read(buf, nBytes) != nBytes);
+    return !error;
+}
+
+
+/*!
+ * \brief Appends an EVLR with data held in memory.
+ * \param header EVLR header.
+ * \param data EVLR data of header.recordLength bytes.
+ * \return True, if the EVLR was appended successfully.
+ * \remark EVLRs are held in the spill file until the las-file is closed, then they are written behind the point data.
+ */
+bool LasFile::appendEVLR(LasEVLRHeader &header, const char *data)
+{
+    qint64 headerOffset;
+    bool error;
+
+    if (!detachEVLRs()) return false;
+
+    headerOffset = this->vlrDirectory.getEVLRsEnd(0);
+    error = !this->evlrSpill.seek(headerOffset);
+    if (!error) error = (this->evlrSpill.write(reinterpret_cast<char*>(&header), sizeof(LasEVLRHeader)) != sizeof(LasEVLRHeader));
+    if (!error) error = (this->evlrSpill.write(data, qint64(header.recordLength)) != qint64(header.recordLength));
+    if (!error)
     {
-        // read VLR data
-        vlr.data = new char[vlr.header.recordLength];
-        error = (dataFile.read(vlr.data, vlr.header.recordLength) != vlr.header.recordLength);
+        this->vlrDirectory.appendEVLR(header, headerOffset);
+        this->dataFileHeader.number_of_evlrs++;
+        this->headerChanged = true;
+    }
+
+    return !error;
+}
+
+
+/*!
+ * \brief Appends an EVLR with data streamed from a file.
+ * \param header EVLR header.
+ * \param source Open file with EVLR data.
+ * \param sourceOffset Offset of header.recordLength bytes of EVLR data in the source file.
+ * \return True, if the EVLR was appended successfully.
+ * \remark Data are copied in blocks, see LasCopyTask::copy.
+ */
+bool LasFile::appendEVLR(LasEVLRHeader &header, QFile &source, qint64 sourceOffset)
+{
+    qint64 headerOffset;
+    bool error;
+
+    if (!detachEVLRs()) return false;
+
+    headerOffset = this->vlrDirectory.getEVLRsEnd(0);
+    error = !this->evlrSpill.seek(headerOffset);
+    if (!error) error = (this->evlrSpill.write(reinterpret_cast<char*>(&header), sizeof(LasEVLRHeader)) != sizeof(LasEVLRHeader));
+    if (!error) error = !LasCopyTask::copy(source, sourceOffset, this->evlrSpill, headerOffset + qint64(sizeof(LasEVLRHeader)), qint64(header.recordLength));
+    if (!error)
+    {
+        this->vlrDirectory.appendEVLR(header, headerOffset);
+        this->dataFileHeader.number_of_evlrs++;
+        this->headerChanged = true;
     }
 
     return !error;
 }
 
+
+/*!
+ * \brief Appends a copy of an EVLR of another las-file.
+ * \param las Source las-file.
+ * \param iEVLR Index of the EVLR in the source las-file.
+ * \return True, if the EVLR was copied successfully.
+ */
+bool LasFile::appendEVLR(LasFile &las, qint64 iEVLR)
+{
+    LasEVLRHeader header;
+
+    if (&las == this || !las.readEVLR(iEVLR, header)) return false;
+    return appendEVLR(header, las.evlrSpill.isOpen() ? las.evlrSpill : las.dataFile, las.vlrDirectory.getEVLR(iEVLR).dataOffset);
+}
+
+
 /*!
  * \brief Appends a new VLR. Las-file must be open in read/write mode. VLRs must be written sequentially after the file this->header.
  * \param vlr CLasVLR object to be appended into las-file.
@@ -495,16 +905,21 @@ bool LasFile::readVLR(qint64 iVLR, LasVLR &vlr)
 bool LasFile::appendVLR(LasVLR &vlr)
 {
     bool error;
+    qint64 headerOffset;
 
     if (!this->dataFile.isWritable()) return false;
 
+    headerOffset = this->dataFile.pos();
     error = (this->dataFile.write(reinterpret_cast<char*>(&vlr.header), sizeof(LasVLRHeader)) != sizeof(LasVLRHeader));
     if (!error)
         error = (this->dataFile.write(vlr.data, vlr.header.recordLength) != vlr.header.recordLength);
     if (!error)
     {
         this->dataFileHeader.number_of_vlrs++;
+        this->vlrDirectory.appendVLR(vlr.header, headerOffset);
         this->dataFileHeader.offset_to_point_data += sizeof(LasVLRHeader) + vlr.header.recordLength;
+        this->pageCache.invalidate();
+        this->pageCache.setDataOffset(this->dataFileHeader.offset_to_point_data);
     }
 
     this->headerChanged = true;
@@ -516,50 +931,41 @@ bool LasFile::appendVLR(LasVLR &vlr)
  * \brief Reads point from a las-file and performs coordinates transformation.
  * \param iPoint Index of point.
  * \param lasPoint CLASPoint to fill with data.
+ * \param fields Bit mask of decoded fields (LasPointFields), fields not decoded are set to default values.
  * \return True, if point was read successfully.
  */
-bool LasFile::readPoint(qint64 iPoint, LasPoint &lasPoint)
+bool LasFile::readPoint(qint64 iPoint, LasPoint &lasPoint, quint32 fields)
 {
     qint64 recordOffset = 0;
+    qint64 nRecords;
     char *buf = nullptr;
     bool error = true;
 
     lasPoint.destroy();
     if (!this->dataFile.isOpen()) return false;
-    if (this->dataFileHeader.number_of_points <= quint64(iPoint)) return false;
+    if (iPoint < 0 || this->dataFileHeader.number_of_points <= quint64(iPoint)) return false;
 
-    if (this->cacheData == nullptr)
+    buf = pointRecords(iPoint, nRecords);
+    if (buf != nullptr)
     {
-        // there is no cache, direct reading from a file
-        buf = new char[this->dataFileHeader.point_record_length]; // temporary cache for one record
-        recordOffset = qint64(this->dataFileHeader.offset_to_point_data + quint64(iPoint) * this->dataFileHeader.point_record_length);
-        if (this->dataFile.seek(recordOffset))
-        {
-            if (this->dataFile.read(reinterpret_cast<char*>(buf), this->dataFileHeader.point_record_length) == this->dataFileHeader.point_record_length)
-            {
-                pointFromBufFn(buf, lasPoint);
-                decodeExtraData(buf, lasPoint);
-                lasPoint.unscaleCoordinates(this->dataFileHeader.offset_x, this->dataFileHeader.offset_y, this->dataFileHeader.offset_z, this->dataFileHeader.scale_x, this->dataFileHeader.scale_y, this->dataFileHeader.scale_z);
-                error = false;
-            }
-        }
-
-        if (buf != nullptr) delete [] buf;
+        // point is mapped or cached, direct decoding from memory
+        decodePoint(buf, lasPoint, fields);
+        decodeExtraData(buf, lasPoint, fields);
+        if (fields & LAS_FIELD_XYZ) lasPoint.unscaleCoordinates(this->dataFileHeader.offset_x, this->dataFileHeader.offset_y, this->dataFileHeader.offset_z, this->dataFileHeader.scale_x, this->dataFileHeader.scale_y, this->dataFileHeader.scale_z);
+        error = false;
     }
-    else
+    else if (!this->pageCache.isAllocated())
     {
-        // cache is allocated
-        if (iPoint < this->cacheFirstRecord || this->cacheLastRecord < iPoint)
-            // point not in cache
-            error = (!readPointCache(iPoint));
-        else
-            error = false;
-        if (!error)
+        // there is no cache, direct reading from a file into the record buffer kept until close
+        if (this->recordData == nullptr) this->recordData = new char[this->dataFileHeader.point_record_length];
+        buf = this->recordData;
+        recordOffset = qint64(this->dataFileHeader.offset_to_point_data + quint64(iPoint) * this->dataFileHeader.point_record_length);
+        if (this->dataFile.seek(recordOffset) && this->dataFile.read(buf, this->dataFileHeader.point_record_length) == this->dataFileHeader.point_record_length)
         {
-            // load point from cache
-            recordOffset = qint64(iPoint - this->cacheFirstRecord) * this->dataFileHeader.point_record_length;
-            pointFromBufFn(this->cacheData + recordOffset, lasPoint);
-            lasPoint.unscaleCoordinates(this->dataFileHeader.offset_x, this->dataFileHeader.offset_y, this->dataFileHeader.offset_z, this->dataFileHeader.scale_x, this->dataFileHeader.scale_y, this->dataFileHeader.scale_z);
+            decodePoint(buf, lasPoint, fields);
+            decodeExtraData(buf, lasPoint, fields);
+            if (fields & LAS_FIELD_XYZ) lasPoint.unscaleCoordinates(this->dataFileHeader.offset_x, this->dataFileHeader.offset_y, this->dataFileHeader.offset_z, this->dataFileHeader.scale_x, this->dataFileHeader.scale_y, this->dataFileHeader.scale_z);
+            error = false;
         }
     }
 
@@ -567,82 +973,391 @@ bool LasFile::readPoint(qint64 iPoint, LasPoint &lasPoint)
 }
 
 /*!
- * \brief Appends point from a memory.
- * \param lasPoint Pointer to the buffer. The size of the buffer must be greater or equal to the this->header.pointRecordLength.
- * \return True, if point was successfuly written to the las-file.
+ * \brief Reads a contiguous run of points and performs coordinates transformation.
+ * \param firstPoint Index of the first point.
+ * \param nPoints Number of points to read.
+ * \param lasPoints Array of at least nPoints las-points to fill with data.
+ * \param fields Bit mask of decoded fields (LasPointFields), fields not decoded are set to default values.
+ * \return True, if all points were read successfully.
+ * \remark Points are decoded window by window from the mapped memory or from the point cache.
  */
-bool LasFile::appendPoint(char *buf)
+bool LasFile::readPoints(qint64 firstPoint, qint64 nPoints, LasPoint *lasPoints, quint32 fields)
 {
     bool error = false;
+    char *buf;
+    qint64 nRecords;
 
-    if (!this->dataFile.isWritable() || this->cacheData == nullptr) return false;
+    if (!this->dataFile.isOpen() || lasPoints == nullptr) return false;
+    if (firstPoint < 0 || nPoints < 0 || qint64(this->dataFileHeader.number_of_points) - nPoints < firstPoint) return false;
 
-    this->cacheChanged = true;
-    if (this->cacheFirstRecord < 0)
-    {
-        memcpy(this->cacheData, buf, this->dataFileHeader.point_record_length);
-        this->cacheFirstRecord = qint64(this->dataFileHeader.number_of_points);
-        this->cacheLastRecord = qint64(this->dataFileHeader.number_of_points);
-        this->dataFileHeader.number_of_points++;
-    }
-    else
+    while (0 < nPoints && !error)
     {
-        this->cacheLastRecord++;
-        qint64 cache_offset = (this->cacheLastRecord - this->cacheFirstRecord) * this->dataFileHeader.point_record_length;
-        memcpy(this->cacheData + cache_offset, buf, this->dataFileHeader.point_record_length);
-        this->dataFileHeader.number_of_points++;
-        if (this->cacheNumberOfRecords <= (this->cacheLastRecord - this->cacheFirstRecord + 1))
+        buf = pointRecords(firstPoint, nRecords);
+        if (buf == nullptr)
         {
-            // cache full, write to the output las-file
-            error = !writePointCache();
-            this->cacheFirstRecord = -1;
-            this->cacheLastRecord = -1;
-            memset(this->cacheData, 0, size_t(this->cacheLength));
+            // neither mapped memory nor cache is available, read point by point
+            error = !readPoint(firstPoint, *lasPoints, fields);
+            nRecords = 1;
         }
+        else
+        {
+            if (nPoints < nRecords) nRecords = nPoints;
+            decodePoints(buf, nRecords, lasPoints, fields);
+        }
+        lasPoints += nRecords;
+        firstPoint += nRecords;
+        nPoints -= nRecords;
     }
 
-    this->pointsChanged = true;
     return !error;
 }
 
 
 /*!
- * \brief Appends las-point from an object.
- * \param lasPoint Source object.
- * \param scaleCoordinates If true, point's coordinates will be scaled.
- * \return True, if point was successfully written to the output las-file.
+ * \brief Reads a contiguous run of point records without decoding.
+ * \param firstPoint Index of the first point.
+ * \param nPoints Number of points to read.
+ * \param buf Pointer to the buffer. The size of the buffer must be greater or equal to nPoints * this->header.pointRecordLength.
+ * \return True, if all point records were read successfully.
+ * \remark Records which are not mapped are read directly from the las-file into the buffer, the point cache is bypassed.
+ *         Compressed records are copied from pages of the point cache.
  */
-bool LasFile::appendPoint(LasPoint &lasPoint, bool scaleCoordinates)
+bool LasFile::readPoints(qint64 firstPoint, qint64 nPoints, char *buf)
 {
     bool error = false;
+    qint64 nRecords;
+    qint64 nLength;
+    char *records;
 
-    if (!this->dataFile.isWritable() || this->cacheData == nullptr) return false;
-
-    if (scaleCoordinates) lasPoint.scaleCoordinates(this->dataFileHeader.offset_x, this->dataFileHeader.offset_y, this->dataFileHeader.offset_z, this->dataFileHeader.scale_x, this->dataFileHeader.scale_y, this->dataFileHeader.scale_z);
+    if (!this->dataFile.isOpen() || buf == nullptr) return false;
+    if (firstPoint < 0 || nPoints < 0 || qint64(this->dataFileHeader.number_of_points) - nPoints < firstPoint) return false;
 
-    this->cacheChanged = true;
+    if (isCompressed())
+    {
+        // records are decompressed by pages of the point cache
+        while (0 < nPoints && !error)
+        {
+            records = pointRecords(firstPoint, nRecords);
+            error = (records == nullptr);
+            if (!error)
+            {
+                if (nPoints < nRecords) nRecords = nPoints;
+                nLength = nRecords * this->dataFileHeader.point_record_length;
+                memcpy(buf, records, size_t(nLength));
+                buf += nLength;
+                firstPoint += nRecords;
+                nPoints -= nRecords;
+            }
+        }
+        return !error;
+    }
+
+    if (firstPoint < this->mappedNumberOfRecords)
+    {
+        // copy mapped records
+        nRecords = this->mappedNumberOfRecords - firstPoint;
+        if (nPoints < nRecords) nRecords = nPoints;
+        nLength = nRecords * this->dataFileHeader.point_record_length;
+        memcpy(buf, this->mappedData + this->dataFileHeader.offset_to_point_data + firstPoint * this->dataFileHeader.point_record_length, size_t(nLength));
+        buf += nLength;
+        firstPoint += nRecords;
+        nPoints -= nRecords;
+    }
+
+    if (0 < nPoints)
+    {
+        // changed records must be stored in the las-file before direct reading
+        error = !writePointCache();
+        if (!error) error = !this->dataFile.seek(this->dataFileHeader.offset_to_point_data + firstPoint * this->dataFileHeader.point_record_length);
+        if (!error)
+        {
+            nLength = nPoints * this->dataFileHeader.point_record_length;
+            error = (this->dataFile.read(buf, nLength) != nLength);
+        }
+    }
+
+    return !error;
+}
+
+
+/*!
+ * \brief Reads point records stored in the file without changing the file position and caches.
+ * \param firstPoint Index of the first point.
+ * \param nPoints Number of points.
+ * \param buf Buffer for nPoints records.
+ * \return True, if all records were read successfully.
+ * \remark Thread-safe, used by readers of LasFileReader. Appended points not written yet are not read.
+ */
+bool LasFile::readPointRecordsAt(qint64 firstPoint, qint64 nPoints, char *buf)
+{
+    return readAt(qint64(this->dataFileHeader.offset_to_point_data) + firstPoint * this->dataFileHeader.point_record_length,
+                  buf, nPoints * this->dataFileHeader.point_record_length);
+}
+
+
+/*!
+ * \brief Reads bytes of the file without changing the file position.
+ * \param offset Offset in the file.
+ * \param buf Buffer for nLength bytes.
+ * \param nLength Number of bytes.
+ * \return True, if all bytes were read successfully.
+ * \remark Thread-safe, on Unix bytes are read by pread, otherwise reads are serialized.
+ */
+bool LasFile::readAt(qint64 offset, char *buf, qint64 nLength)
+{
+#ifdef Q_OS_UNIX
+    ssize_t nRead;
+
+    while (0 < nLength)
+    {
+        nRead = pread(this->dataFile.handle(), buf, size_t(nLength), off_t(offset));
+        if (nRead <= 0) return false;
+        buf += nRead;
+        offset += nRead;
+        nLength -= nRead;
+    }
+    return true;
+#else
+    QMutexLocker locker(&this->positionalReadMutex);
+    if (!this->dataFile.seek(offset)) return false;
+    return (this->dataFile.read(buf, nLength) == nLength);
+#endif
+}
+
+
+/*!
+ * \brief Reads chunks of points by worker threads and passes them to a callback.
+ * \param chunkSize Number of points in a chunk, LAS_SCAN_CHUNK_NRECORDS if not positive.
+ * \param nThreads Number of worker threads, the ideal thread count if not positive.
+ * \param function Callback.
+ * \param fields Bit mask of decoded fields (LasPointFields).
+ * \return True, if all points were read successfully or the scan was stopped by the callback.
+ * \remark Changed records are written first, workers read the file by their own LasFileReader objects.
+ * \remark Chunks are distributed by the work stealing LasChunkScheduler.
+ * \remark Compressed files can be scanned only if all appended points are stored in complete chunks.
+ */
+bool LasFile::parallelForEachBatch(qint64 chunkSize, int nThreads, LasBatchFunction &function, quint32 fields)
+{
+    QThreadPool pool;
+    QAtomicInt errorCount(0);
+    qint64 nPoints = qint64(this->dataFileHeader.number_of_points);
+    qint64 nChunks;
+
+    if (!this->dataFile.isOpen()) return false;
+    if (this->dataFile.isWritable())
+    {
+        if (!writePointCache() || !this->dataFile.flush()) return false;
+    }
+    if (isCompressed() && 0 <= this->cacheFirstRecord) return false;
+    if (nPoints == 0) return true;
+
+    if (chunkSize <= 0) chunkSize = LAS_SCAN_CHUNK_NRECORDS;
+    if (nThreads <= 0) nThreads = QThread::idealThreadCount();
+    nChunks = (nPoints + chunkSize - 1) / chunkSize;
+    if (nChunks < nThreads) nThreads = int(nChunks);
+
+    LasChunkScheduler scheduler(nChunks, nThreads);
+    pool.setMaxThreadCount(nThreads);
+    for (int i = 0; i < nThreads; i++)
+        pool.start(new LasScanTask(this, &scheduler, &function, i, chunkSize, fields, &errorCount));
+    pool.waitForDone();
+
+    return (errorCount.loadAcquire() == 0);
+}
+
+
+/*!
+ * \brief Reads a contiguous run of points into a columnar batch and performs coordinates transformation.
+ * \param firstPoint Index of the first point.
+ * \param nPoints Number of points to read.
+ * \param batch Target batch, arrays are reallocated if the batch capacity is not sufficient.
+ * \param fields Bit mask of decoded fields (LasPointFields), arrays of other fields are not filled.
+ * \return True, if all points were read successfully.
+ */
+bool LasFile::readPointBatch(qint64 firstPoint, qint64 nPoints, LasPointBatch &batch, quint32 fields)
+{
+    bool error = false;
+    char *buf;
+    qint64 nRecords;
+    qint64 iBatch = 0;
+    quint32 extraDataLength = 0;
+    LasPoint lasPoint;
+
+    if (!this->dataFile.isOpen()) return false;
+    if (firstPoint < 0 || nPoints < 0 || qint64(this->dataFileHeader.number_of_points) - nPoints < firstPoint) return false;
+
+    if (getStandardPointRecordLength() < this->dataFileHeader.point_record_length)
+        extraDataLength = this->dataFileHeader.point_record_length - getStandardPointRecordLength();
+    if (!batch.allocate(nPoints, extraDataLength, fields)) return false;
+    batch.firstPoint = firstPoint;
+
+    while (iBatch < nPoints && !error)
+    {
+        buf = pointRecords(firstPoint + iBatch, nRecords);
+        if (buf == nullptr)
+        {
+            // neither mapped memory nor cache is available, read point by point
+            error = !readPoint(firstPoint + iBatch, lasPoint, fields);
+            if (!error) batch.setPoint(iBatch, lasPoint);
+            nRecords = 1;
+        }
+        else
+        {
+            if (nPoints - iBatch < nRecords) nRecords = nPoints - iBatch;
+            decodeBatch(buf, nRecords, batch, iBatch, fields);
+        }
+        iBatch += nRecords;
+    }
+
+    if (!error)
+    {
+        batch.numberOfPoints = nPoints;
+        if (fields & LAS_FIELD_XYZ)
+        {
+            LasCoordinates::unscale(batch.ix, batch.x, nPoints, this->dataFileHeader.scale_x, this->dataFileHeader.offset_x);
+            LasCoordinates::unscale(batch.iy, batch.y, nPoints, this->dataFileHeader.scale_y, this->dataFileHeader.offset_y);
+            LasCoordinates::unscale(batch.iz, batch.z, nPoints, this->dataFileHeader.scale_z, this->dataFileHeader.offset_z);
+        }
+    }
+    else
+        batch.numberOfPoints = 0;
+
+    return !error;
+}
+
+
+/*!
+ * \brief Appends point from a memory.
+ * \param lasPoint Pointer to the buffer. The size of the buffer must be greater or equal to the this->header.pointRecordLength.
+ * \return True, if point was successfuly written to the las-file.
+ */
+bool LasFile::appendPoint(char *buf)
+{
+    bool error = false;
+
+    if (!this->dataFile.isWritable() || !allocateAppendCache()) return false;
+    if (0 < this->dataFileHeader.number_of_evlrs && !this->evlrSpill.isOpen() && !detachEVLRs()) return false;
+
+    this->cacheChanged = true;
+    if (this->cacheFirstRecord < 0)
+    {
+        memcpy(this->cacheData, buf, this->dataFileHeader.point_record_length);
+        addPointStatistics(this->cacheData, 1);
+        this->cacheFirstRecord = qint64(this->dataFileHeader.number_of_points);
+        this->cacheLastRecord = qint64(this->dataFileHeader.number_of_points);
+        this->dataFileHeader.number_of_points++;
+    }
+    else
+    {
+        this->cacheLastRecord++;
+        qint64 cache_offset = (this->cacheLastRecord - this->cacheFirstRecord) * this->dataFileHeader.point_record_length;
+        memcpy(this->cacheData + cache_offset, buf, this->dataFileHeader.point_record_length);
+        addPointStatistics(this->cacheData + cache_offset, 1);
+        this->dataFileHeader.number_of_points++;
+        if (this->cacheNumberOfRecords <= (this->cacheLastRecord - this->cacheFirstRecord + 1))
+        {
+            // cache full, write to the output las-file
+            error = !flushAppendedPoints();
+        }
+    }
+
+    this->pointsChanged = true;
+    return !error;
+}
+
+
+/*!
+ * \brief Appends las-point from an object.
+ * \param lasPoint Source object.
+ * \param scaleCoordinates If true, point's coordinates will be scaled.
+ * \return True, if point was successfully written to the output las-file.
+ */
+bool LasFile::appendPoint(LasPoint &lasPoint, bool scaleCoordinates)
+{
+    bool error = false;
+
+    if (!this->dataFile.isWritable() || !allocateAppendCache()) return false;
+    if (0 < this->dataFileHeader.number_of_evlrs && !this->evlrSpill.isOpen() && !detachEVLRs()) return false;
+
+    if (scaleCoordinates) lasPoint.scaleCoordinates(this->dataFileHeader.offset_x, this->dataFileHeader.offset_y, this->dataFileHeader.offset_z, this->dataFileHeader.scale_x, this->dataFileHeader.scale_y, this->dataFileHeader.scale_z);
+
+    this->cacheChanged = true;
     if (this->cacheFirstRecord < 0)
     {
         this->cacheFirstRecord = qint64(this->dataFileHeader.number_of_points);
         this->cacheLastRecord = qint64(this->dataFileHeader.number_of_points);
-        pointToBufFn(lasPoint, this->cacheData);
+        encodePoint(lasPoint, this->cacheData);
         encodeExtraData(lasPoint, this->cacheData);
+        addPointStatistics(this->cacheData, 1);
         this->dataFileHeader.number_of_points++;
     }
     else
     {
         this->cacheLastRecord++;
         qint64 cache_offset = (this->cacheLastRecord - this->cacheFirstRecord) * this->dataFileHeader.point_record_length;
-        pointToBufFn(lasPoint, this->cacheData + cache_offset);
+        encodePoint(lasPoint, this->cacheData + cache_offset);
         encodeExtraData(lasPoint, this->cacheData + cache_offset);
+        addPointStatistics(this->cacheData + cache_offset, 1);
         this->dataFileHeader.number_of_points++;
         if (this->cacheNumberOfRecords <= (this->cacheLastRecord - this->cacheFirstRecord + 1))
         {
             // cache full, write to the output las-file
-            error = !writePointCache();
-            this->cacheFirstRecord = -1;
-            this->cacheLastRecord = -1;
-            memset(this->cacheData, 0, size_t(this->cacheLength));
+            error = !flushAppendedPoints();
+        }
+    }
+
+    this->pointsChanged = true;
+    return !error;
+}
+
+
+/*!
+ * \brief Appends all points of a columnar batch.
+ * \param batch Source batch. Fields not stored in the batch are written as zeros, waveform fields are not written.
+ * \param scaleCoordinates If true, batch coordinates will be scaled.
+ * \return True, if points were successfully written to the output las-file.
+ */
+bool LasFile::appendPointBatch(LasPointBatch &batch, bool scaleCoordinates)
+{
+    bool error = false;
+    qint64 iBatch = 0;
+    qint64 nRecords;
+    char *buf;
+
+    if (!this->dataFile.isWritable() || !allocateAppendCache()) return false;
+    if (batch.numberOfPoints <= 0) return true;
+    if (0 < this->dataFileHeader.number_of_evlrs && !this->evlrSpill.isOpen() && !detachEVLRs()) return false;
+
+    if (scaleCoordinates && (batch.fields & LAS_FIELD_XYZ))
+    {
+        LasCoordinates::scale(batch.x, batch.ix, batch.numberOfPoints, this->dataFileHeader.scale_x, this->dataFileHeader.offset_x);
+        LasCoordinates::scale(batch.y, batch.iy, batch.numberOfPoints, this->dataFileHeader.scale_y, this->dataFileHeader.offset_y);
+        LasCoordinates::scale(batch.z, batch.iz, batch.numberOfPoints, this->dataFileHeader.scale_z, this->dataFileHeader.offset_z);
+    }
+
+    while (iBatch < batch.numberOfPoints && !error)
+    {
+        if (this->cacheFirstRecord < 0)
+        {
+            this->cacheFirstRecord = qint64(this->dataFileHeader.number_of_points);
+            this->cacheLastRecord = this->cacheFirstRecord - 1;
+        }
+
+        // fill the rest of the cache
+        nRecords = this->cacheNumberOfRecords - (this->cacheLastRecord - this->cacheFirstRecord + 1);
+        if (batch.numberOfPoints - iBatch < nRecords) nRecords = batch.numberOfPoints - iBatch;
+        buf = this->cacheData + (this->cacheLastRecord - this->cacheFirstRecord + 1) * this->dataFileHeader.point_record_length;
+        encodeBatch(batch, iBatch, nRecords, buf);
+        addPointStatistics(buf, nRecords);
+        this->cacheLastRecord += nRecords;
+        this->dataFileHeader.number_of_points += quint64(nRecords);
+        this->cacheChanged = true;
+        iBatch += nRecords;
+
+        if (this->cacheNumberOfRecords <= (this->cacheLastRecord - this->cacheFirstRecord + 1))
+        {
+            // cache full, write to the output las-file
+            error = !flushAppendedPoints();
         }
     }
 
@@ -655,22 +1370,58 @@ bool LasFile::appendPoint(LasPoint &lasPoint, bool scaleCoordinates)
  * \brief Appends all points from a source las-file.
  * \param las Source las-file.
  * \return True, if points were succussfully appended the the las-file.
+ * \remark Point records are copied as raw bytes, scaled coordinates are not transformed.
+ * \remark Statistics of appended points are taken from the source las-file.
+ * \remark Records appended to a compressed las-file are compressed through the cache of appended points.
+ * \remark EVLRs of the las-file are moved behind the appended points on close.
+ * \remark Points with waveforms can be appended only from the las-file, whose waveform data packets are stored in the las-file
+ *         (the las-file itself or the template of createCompatible), because waveform data offsets are not rebased.
  */
 bool LasFile::appendPoints(LasFile &las)
 {
     bool error = false;
-    qint64 iPoint;
-    qint64 nPoints;
-    LasPoint lasPoint;
+    qint64 nPoints, iPoint, nRecords;
+    char *buf;
 
-    if (0 < this->dataFileHeader.number_of_evlrs) return false;
     if (las.dataFileHeader.point_format != this->dataFileHeader.point_format || las.dataFileHeader.point_record_length != this->dataFileHeader.point_record_length) return false;
+    if (!this->dataFile.isWritable() || !las.dataFile.isOpen()) return false;
+    if (hasWaveform() && QFileInfo(las.getFileName()).absoluteFilePath() != this->waveformSourceFileName) return false;
+
+    nPoints = qint64(las.dataFileHeader.number_of_points);
+    if (nPoints == 0) return true;
+    if (0 < this->dataFileHeader.number_of_evlrs && !this->evlrSpill.isOpen() && !detachEVLRs()) return false;
+
+    if (isCompressed())
+    {
+        // statistics are added record by record
+        buf = new char[size_t(this->chunkTable.getChunkNRecords()) * this->dataFileHeader.point_record_length];
+        for (iPoint = 0; iPoint < nPoints && !error; iPoint += nRecords)
+        {
+            nRecords = qMin(qint64(this->chunkTable.getChunkNRecords()), nPoints - iPoint);
+            error = !las.readPoints(iPoint, nRecords, buf);
+            for (qint64 i = 0; i < nRecords && !error; i++)
+                error = !appendPoint(buf + i * this->dataFileHeader.point_record_length);
+        }
+        delete[] buf;
+        return !error;
+    }
+
+    // records of both files must be stored in files before copying
+    error = !flushAppendedPoints();
+    if (!error && this->writeBehind != nullptr) error = !this->writeBehind->flush();
+    if (!error) error = !las.writePointCache();
 
-    nPoints = qint64(las.getNumberOfPoints());
-    for(iPoint=0; iPoint<nPoints && !error; iPoint++)
+    if (!error) error = !copyPointRecords(las, 0, nPoints, qint64(this->dataFileHeader.offset_to_point_data + this->dataFileHeader.number_of_points * this->dataFileHeader.point_record_length));
+    if (!error)
     {
-        error = !las.readPoint(iPoint, lasPoint);
-        if (!error) error = !appendPoint(lasPoint, false);
+        this->dataFileHeader.number_of_points += quint64(nPoints);
+        if (las.pointStatisticsTracked)
+            this->pointStatistics.merge(las.pointStatistics);
+        else
+            this->pointStatisticsTracked = false;
+        if (!this->zoneMapTracked || !las.hasZoneMap() || !this->zoneMap.append(las.zoneMap))
+            this->zoneMapTracked = false;
+        this->pointsChanged = true;
     }
 
     return !error;
@@ -695,28 +1446,201 @@ bool LasFile::appendPoints(QString lasFileName)
 }
 
 
+/*!
+ * \brief Replaces an existing point record.
+ * \param iPoint Index of the point.
+ * \param lasPoint LAS point.
+ * \param scaleCoordinates If true, not-scaled coordinates are scaled before encoding.
+ * \return True, if the point was updated successfully.
+ * \remark The record is changed in the memory and written when its page is evicted or on close.
+ * \remark The file must be mapped or open with a point cache, compressed records cannot be updated.
+ * \remark The spatial index sidecar file is removed, coordinates of the point may change.
+ */
+bool LasFile::updatePoint(qint64 iPoint, LasPoint &lasPoint, bool scaleCoordinates)
+{
+    qint64 nRecords;
+    char *buf;
+
+    if (!this->dataFile.isWritable() || isCompressed()) return false;
+    if (iPoint < 0 || this->dataFileHeader.number_of_points <= quint64(iPoint)) return false;
+
+    buf = pointRecords(iPoint, nRecords);
+    if (buf == nullptr) return false;
+
+    if (scaleCoordinates) lasPoint.scaleCoordinates(this->dataFileHeader.offset_x, this->dataFileHeader.offset_y, this->dataFileHeader.offset_z, this->dataFileHeader.scale_x, this->dataFileHeader.scale_y, this->dataFileHeader.scale_z);
+    removeSpatialIndex();
+
+    encodePoint(lasPoint, buf);
+    encodeExtraData(lasPoint, buf);
+    this->pageCache.markDirty(iPoint);
+    updatePointStatistics(buf, iPoint, 1, LAS_FIELD_ALL);
+
+    this->pointsChanged = true;
+    return true;
+}
+
+
+/*!
+ * \brief Writes selected fields of a run of points from a columnar batch into existing point records.
+ * \param firstPoint Index of the first updated point.
+ * \param batch Batch with new values, batch.numberOfPoints records are updated.
+ * \param fields Bit mask of updated fields (LasPointFields), fields not stored in the batch are ignored.
+ * \param scaleCoordinates If true, not-scaled coordinates of the batch are scaled before encoding.
+ * \return True, if all points were updated successfully.
+ * \remark Other fields of records are not changed, e.g. only classifications are written by LAS_FIELD_CLASSIFICATION.
+ * \remark Records are changed in the memory page by page and written when pages are evicted or on close.
+ * \remark The file must be mapped or open with a point cache, compressed records cannot be updated.
+ * \remark The spatial index sidecar file is removed, if LAS_FIELD_XYZ is updated.
+ */
+bool LasFile::updatePointBatch(qint64 firstPoint, LasPointBatch &batch, quint32 fields, bool scaleCoordinates)
+{
+    bool error = false;
+    qint64 iBatch = 0;
+    qint64 nRecords;
+    char *buf;
+
+    if (!this->dataFile.isWritable() || isCompressed()) return false;
+    if (firstPoint < 0 || batch.numberOfPoints < 0 || qint64(this->dataFileHeader.number_of_points) - batch.numberOfPoints < firstPoint) return false;
+
+    fields &= batch.fields;
+    if (fields == 0 || batch.numberOfPoints == 0) return true;
+    if (fields & LAS_FIELD_XYZ) removeSpatialIndex();
+
+    if (scaleCoordinates && (fields & LAS_FIELD_XYZ))
+    {
+        LasCoordinates::scale(batch.x, batch.ix, batch.numberOfPoints, this->dataFileHeader.scale_x, this->dataFileHeader.offset_x);
+        LasCoordinates::scale(batch.y, batch.iy, batch.numberOfPoints, this->dataFileHeader.scale_y, this->dataFileHeader.offset_y);
+        LasCoordinates::scale(batch.z, batch.iz, batch.numberOfPoints, this->dataFileHeader.scale_z, this->dataFileHeader.offset_z);
+    }
+
+    while (iBatch < batch.numberOfPoints && !error)
+    {
+        buf = pointRecords(firstPoint + iBatch, nRecords);
+        if (buf == nullptr)
+            error = true;
+        else
+        {
+            if (batch.numberOfPoints - iBatch < nRecords) nRecords = batch.numberOfPoints - iBatch;
+            encodeBatchFields(batch, iBatch, nRecords, buf, fields);
+            this->pageCache.markDirty(firstPoint + iBatch);
+            updatePointStatistics(buf, firstPoint + iBatch, nRecords, fields);
+            this->pointsChanged = true;
+            iBatch += nRecords;
+        }
+    }
+
+    return !error;
+}
+
+
 /*!
  * \brief Merges two las-files.
  * \param fileName1 File name of the first las-file.
  * \param fileName2 File name of the second las-file.
  * \param outputFileName Outpu las-file name.
  * \return True, if las-files were sucessfully merged.
+ * \remark Records are copied by one thread.
  */
 bool LasFile::merge(QString fileName1, QString fileName2, QString outputFileName)
 {
-    bool error;
-    LasFile inLas1, inLas2;
-    LasFile outLas;
+    return merge(QStringList() << fileName1 << fileName2, outputFileName, 1);
+}
 
-    if (!QFile::exists(fileName1)) return false;
-    if (!QFile::exists(fileName2)) return false;
+
+/*!
+ * \brief Merges las-files into a new las-file.
+ * \param inputFileNames Input las-files, all with the same point format and point record length.
+ * \param outputFileName Output las-file, compatible with the first input las-file.
+ * \param nThreads Number of threads copying point records, 0 for the ideal number of threads.
+ * \return True, if las-files were merged successfully.
+ * \remark Offsets of input points in the output file are computed from input headers in advance,
+ *         tasks copy disjoint ranges of the output file in parallel.
+ * \remark Point records are copied as raw bytes, scaled coordinates are not transformed.
+ * \remark Compressed input files are decompressed after parallel copying, chunks are decompressed by worker threads.
+ * \remark Points with waveforms can be merged only from the first input file, waveform data offsets are not rebased.
+ */
+bool LasFile::merge(QStringList inputFileNames, QString outputFileName, int nThreads)
+{
+    bool error = false;
+    LasFile inLas;
+    LasFile outLas;
+    QVector<qint64> nPoints, pointDataOffsets;
+    QVector<bool> compressedInputs;
+    QThreadPool pool;
+    QAtomicInt errorCount(0);
+    qint64 sourceOffset, targetOffset, nBytes, nTask;
+    int i;
+
+    if (inputFileNames.isEmpty()) return false;
+    for (i = 0; i < inputFileNames.size(); i++)
+        if (!QFile::exists(inputFileNames[i])) return false;
     QFile::remove(outputFileName);
 
-    error = !inLas1.open(fileName1);
-    if (!error) error = !outLas.createCompatible(outputFileName, inLas1);
-    if (!error) error = !outLas.appendPoints(inLas1);
-    if (!error) error = !inLas2.open(fileName2);
-    if (!error) error = !outLas.appendPoints(inLas2);
+    // output header and VLRs, statistics of all inputs
+    error = !inLas.open(inputFileNames[0], 0);
+    if (!error) error = !outLas.createCompatible(outputFileName, inLas);
+    for (i = 0; i < inputFileNames.size() && !error; i++)
+    {
+        if (0 < i) error = !inLas.open(inputFileNames[i], 0);
+        if (!error) error = (inLas.dataFileHeader.point_format != outLas.dataFileHeader.point_format || inLas.dataFileHeader.point_record_length != outLas.dataFileHeader.point_record_length);
+        if (!error && outLas.hasWaveform()) error = (QFileInfo(inputFileNames[i]).absoluteFilePath() != outLas.waveformSourceFileName);
+        if (!error)
+        {
+            nPoints.append(qint64(inLas.dataFileHeader.number_of_points));
+            pointDataOffsets.append(qint64(inLas.dataFileHeader.offset_to_point_data));
+            compressedInputs.append(inLas.isCompressed());
+            if (inLas.pointStatisticsTracked)
+                outLas.pointStatistics.merge(inLas.pointStatistics);
+            else
+                outLas.pointStatisticsTracked = false;
+            if (!outLas.zoneMapTracked || !inLas.hasZoneMap() || !outLas.zoneMap.append(inLas.zoneMap))
+                outLas.zoneMapTracked = false;
+        }
+        inLas.close();
+    }
+    if (!error) error = !outLas.dataFile.flush();
+
+    // copy point records in parallel
+    if (!error)
+    {
+        pool.setMaxThreadCount(0 < nThreads ? nThreads : QThread::idealThreadCount());
+        targetOffset = qint64(outLas.dataFileHeader.offset_to_point_data);
+        for (i = 0; i < inputFileNames.size(); i++)
+        {
+            sourceOffset = pointDataOffsets[i];
+            nBytes = nPoints[i] * outLas.dataFileHeader.point_record_length;
+            if (compressedInputs[i])
+            {
+                targetOffset += nBytes;
+                nBytes = 0;
+            }
+            while (0 < nBytes)
+            {
+                nTask = qMin(nBytes, qint64(LAS_MERGE_TASK_SIZE));
+                pool.start(new LasCopyTask(inputFileNames[i], sourceOffset, outputFileName, targetOffset, nTask, &errorCount));
+                sourceOffset += nTask;
+                targetOffset += nTask;
+                nBytes -= nTask;
+            }
+            outLas.dataFileHeader.number_of_points += quint64(nPoints[i]);
+        }
+        pool.waitForDone();
+        if (0 < errorCount.loadAcquire()) error = true;
+        outLas.pointsChanged = true;
+    }
+
+    // decompress compressed inputs
+    targetOffset = qint64(outLas.dataFileHeader.offset_to_point_data);
+    for (i = 0; i < compressedInputs.size() && !error; i++)
+    {
+        if (compressedInputs[i])
+        {
+            error = !inLas.open(inputFileNames[i], 0, LAS_ACCESS_READ_AHEAD);
+            if (!error) error = !outLas.copyPointRecords(inLas, 0, nPoints[i], targetOffset);
+            inLas.close();
+        }
+        targetOffset += nPoints[i] * outLas.dataFileHeader.point_record_length;
+    }
 
     if (!error)
         error = !outLas.close();
@@ -725,8 +1649,6 @@ bool LasFile::merge(QString fileName1, QString fileName2, QString outputFileName
         outLas.close();
         QFile::remove(outputFileName);
     }
-    inLas2.close();
-    inLas1.close();
 
     return !error;
 }
@@ -766,719 +1688,1477 @@ bool LasFile::append(QString targetLasFileName, QString sourceLasFileName)
  */
 
 /*!
- * \brief Dummy decoder, does nothing.
+ * \brief Decodes a point record of the current point format.
  * \param buf Buffer.
  * \param lasPoint LAS point to be loaded with data.
+ * \param fields Bit mask of decoded fields (LasPointFields).
+ * \remark Extra data are not decoded, coordinates are not unscaled.
  */
-void LasFile::decodePointNull(char *, LasPoint &)
+void LasFile::decodePoint(char *buf, LasPoint &lasPoint, quint32 fields)
 {
+    switch (this->dataFileHeader.point_format)
+    {
+        case 0: LasPointCodec<0>::decode(buf, lasPoint, fields); break;
+        case 1: LasPointCodec<1>::decode(buf, lasPoint, fields); break;
+        case 2: LasPointCodec<2>::decode(buf, lasPoint, fields); break;
+        case 3: LasPointCodec<3>::decode(buf, lasPoint, fields); break;
+        case 4: LasPointCodec<4>::decode(buf, lasPoint, fields); break;
+        case 5: LasPointCodec<5>::decode(buf, lasPoint, fields); break;
+        case 6: LasPointCodec<6>::decode(buf, lasPoint, fields); break;
+        case 7: LasPointCodec<7>::decode(buf, lasPoint, fields); break;
+        case 8: LasPointCodec<8>::decode(buf, lasPoint, fields); break;
+        case 9: LasPointCodec<9>::decode(buf, lasPoint, fields); break;
+        case 10: LasPointCodec<10>::decode(buf, lasPoint, fields); break;
+    }
 }
 
 
 /*!
- * \brief Decodes Point0 from byte array.
- * \param buf Buffer.
- * \param lasPoint LAS point to be loaded with data.
- * \remark x, y, z, intensity, flag, classification, userData, sourceId
- * \remark size = 20
+ * \brief Decodes a run of point records of the current point format and unscales coordinates.
+ * \param buf Buffer with nRecords point records.
+ * \param nRecords Number of records to decode.
+ * \param lasPoints Array of at least nRecords las-points to fill with data.
+ * \param fields Bit mask of decoded fields (LasPointFields), fields not decoded are set to default values.
  */
-void LasFile::decodePoint0(char *buf, LasPoint &lasPoint)
+void LasFile::decodePoints(char *buf, qint64 nRecords, LasPoint *lasPoints, quint32 fields)
 {
-    quint8 flag;
-
-    lasPoint.ix = *reinterpret_cast<qint32*>(buf);
-    lasPoint.iy = *reinterpret_cast<qint32*>(buf + 4);
-    lasPoint.iz = *reinterpret_cast<qint32*>(buf + 8);
-    lasPoint.intensity = *reinterpret_cast<quint16*>(buf + 12);
-    flag = quint8(buf[14]);
-    lasPoint.returnNumber = (flag & 7);
-    lasPoint.numberOfReturns = ((flag >> 3) & 7);
-    lasPoint.classification = quint8(buf[15]);
-    lasPoint.scanAngle = buf[16];
-    lasPoint.userData = quint8(buf[17]);
-    lasPoint.sourceID = *reinterpret_cast<quint16*>(buf + 18);
+    switch (this->dataFileHeader.point_format)
+    {
+        case 0: decodePointsOfFormat<0>(buf, nRecords, lasPoints, fields); break;
+        case 1: decodePointsOfFormat<1>(buf, nRecords, lasPoints, fields); break;
+        case 2: decodePointsOfFormat<2>(buf, nRecords, lasPoints, fields); break;
+        case 3: decodePointsOfFormat<3>(buf, nRecords, lasPoints, fields); break;
+        case 4: decodePointsOfFormat<4>(buf, nRecords, lasPoints, fields); break;
+        case 5: decodePointsOfFormat<5>(buf, nRecords, lasPoints, fields); break;
+        case 6: decodePointsOfFormat<6>(buf, nRecords, lasPoints, fields); break;
+        case 7: decodePointsOfFormat<7>(buf, nRecords, lasPoints, fields); break;
+        case 8: decodePointsOfFormat<8>(buf, nRecords, lasPoints, fields); break;
+        case 9: decodePointsOfFormat<9>(buf, nRecords, lasPoints, fields); break;
+        case 10: decodePointsOfFormat<10>(buf, nRecords, lasPoints, fields); break;
+    }
 }
 
 
 /*!
- * \brief Decodes Point1 from byte array.
- * \param buf Buffer.
- * \param lasPoint LAS point to be loaded with data.
- * \remark Point0 + gpsTime
- * \remark size = 28
+ * \brief Decodes a run of point records of a given point format and unscales coordinates.
+ * \param buf Buffer with nRecords point records.
+ * \param nRecords Number of records to decode.
+ * \param lasPoints Array of at least nRecords las-points to fill with data.
+ * \param fields Bit mask of decoded fields (LasPointFields), fields not decoded are set to default values.
+ * \remark The point decoder is inlined into the loop.
  */
-void LasFile::decodePoint1(char *buf, LasPoint &lasPoint)
+template<int Format>
+void LasFile::decodePointsOfFormat(char *buf, qint64 nRecords, LasPoint *lasPoints, quint32 fields)
 {
-    decodePoint0(buf, lasPoint);
-    lasPoint.gpsTime = *reinterpret_cast<double*>(buf + 20);
+    qint64 i;
+    const quint16 recordLength = this->dataFileHeader.point_record_length;
+    const double offsetX = this->dataFileHeader.offset_x, offsetY = this->dataFileHeader.offset_y, offsetZ = this->dataFileHeader.offset_z;
+    const double scaleX = this->dataFileHeader.scale_x != 0.0 ? this->dataFileHeader.scale_x : 1.0;
+    const double scaleY = this->dataFileHeader.scale_y != 0.0 ? this->dataFileHeader.scale_y : 1.0;
+    const double scaleZ = this->dataFileHeader.scale_z != 0.0 ? this->dataFileHeader.scale_z : 1.0;
+
+    for(i = 0; i < nRecords; i++, buf += recordLength)
+    {
+        lasPoints[i].destroy();
+        LasPointCodec<Format>::decode(buf, lasPoints[i], fields);
+        decodeExtraData(buf, lasPoints[i], fields);
+        if (fields & LAS_FIELD_XYZ)
+        {
+            lasPoints[i].x = offsetX + scaleX * lasPoints[i].ix;
+            lasPoints[i].y = offsetY + scaleY * lasPoints[i].iy;
+            lasPoints[i].z = offsetZ + scaleZ * lasPoints[i].iz;
+        }
+    }
 }
 
 
 /*!
- * \brief Decodes Point2 from byte array.
- * \param buf Buffer.
- * \param lasPoint LAS point to be loaded with data.
- * \remark Point0 + r, g, b
- * \remark size = 26
+ * \brief Copies extra user data.
+ * \param buf Input byte array.
+ * \param lasPoint Target las-point.
+ * \param fields Bit mask of decoded fields, extra data are copied only if LAS_FIELD_EXTRA_DATA is set.
+ * \remark Extra data are stored in the memory owned by the las-point, no memory is allocated for repeated reads.
  */
-void LasFile::decodePoint2(char *buf, LasPoint &lasPoint)
+void LasFile::decodeExtraData(char *buf, LasPoint &lasPoint, quint32 fields)
 {
-    decodePoint0(buf, lasPoint);
-    lasPoint.r = *reinterpret_cast<quint16*>(buf + 20);
-    lasPoint.g = *reinterpret_cast<quint16*>(buf + 22);
-    lasPoint.b = *reinterpret_cast<quint16*>(buf + 24);
+    quint32 standardRecordLength;
+
+    if (!(fields & LAS_FIELD_EXTRA_DATA)) return;
+
+    standardRecordLength = getStandardPointRecordLength();
+    if (standardRecordLength < this->dataFileHeader.point_record_length)
+    {
+        lasPoint.allocateExtraData(this->dataFileHeader.point_record_length - standardRecordLength);
+        memcpy(lasPoint.extraData, buf + standardRecordLength, lasPoint.extraDataLength);
+    }
 }
 
 
 /*!
- * \brief Decodes Point3 from byte array.
- * \param buf Buffer.
- * \param lasPoint LAS point to be loaded with data.
- * \remark Point1 + r, g, b
- * \remark size = 34
+ * \brief Decodes a run of point records into a columnar batch.
+ * \param buf Buffer with nRecords point records.
+ * \param nRecords Number of records to decode.
+ * \param batch Target batch.
+ * \param iBatch Index of the first decoded point in the batch.
+ * \param fields Bit mask of decoded fields (LasPointFields).
+ * \remark Coordinates are not unscaled.
  */
-void LasFile::decodePoint3(char *buf, LasPoint &lasPoint)
+void LasFile::decodeBatch(char *buf, qint64 nRecords, LasPointBatch &batch, qint64 iBatch, quint32 fields)
 {
-    decodePoint1(buf, lasPoint);
-    lasPoint.r = *reinterpret_cast<quint16*>(buf + 28);
-    lasPoint.g = *reinterpret_cast<quint16*>(buf + 30);
-    lasPoint.b = *reinterpret_cast<quint16*>(buf + 32);
+    const quint8 format = this->dataFileHeader.point_format;
+    const quint16 recordLength = this->dataFileHeader.point_record_length;
+    const bool extended = (6 <= format);
+    const qint64 gpsTimeOffset = GpsTimeOffset[format];
+    const qint64 colorOffset = ColorOffset[format];
+    const qint64 nirOffset = NirOffset[format];
+    const quint16 standardRecordLength = getStandardPointRecordLength();
+    quint8 flag;
+    qint64 i;
+    char *rec;
+
+    if (nRecords <= 0) return;
+
+    if (fields & LAS_FIELD_XYZ)
+    {
+        for(i = 0, rec = buf; i < nRecords; i++, rec += recordLength)
+        {
+            batch.ix[iBatch + i] = *reinterpret_cast<qint32*>(rec);
+            batch.iy[iBatch + i] = *reinterpret_cast<qint32*>(rec + 4);
+            batch.iz[iBatch + i] = *reinterpret_cast<qint32*>(rec + 8);
+        }
+    }
+
+    if (fields & LAS_FIELD_INTENSITY)
+        for(i = 0, rec = buf + 12; i < nRecords; i++, rec += recordLength)
+            batch.intensity[iBatch + i] = *reinterpret_cast<quint16*>(rec);
+
+    if (fields & LAS_FIELD_RETURNS)
+    {
+        for(i = 0, rec = buf + 14; i < nRecords; i++, rec += recordLength)
+        {
+            flag = quint8(*rec);
+            batch.returnNumber[iBatch + i] = extended ? (flag & 15) : (flag & 7);
+            batch.numberOfReturns[iBatch + i] = extended ? ((flag >> 4) & 15) : ((flag >> 3) & 7);
+        }
+    }
+
+    if (fields & LAS_FIELD_CLASSIFICATION)
+        for(i = 0, rec = buf + (extended ? 16 : 15); i < nRecords; i++, rec += recordLength)
+            batch.classification[iBatch + i] = quint8(*rec);
+
+    if (fields & LAS_FIELD_CLASSIFICATION_FLAGS)
+    {
+        if (extended)
+            for(i = 0, rec = buf + 15; i < nRecords; i++, rec += recordLength)
+                batch.classificationFlag[iBatch + i] = quint8(*rec);
+        else
+            memset(batch.classificationFlag + iBatch, 0, size_t(nRecords));
+    }
+
+    if (fields & LAS_FIELD_USER_DATA)
+        for(i = 0, rec = buf + 17; i < nRecords; i++, rec += recordLength)
+            batch.userData[iBatch + i] = quint8(*rec);
+
+    if (fields & LAS_FIELD_SCAN_ANGLE)
+    {
+        if (extended)
+            for(i = 0, rec = buf + 18; i < nRecords; i++, rec += recordLength)
+                batch.scanAngle[iBatch + i] = *reinterpret_cast<qint16*>(rec);
+        else
+            for(i = 0, rec = buf + 16; i < nRecords; i++, rec += recordLength)
+                batch.scanAngle[iBatch + i] = *rec;
+    }
+
+    if (fields & LAS_FIELD_SOURCE_ID)
+        for(i = 0, rec = buf + (extended ? 20 : 18); i < nRecords; i++, rec += recordLength)
+            batch.sourceID[iBatch + i] = *reinterpret_cast<quint16*>(rec);
+
+    if (fields & LAS_FIELD_GPS_TIME)
+    {
+        if (0 <= gpsTimeOffset)
+            for(i = 0, rec = buf + gpsTimeOffset; i < nRecords; i++, rec += recordLength)
+                batch.gpsTime[iBatch + i] = *reinterpret_cast<double*>(rec);
+        else
+            memset(batch.gpsTime + iBatch, 0, size_t(nRecords) * sizeof(double));
+    }
+
+    if (fields & LAS_FIELD_RGB)
+    {
+        if (0 <= colorOffset)
+        {
+            for(i = 0, rec = buf + colorOffset; i < nRecords; i++, rec += recordLength)
+            {
+                batch.r[iBatch + i] = *reinterpret_cast<quint16*>(rec);
+                batch.g[iBatch + i] = *reinterpret_cast<quint16*>(rec + 2);
+                batch.b[iBatch + i] = *reinterpret_cast<quint16*>(rec + 4);
+            }
+        }
+        else
+        {
+            memset(batch.r + iBatch, 0, size_t(nRecords) * sizeof(quint16));
+            memset(batch.g + iBatch, 0, size_t(nRecords) * sizeof(quint16));
+            memset(batch.b + iBatch, 0, size_t(nRecords) * sizeof(quint16));
+        }
+    }
+
+    if (fields & LAS_FIELD_NIR)
+    {
+        if (0 <= nirOffset)
+            for(i = 0, rec = buf + nirOffset; i < nRecords; i++, rec += recordLength)
+                batch.ir[iBatch + i] = *reinterpret_cast<quint16*>(rec);
+        else
+            memset(batch.ir + iBatch, 0, size_t(nRecords) * sizeof(quint16));
+    }
+
+    if ((fields & LAS_FIELD_EXTRA_DATA) && 0 < batch.extraDataLength)
+        for(i = 0, rec = buf + standardRecordLength; i < nRecords; i++, rec += recordLength)
+            memcpy(batch.extraData + (iBatch + i) * batch.extraDataLength, rec, batch.extraDataLength);
 }
 
 
+
+
+/*!
+ * *****************************************************************
+ * Point encoders
+ * *****************************************************************
+ */
+
 /*!
- * \brief Decodes Point4 from byte array.
+ * \brief Encodes a point record of the current point format.
+ * \param lasPoint LAS point.
  * \param buf Buffer.
- * \param lasPoint LAS point to be loaded with data.
- * \remark Point1 + waveform
- * \remark size = 57
+ * \remark Extra data are not encoded.
+ * \remark Coordinates must be scaled!
  */
-void LasFile::decodePoint4(char *buf, LasPoint &lasPoint)
+void LasFile::encodePoint(LasPoint &lasPoint, char *buf)
 {
-    decodePoint1(buf, lasPoint);
-    lasPoint.waveformPacketIndex = quint8(buf[28]);
-    lasPoint.waveformDataOffset = *reinterpret_cast<quint64*>(buf + 29);
-    lasPoint.waveformPacketSize = *reinterpret_cast<quint32*>(buf + 37);
-    lasPoint.waveformLocation = *reinterpret_cast<float*>(buf + 41);
-    lasPoint.xt = *reinterpret_cast<float*>(buf + 45);
-    lasPoint.yt = *reinterpret_cast<float*>(buf + 49);
-    lasPoint.zt = *reinterpret_cast<float*>(buf + 53);
+    switch (this->dataFileHeader.point_format)
+    {
+        case 0: LasPointCodec<0>::encode(lasPoint, buf); break;
+        case 1: LasPointCodec<1>::encode(lasPoint, buf); break;
+        case 2: LasPointCodec<2>::encode(lasPoint, buf); break;
+        case 3: LasPointCodec<3>::encode(lasPoint, buf); break;
+        case 4: LasPointCodec<4>::encode(lasPoint, buf); break;
+        case 5: LasPointCodec<5>::encode(lasPoint, buf); break;
+        case 6: LasPointCodec<6>::encode(lasPoint, buf); break;
+        case 7: LasPointCodec<7>::encode(lasPoint, buf); break;
+        case 8: LasPointCodec<8>::encode(lasPoint, buf); break;
+        case 9: LasPointCodec<9>::encode(lasPoint, buf); break;
+        case 10: LasPointCodec<10>::encode(lasPoint, buf); break;
+    }
 }
 
 
 /*!
- * \brief Decodes Point5 from byte array.
- * \param buf Buffer.
- * \param lasPoint LAS point to be loaded with data.
- * \remark Point3 + waveform
- * \remark size = 63
+ * \brief Encodes extra data.
+ * \param lasPoint Input las-point.
+ * \param buf Pointer to the output buffer.
+ * \remark Extra bytes not stored in the point are set to zero, so that the buffer need not be cleared.
  */
-void LasFile::decodePoint5(char *buf, LasPoint &lasPoint)
+void LasFile::encodeExtraData(LasPoint &lasPoint, char *buf)
 {
-    decodePoint3(buf, lasPoint);
-    lasPoint.waveformPacketIndex = quint8(buf[34]);
-    lasPoint.waveformDataOffset = *reinterpret_cast<quint64*>(buf + 35);
-    lasPoint.waveformPacketSize = *reinterpret_cast<quint32*>(buf + 43);
-    lasPoint.waveformLocation = *reinterpret_cast<float*>(buf + 47);
-    lasPoint.xt = *reinterpret_cast<float*>(buf + 51);
-    lasPoint.yt = *reinterpret_cast<float*>(buf + 55);
-    lasPoint.zt = *reinterpret_cast<float*>(buf + 59);
+    quint32 standardRecordLength, length;
+
+    standardRecordLength = getStandardPointRecordLength();
+    if (this->dataFileHeader.point_record_length <= standardRecordLength) return;
+
+    length = qMin(quint32(this->dataFileHeader.point_record_length - standardRecordLength), lasPoint.extraDataLength);
+    if (0 < length) memcpy(buf + standardRecordLength, lasPoint.extraData, length);
+    memset(buf + standardRecordLength + length, 0, this->dataFileHeader.point_record_length - standardRecordLength - length);
 }
 
 
 /*!
- * \brief Decodes Point6 from byte array.
- * \param buf Buffer.
- * \param lasPoint LAS point to be loaded with data.
- * \remark x, y, z, intensity, flag, classificationFlag, classification, userData, scanAngle, sourceId, gpsTime
- * \remark size = 30
+ * \brief Encodes a run of points from a columnar batch to byte array.
+ * \param batch Source batch.
+ * \param iBatch Index of the first encoded point in the batch.
+ * \param nRecords Number of records to encode.
+ * \param buf Buffer for nRecords point records.
+ * \remark Coordinates must be scaled! Fields not stored in the batch are set to zero.
  */
-void LasFile::decodePoint6(char *buf, LasPoint &lasPoint)
+void LasFile::encodeBatch(LasPointBatch &batch, qint64 iBatch, qint64 nRecords, char *buf)
 {
-    quint8 flag;
+    if (nRecords <= 0) return;
+    memset(buf, 0, size_t(nRecords) * this->dataFileHeader.point_record_length);
+    encodeBatchFields(batch, iBatch, nRecords, buf, batch.fields);
+}
+
+
+/*!
+ * \brief Encodes selected fields of a run of points from a columnar batch into existing point records.
+ * \param batch Source batch.
+ * \param iBatch Index of the first encoded point in the batch.
+ * \param nRecords Number of records to encode.
+ * \param buf Buffer with nRecords point records.
+ * \param fields Bit mask of encoded fields (LasPointFields), the batch must store all of them.
+ * \remark Coordinates must be scaled! Other fields of records are not changed.
+ */
+void LasFile::encodeBatchFields(LasPointBatch &batch, qint64 iBatch, qint64 nRecords, char *buf, quint32 fields)
+{
+    const quint8 format = this->dataFileHeader.point_format;
+    const quint16 recordLength = this->dataFileHeader.point_record_length;
+    const bool extended = (6 <= format);
+    const qint64 gpsTimeOffset = GpsTimeOffset[format];
+    const qint64 colorOffset = ColorOffset[format];
+    const qint64 nirOffset = NirOffset[format];
+    const quint16 standardRecordLength = getStandardPointRecordLength();
+    qint64 i;
+    char *rec;
+
+    if (nRecords <= 0) return;
+
+    if (fields & LAS_FIELD_XYZ)
+    {
+        for(i = 0, rec = buf; i < nRecords; i++, rec += recordLength)
+        {
+            *reinterpret_cast<qint32*>(rec) = batch.ix[iBatch + i];
+            *reinterpret_cast<qint32*>(rec + 4) = batch.iy[iBatch + i];
+            *reinterpret_cast<qint32*>(rec + 8) = batch.iz[iBatch + i];
+        }
+    }
+
+    if (fields & LAS_FIELD_INTENSITY)
+        for(i = 0, rec = buf + 12; i < nRecords; i++, rec += recordLength)
+            *reinterpret_cast<quint16*>(rec) = batch.intensity[iBatch + i];
+
+    if (fields & LAS_FIELD_RETURNS)
+    {
+        if (extended)
+            for(i = 0, rec = buf + 14; i < nRecords; i++, rec += recordLength)
+                *rec = char((batch.returnNumber[iBatch + i] & 15) | ((batch.numberOfReturns[iBatch + i] & 15) << 4));
+        else
+            for(i = 0, rec = buf + 14; i < nRecords; i++, rec += recordLength)
+                *rec = char((*rec & 0xC0) | (batch.returnNumber[iBatch + i] & 7) | ((batch.numberOfReturns[iBatch + i] & 7) << 3)); // keep scan direction and edge flags
+    }
+
+    if (fields & LAS_FIELD_CLASSIFICATION)
+        for(i = 0, rec = buf + (extended ? 16 : 15); i < nRecords; i++, rec += recordLength)
+            *rec = char(batch.classification[iBatch + i]);
+
+    if ((fields & LAS_FIELD_CLASSIFICATION_FLAGS) && extended)
+        for(i = 0, rec = buf + 15; i < nRecords; i++, rec += recordLength)
+            *rec = char(batch.classificationFlag[iBatch + i]);
+
+    if (fields & LAS_FIELD_USER_DATA)
+        for(i = 0, rec = buf + 17; i < nRecords; i++, rec += recordLength)
+            *rec = char(batch.userData[iBatch + i]);
+
+    if (fields & LAS_FIELD_SCAN_ANGLE)
+    {
+        if (extended)
+            for(i = 0, rec = buf + 18; i < nRecords; i++, rec += recordLength)
+                *reinterpret_cast<qint16*>(rec) = batch.scanAngle[iBatch + i];
+        else
+            for(i = 0, rec = buf + 16; i < nRecords; i++, rec += recordLength)
+                *rec = char(batch.scanAngle[iBatch + i] & 255);
+    }
+
+    if (fields & LAS_FIELD_SOURCE_ID)
+        for(i = 0, rec = buf + (extended ? 20 : 18); i < nRecords; i++, rec += recordLength)
+            *reinterpret_cast<quint16*>(rec) = batch.sourceID[iBatch + i];
+
+    if ((fields & LAS_FIELD_GPS_TIME) && 0 <= gpsTimeOffset)
+        for(i = 0, rec = buf + gpsTimeOffset; i < nRecords; i++, rec += recordLength)
+            *reinterpret_cast<double*>(rec) = batch.gpsTime[iBatch + i];
+
+    if ((fields & LAS_FIELD_RGB) && 0 <= colorOffset)
+    {
+        for(i = 0, rec = buf + colorOffset; i < nRecords; i++, rec += recordLength)
+        {
+            *reinterpret_cast<quint16*>(rec) = batch.r[iBatch + i];
+            *reinterpret_cast<quint16*>(rec + 2) = batch.g[iBatch + i];
+            *reinterpret_cast<quint16*>(rec + 4) = batch.b[iBatch + i];
+        }
+    }
+
+    if ((fields & LAS_FIELD_NIR) && 0 <= nirOffset)
+        for(i = 0, rec = buf + nirOffset; i < nRecords; i++, rec += recordLength)
+            *reinterpret_cast<quint16*>(rec) = batch.ir[iBatch + i];
 
-    lasPoint.ix = *reinterpret_cast<qint32*>(buf);
-    lasPoint.iy = *reinterpret_cast<qint32*>(buf + 4);
-    lasPoint.iz = *reinterpret_cast<qint32*>(buf + 8);
-    lasPoint.intensity = *reinterpret_cast<quint16*>(buf + 12);
-    flag = quint8(buf[14]);
-    lasPoint.returnNumber = (flag & 15);
-    lasPoint.numberOfReturns = ((flag >> 4) & 15);
-    lasPoint.classificationFlag = quint8(buf[15]);
-    lasPoint.classification = quint8(buf[16]);
-    lasPoint.userData = quint8(buf[17]);
-    lasPoint.scanAngle = *reinterpret_cast<qint16*>(buf + 18);
-    lasPoint.sourceID = *reinterpret_cast<quint16*>(buf + 20);
-    lasPoint.gpsTime = *reinterpret_cast<double*>(buf + 22);
+    if ((fields & LAS_FIELD_EXTRA_DATA) && 0 < batch.extraDataLength && standardRecordLength < recordLength)
+        for(i = 0, rec = buf + standardRecordLength; i < nRecords; i++, rec += recordLength)
+            memcpy(rec, batch.extraData + (iBatch + i) * batch.extraDataLength, qMin(quint32(recordLength - standardRecordLength), batch.extraDataLength));
 }
 
 
 /*!
- * \brief Decodes Point7 from byte array.
- * \param buf Buffer.
- * \param lasPoint LAS point to be loaded with data.
- * \remark Point6 + r, g, b
- * \remark size = 36
+ * \brief Adds encoded point records to point statistics and to the zone map.
+ * \param buf Buffer with nRecords point records.
+ * \param nRecords Number of records.
+ * \remark Statistics are computed from encoded records, so that they match the stored values.
  */
-void LasFile::decodePoint7(char *buf, LasPoint &lasPoint)
+void LasFile::addPointStatistics(char *buf, qint64 nRecords)
 {
-    decodePoint6(buf, lasPoint);
-    lasPoint.r = *reinterpret_cast<quint16*>(buf + 30);
-    lasPoint.g = *reinterpret_cast<quint16*>(buf + 32);
-    lasPoint.b = *reinterpret_cast<quint16*>(buf + 34);
+    switch (this->dataFileHeader.point_format)
+    {
+        case 0: addPointStatisticsOfFormat<0>(buf, nRecords); break;
+        case 1: addPointStatisticsOfFormat<1>(buf, nRecords); break;
+        case 2: addPointStatisticsOfFormat<2>(buf, nRecords); break;
+        case 3: addPointStatisticsOfFormat<3>(buf, nRecords); break;
+        case 4: addPointStatisticsOfFormat<4>(buf, nRecords); break;
+        case 5: addPointStatisticsOfFormat<5>(buf, nRecords); break;
+        case 6: addPointStatisticsOfFormat<6>(buf, nRecords); break;
+        case 7: addPointStatisticsOfFormat<7>(buf, nRecords); break;
+        case 8: addPointStatisticsOfFormat<8>(buf, nRecords); break;
+        case 9: addPointStatisticsOfFormat<9>(buf, nRecords); break;
+        case 10: addPointStatisticsOfFormat<10>(buf, nRecords); break;
+    }
 }
 
 
 /*!
- * \brief Decodes Point8 from byte array.
- * \param buf Buffer.
- * \param lasPoint LAS point to be loaded with data.
- * \remark Point7 + ir
- * \remark size = 38
+ * \brief Adds encoded point records of a given point format to point statistics.
+ * \param buf Buffer with nRecords point records.
+ * \param nRecords Number of records.
  */
-void LasFile::decodePoint8(char *buf, LasPoint &lasPoint)
+template<int Format>
+void LasFile::addPointStatisticsOfFormat(char *buf, qint64 nRecords)
 {
-    decodePoint7(buf, lasPoint);
-    lasPoint.ir = *reinterpret_cast<quint16*>(buf + 36);
+    LasPoint lasPoint;
+    qint64 i;
+    const quint16 recordLength = this->dataFileHeader.point_record_length;
+    const quint32 fields = LAS_FIELD_XYZ | LAS_FIELD_RETURNS | (this->zoneMapTracked ? LAS_FIELD_GPS_TIME | LAS_FIELD_CLASSIFICATION : 0);
+
+    for(i = 0; i < nRecords; i++, buf += recordLength)
+    {
+        LasPointCodec<Format>::decode(buf, lasPoint, fields);
+        this->pointStatistics.add(lasPoint.ix, lasPoint.iy, lasPoint.iz, lasPoint.returnNumber);
+        if (this->zoneMapTracked) this->zoneMap.add(lasPoint.ix, lasPoint.iy, lasPoint.iz, lasPoint.gpsTime, lasPoint.classification);
+    }
 }
 
 
 /*!
- * \brief Decodes Point9 from byte array.
- * \param buf Buffer.
- * \param lasPoint LAS point to be loaded with data.
- * \remark Point6 + waveform
- * \remark size = 59
+ * \brief Updates point statistics and the zone map after point records were changed.
+ * \param buf Changed point records.
+ * \param firstPoint Index of the first changed record.
+ * \param nRecords Number of records.
+ * \param fields Bit mask of changed fields (LasPointFields).
+ * \remark Bounds and return counts cannot shrink incrementally, they are recomputed in updateHeader
+ *         if coordinates or returns were changed. Otherwise zones are only expanded.
  */
-void LasFile::decodePoint9(char *buf, LasPoint &lasPoint)
+void LasFile::updatePointStatistics(char *buf, qint64 firstPoint, qint64 nRecords, quint32 fields)
 {
-    decodePoint6(buf, lasPoint);
-    lasPoint.waveformPacketIndex = quint8(buf[30]);
-    lasPoint.waveformDataOffset = *reinterpret_cast<quint64*>(buf + 31);
-    lasPoint.waveformPacketSize = *reinterpret_cast<quint32*>(buf + 39);
-    lasPoint.waveformLocation = *reinterpret_cast<float*>(buf + 43);
-    lasPoint.xt = *reinterpret_cast<float*>(buf + 47);
-    lasPoint.yt = *reinterpret_cast<float*>(buf + 51);
-    lasPoint.zt = *reinterpret_cast<float*>(buf + 55);
+    LasPoint lasPoint;
+    qint64 i;
+    const quint16 recordLength = this->dataFileHeader.point_record_length;
+
+    if (fields & (LAS_FIELD_XYZ | LAS_FIELD_RETURNS)) this->pointStatisticsTracked = false;
+
+    // zone map is rebuilt together with statistics
+    if (!this->pointStatisticsTracked || !this->zoneMapTracked) return;
+    if (!(fields & (LAS_FIELD_GPS_TIME | LAS_FIELD_CLASSIFICATION))) return;
+
+    for(i = 0; i < nRecords; i++, buf += recordLength)
+    {
+        decodePoint(buf, lasPoint, LAS_FIELD_XYZ | LAS_FIELD_GPS_TIME | LAS_FIELD_CLASSIFICATION);
+        this->zoneMap.expand(firstPoint + i, lasPoint.ix, lasPoint.iy, lasPoint.iz, lasPoint.gpsTime, lasPoint.classification);
+    }
+}
+
+
+
+
+
+/*!
+ * *****************************************************************
+ * LasFile I/O
+ * *****************************************************************
+ */
+
+/*!
+ * \brief Writes LAS 1.4 this->header.
+ * \return True, if las-file header was written successfully.
+ */
+bool LasFile::writeHeader()
+{
+    bool error = false;
+
+    if (this->dataFile.isOpen() && this->dataFile.isWritable() && this->headerChanged)
+    {
+        error = !this->dataFile.seek(0);
+        if (!error) error = (this->dataFile.write(reinterpret_cast<char*>(&this->dataFileHeader), this->dataFileHeader.headerSize) != this->dataFileHeader.headerSize);
+        this->headerChanged = error;
+    }
+
+    return !error;
+}
+
+
+/*!
+ * \brief Updates minimum and maximum of coordinates (x0, x1, y0, y1, z0, z1), points by return values.
+ * \return True, if header was updated successfully.
+ * \remark Statistics are tracked while points are appended, all points are read only if statistics are not tracked.
+ */
+bool LasFile::updateHeader()
+{
+    bool error = false;
+
+    if (!this->pointsChanged) return true;
+
+    if (!this->pointStatisticsTracked) error = !scanPointStatistics();
+    if (!error)
+    {
+        this->pointStatistics.toHeader(this->dataFileHeader);
+        this->headerChanged = true;
+        this->pointsChanged = false;
+        this->zoneMapChanged = true;
+    }
+    return !error;
+}
+
+
+/*!
+ * \brief Recomputes point statistics and the zone map from all point records.
+ * \return True, if all points were read successfully.
+ * \remark Chunks of the zone map are reduced in parallel, partial statistics of threads are merged at the end.
+ */
+bool LasFile::scanPointStatistics()
+{
+    const qint64 chunkNRecords = LAS_ZONE_MAP_CHUNK_NRECORDS;
+    const qint64 nPoints = qint64(this->dataFileHeader.number_of_points);
+    const int nThreads = QThread::idealThreadCount();
+    QVector<LasPointStatistics> threadStatistics(nThreads);
+    QVector<LasZone> chunkZones(int((nPoints + chunkNRecords - 1) / chunkNRecords));
+    LasPointStatistics statistics;
+    LasZoneMap zones;
+    bool error;
+
+    error = !parallelForEach(chunkNRecords, nThreads, [&threadStatistics, &chunkZones, chunkNRecords](int iThread, LasPointBatch &batch)
+    {
+        LasPointStatistics chunkStatistics;
+        chunkStatistics.addBatch(batch);
+        threadStatistics[iThread].merge(chunkStatistics);
+        LasZoneMap::batchZone(batch, chunkZones[int(batch.firstPoint / chunkNRecords)]);
+        return true;
+    }, LAS_FIELD_XYZ | LAS_FIELD_RETURNS | LAS_FIELD_GPS_TIME | LAS_FIELD_CLASSIFICATION);
+
+    if (!error)
+    {
+        zones.clear(quint32(chunkNRecords));
+        for (int i = 0; i < chunkZones.size(); i++)
+            zones.appendZone(chunkZones[i], quint32(qMin(chunkNRecords, nPoints - i * chunkNRecords)));
+        for (int i = 0; i < nThreads; i++)
+            statistics.merge(threadStatistics[i]);
+
+        this->pointStatistics = statistics;
+        this->pointStatisticsTracked = true;
+        this->zoneMap = zones;
+        this->zoneMapTracked = true;
+    }
+    return !error;
+}
+
+
+/*!
+ * \brief Writes the zone map to the sidecar file, or removes an outdated sidecar file.
+ * \return True, if the zone map was written successfully.
+ * \remark Point records must be written to the las-file.
+ */
+bool LasFile::writeZoneMap()
+{
+    QString fileName = LasZoneMap::zoneMapFileName(this->dataFile.fileName());
+
+    if (!this->dataFile.flush()) return false;
+    if (this->zoneMapTracked) return this->zoneMap.write(fileName, *this);
+
+    QFile::remove(fileName);
+    return true;
+}
+
+
+/*!
+ * \brief Copy all VRLs from las-file template.
+ * \param lasTtemplate Las-file.
+ * \return True, if VRLs were copied successfully.
+ * \remark VLRs are located by the VLR directory of the template, each VLR is read by one seek.
+ * \todo Copy only necessary VRLs. Do not copy superseded VRLs.
+ */
+bool LasFile::copyVRLs(LasFile &lasTemplate)
+{
+    bool error = false;
+    qint64 iVLR;
+    LasVLR vlr;
+
+    for(iVLR=0; iVLR < lasTemplate.getNumberOfVLRs() && !error; iVLR++)
+    {
+        // the chunk codec VLR describes the storage of points of the template
+        if (iVLR == lasTemplate.findVLR(LAS_VLR_CHUNK_CODEC_USERID, LAS_VLR_CHUNK_CODEC_RECORDID)) continue;
+        error = !lasTemplate.readVLR(iVLR, vlr);
+        if (!error) error = !appendVLR(vlr);
+    }
+
+    return !error;
+}
+
+
+/*!
+ * \brief Copy all EVRLs from template las-file.
+ * \param lasTemplate Source las-file.
+ * \return True, if EVLRs were copied successfully.
+ * \remark Payloads are streamed, EVLRs are never loaded into memory as a whole.
+ */
+bool LasFile::copyEVRLs(LasFile &lasTemplate)
+{
+    bool error = false;
+    qint64 iEVLR;
+
+    for (iEVLR = 0; iEVLR < lasTemplate.vlrDirectory.getNumberOfEVLRs() && !error; iEVLR++)
+        error = !appendEVLR(lasTemplate, iEVLR);
+
+    return !error;
+}
+
+
+/*!
+ * \brief Moves EVLRs from the end of the las-file into the spill file, before point data grow over them.
+ * \return True, if EVLRs were moved successfully or they are already held in the spill file.
+ * \remark Offsets of EVLRs in the directory become offsets in the spill file. EVLRs appended later are written to the spill file.
+ * \remark The file header stored in the file refers to no EVLRs until the EVLRs are written back on close,
+ *         a file left by a crash is valid without EVLRs and its EVLRs are recovered from the spill file by open.
+ *         An existing spill file is never overwritten.
+ */
+bool LasFile::detachEVLRs()
+{
+    const qint64 fieldsOffset = qint64(offsetof(LasFileHeader14, offset_waveform));
+    const char noEVLRs[sizeof(quint64) + sizeof(quint64) + sizeof(quint32)] = {}; // offset_waveform, offset_evlrs, number_of_evlrs
+    qint64 evlrOffset, nBytes;
+    bool error = false;
+
+    if (this->evlrSpill.isOpen()) return true;
+    if (!this->dataFile.isWritable()) return false;
+
+    if (!lockEVLRSpill()) return false;
+    error = QFile::exists(this->dataFile.fileName() + LAS_EVLR_SPILL_EXTENSION);
+    if (!error)
+    {
+        this->evlrSpill.setFileName(this->dataFile.fileName() + LAS_EVLR_SPILL_EXTENSION);
+        error = !this->evlrSpill.open(QFile::ReadWrite | QFile::Truncate | QFile::Unbuffered);
+    }
+    if (error)
+    {
+        unlockEVLRSpill();
+        return false;
+    }
+
+    if (0 < this->vlrDirectory.getNumberOfEVLRs())
+    {
+        evlrOffset = this->vlrDirectory.getEVLR(0).headerOffset;
+        nBytes = this->vlrDirectory.getEVLRsEnd(evlrOffset) - evlrOffset;
+        if (!LasCopyTask::copy(this->dataFile, evlrOffset, this->evlrSpill, 0, nBytes))
+        {
+            // EVLRs are still stored in the las-file
+            this->evlrSpill.close();
+            QFile::remove(this->evlrSpill.fileName());
+            unlockEVLRSpill();
+            return false;
+        }
+        this->vlrDirectory.moveEVLRs(-evlrOffset);
+    }
+
+    // the old location of EVLRs will be overwritten by points, EVLRs stay in the spill file even if the header was not changed
+    this->headerChanged = true;
+    if (fieldsOffset < qint64(this->dataFileHeader.headerSize))
+    {
+        nBytes = qMin(qint64(sizeof(noEVLRs)), qint64(this->dataFileHeader.headerSize) - fieldsOffset);
+        error = !this->dataFile.seek(fieldsOffset);
+        if (!error) error = (this->dataFile.write(noEVLRs, nBytes) != nBytes);
+        if (!error) error = !this->dataFile.flush();
+    }
+    return !error;
+}
+
+
+/*!
+ * \brief Writes EVLRs held in the spill file behind the point data.
+ * \return True, if EVLRs were written successfully or they were not moved into the spill file.
+ * \remark The file is truncated after the last EVLR. Offsets of EVLRs and of the waveform data packets are updated in the header.
+ * \remark The spill file is closed, but it is removed by close only after the header was written.
+ */
+bool LasFile::attachEVLRs()
+{
+    qint64 evlrOffset, nBytes, iWaveform;
+    bool error;
+
+    if (!this->evlrSpill.isOpen()) return true;
+
+    evlrOffset = getPointDataEnd();
+    nBytes = this->vlrDirectory.getEVLRsEnd(0);
+    error = !LasCopyTask::copy(this->evlrSpill, 0, this->dataFile, evlrOffset, nBytes);
+    if (!error) error = !this->dataFile.flush();
+    if (!error) error = !this->dataFile.resize(evlrOffset + nBytes);
+    if (!error)
+    {
+        this->vlrDirectory.moveEVLRs(evlrOffset);
+        this->dataFileHeader.offset_evlrs = quint64(0 < this->dataFileHeader.number_of_evlrs ? evlrOffset : 0);
+        iWaveform = this->vlrDirectory.findEVLR(LAS_WAVEFORM_EVLR_USERID, LAS_WAVEFORM_EVLR_RECORDID);
+        if (0 <= iWaveform) this->dataFileHeader.offset_waveform = quint64(this->vlrDirectory.getEVLR(iWaveform).headerOffset);
+        this->headerChanged = true;
+    }
+
+    this->evlrSpill.close();
+    return !error;
+}
+
+
+/*!
+ * \brief Recovers EVLRs of the spill file left by a crash or by a failed close.
+ * \return True, if there is no spill file or its EVLRs were recovered.
+ * \remark If the file header refers to EVLRs, they were written back and the outdated spill file is removed.
+ *         Otherwise EVLRs of the spill file are held as detached and written behind the point data on close.
+ *         A record interrupted by a crash is dropped. Read-only las-files are not recovered.
+ * \remark A spill file locked by another session holding detached EVLRs is not touched.
+ */
+bool LasFile::recoverEVLRs()
+{
+    QString spillFileName = this->dataFile.fileName() + LAS_EVLR_SPILL_EXTENSION;
+    LasEVLRHeader header;
+    qint64 offset = 0, spillSize;
+    bool error;
+
+    if (!QFile::exists(spillFileName)) return true;
+    // EVLRs detached by a live session are not recovered, the las-file is read as it is stored
+    if (!lockEVLRSpill()) return true;
+    if (0 < this->dataFileHeader.number_of_evlrs)
+    {
+        error = !QFile::remove(spillFileName);
+        unlockEVLRSpill();
+        return !error;
+    }
+    if (!this->dataFile.isWritable())
+    {
+        unlockEVLRSpill();
+        return false;
+    }
+
+    this->evlrSpill.setFileName(spillFileName);
+    error = !this->evlrSpill.open(QFile::ReadWrite | QFile::Unbuffered);
+    if (!error)
+    {
+        spillSize = this->evlrSpill.size();
+        while (offset + qint64(sizeof(LasEVLRHeader)) <= spillSize)
+        {
+            if (!this->evlrSpill.seek(offset) || this->evlrSpill.read(reinterpret_cast<char*>(&header), sizeof(LasEVLRHeader)) != sizeof(LasEVLRHeader)) break;
+            if (quint64(spillSize - offset) - sizeof(LasEVLRHeader) < header.recordLength) break;
+            this->vlrDirectory.appendEVLR(header, offset);
+            offset += qint64(sizeof(LasEVLRHeader) + header.recordLength);
+        }
+        if (offset < spillSize) error = !this->evlrSpill.resize(offset);
+    }
+    if (!error)
+    {
+        this->dataFileHeader.number_of_evlrs = quint32(this->vlrDirectory.getNumberOfEVLRs());
+        this->headerChanged = true;
+    }
+    else
+    {
+        // the spill file is kept
+        if (this->evlrSpill.isOpen()) this->evlrSpill.close();
+        this->evlrSpill.setFileName(QString());
+        unlockEVLRSpill();
+    }
+    return !error;
+}
+
+
+/*!
+ * rief Locks the spill file of the las-file.
+ * 
+eturn True, if the lock is held by this session.
+ * 
+emark The lock of a crashed process is stale and it is taken over.
+ */
+bool LasFile::lockEVLRSpill()
+{
+    if (this->evlrSpillLock != nullptr) return true;
+
+    this->evlrSpillLock = new QLockFile(this->dataFile.fileName() + LAS_EVLR_SPILL_EXTENSION + LAS_EVLR_LOCK_EXTENSION);
+    this->evlrSpillLock->setStaleLockTime(0);
+    if (this->evlrSpillLock->tryLock(0)) return true;
+
+    delete this->evlrSpillLock;
+    this->evlrSpillLock = nullptr;
+    return false;
+}
+
+
+/*!
+ * rief Unlocks the spill file of the las-file, the lock file is removed.
+ */
+void LasFile::unlockEVLRSpill()
+{
+    if (this->evlrSpillLock == nullptr) return;
+
+    this->evlrSpillLock->unlock();
+    delete this->evlrSpillLock;
+    this->evlrSpillLock = nullptr;
+}
+
+
+/*!
+ * \brief Returns the name of the file holding EVLRs, which were not written back into the las-file.
+ * \return Name of the spill file kept by a failed close or by a previous session, empty if there is no such file.
+ * \remark EVLRs are stored in the spill file one after another, each starting with its LasEVLRHeader.
+ */
+QString LasFile::getEVLRSpillFileName()
+{
+    QString spillFileName = this->dataFile.fileName() + LAS_EVLR_SPILL_EXTENSION;
+
+    if (this->dataFile.fileName().isEmpty() || !QFile::exists(spillFileName)) return QString();
+    return spillFileName;
+}
+
+
+/*!
+ * \brief Gets the stamp of the las-file stored in sidecar files.
+ * \param stamp Returns the size, the modification time and the checksum of the header stored in the file.
+ * \return True, if the header was read successfully.
+ * \remark Changes of the las-file not yet written to the file are not included.
+ */
+bool LasFile::getFileStamp(LasFileStamp &stamp)
+{
+    QFileInfo fileInfo(this->dataFile.fileName());
+    char *buf;
+    bool error;
+
+    memset(&stamp, 0, sizeof(LasFileStamp));
+    if (!this->dataFile.isOpen() || this->dataFileHeader.headerSize == 0) return false;
+
+    buf = new char[this->dataFileHeader.headerSize];
+    error = !readAt(0, buf, this->dataFileHeader.headerSize);
+    if (!error)
+    {
+        // FNV-1a
+        stamp.headerChecksum = 14695981039346656037ULL;
+        for (quint16 i = 0; i < this->dataFileHeader.headerSize; i++)
+        {
+            stamp.headerChecksum ^= quint8(buf[i]);
+            stamp.headerChecksum *= 1099511628211ULL;
+        }
+    }
+    delete [] buf;
+
+    stamp.lasFileSize = fileInfo.size();
+    stamp.lasFileModified = fileInfo.lastModified().toMSecsSinceEpoch();
+    return !error;
+}
+
+
+/*!
+ * \brief Returns the offset following point data.
+ * \return Offset following the last point record, or the chunk table of a compressed file.
+ */
+qint64 LasFile::getPointDataEnd()
+{
+    const qint64 dataOffset = qint64(this->dataFileHeader.offset_to_point_data);
+
+    if (isCompressed()) return this->chunkTable.getEndOffset(dataOffset + qint64(sizeof(qint64))) + this->chunkTable.getTableLength();
+    return dataOffset + qint64(this->dataFileHeader.number_of_points) * this->dataFileHeader.point_record_length;
+}
+
+
+/*!
+ * \brief Sets up the cache of appended points and allocates the page cache of read points.
+ * \param pointCacheNumberOfRecords Number of records in the cache of appended points and in all pages together.
+ * \param pointCacheNPages Number of pages.
+ * \return True, if the cache was allocated.
+ * \remark If pointCacheNumberOfRecords is zero, points are read and written directly. Pages are not allocated for a mapped file.
+ * \remark The cache of appended points is allocated on the first append, only for writable files, see allocateAppendCache.
+ * \remark Pages of compressed files are chunks and they are always allocated. The cache of appended points holds whole chunks
+ *         and it is used only for an empty writable file.
+ */
+bool LasFile::allocatePointCache(qint64 pointCacheNumberOfRecords, int pointCacheNPages)
+{
+    qint64 pageNRecords;
+
+    if (this->cacheData != nullptr)
+    {
+        delete [] this->cacheData;
+        this->cacheData = nullptr;
+    }
+    this->pageCache.release();
+
+    this->cacheFirstRecord = -1;
+    this->cacheLastRecord = -1;
+    this->cacheNumberOfRecords = 0;
+    if (isCompressed())
+    {
+        pageNRecords = this->chunkTable.getChunkNRecords();
+        if (pointCacheNPages < 1) pointCacheNPages = 1;
+        this->pageCache.allocate(&this->dataFile, this->dataFileHeader.offset_to_point_data, this->dataFileHeader.point_record_length, pageNRecords, pointCacheNPages);
+
+        if (this->dataFile.isWritable() && this->dataFileHeader.number_of_points == 0)
+            this->cacheNumberOfRecords = qMax(qint64(1), (pointCacheNumberOfRecords + pageNRecords - 1) / pageNRecords) * pageNRecords;
+    }
+    else if (0 < pointCacheNumberOfRecords)
+    {
+        if (this->dataFile.isWritable()) this->cacheNumberOfRecords = pointCacheNumberOfRecords;
+
+        // points of a mapped file are read from the mapped memory
+        if (!isMapped())
+        {
+            if (pointCacheNPages < 1) pointCacheNPages = 1;
+            pageNRecords = pointCacheNumberOfRecords / pointCacheNPages;
+            if (pageNRecords < 1) pageNRecords = 1;
+            this->pageCache.allocate(&this->dataFile, this->dataFileHeader.offset_to_point_data, this->dataFileHeader.point_record_length, pageNRecords, pointCacheNPages);
+        }
+    }
+    this->cacheLength = this->dataFileHeader.point_record_length * this->cacheNumberOfRecords;
+
+    this->cacheChanged = false;
+    return true;
 }
 
 
 /*!
- * \brief Decodes Point10 from byte array.
- * \param buf Buffer.
- * \param lasPoint LAS point to be loaded with data.
- * \remark Point8 + waveform
- * \remark size = 67
+ * \brief Allocates the cache of appended points set up by allocatePointCache.
+ * \return True, if the cache is allocated.
+ * \remark The cache is allocated by the first append, files open only for reading never allocate it.
  */
-void LasFile::decodePoint10(char *buf, LasPoint &lasPoint)
+bool LasFile::allocateAppendCache()
 {
-    decodePoint8(buf, lasPoint);
-    lasPoint.waveformPacketIndex = quint8(buf[38]);
-    lasPoint.waveformDataOffset = *reinterpret_cast<quint64*>(buf + 39);
-    lasPoint.waveformPacketSize = *reinterpret_cast<quint32*>(buf + 47);
-    lasPoint.waveformLocation = *reinterpret_cast<float*>(buf + 51);
-    lasPoint.xt = *reinterpret_cast<float*>(buf + 55);
-    lasPoint.yt = *reinterpret_cast<float*>(buf + 59);
-    lasPoint.zt = *reinterpret_cast<float*>(buf + 63);
+    if (this->cacheData != nullptr) return true;
+    if (!this->dataFile.isWritable() || this->cacheLength <= 0) return false;
+
+    this->cacheData = new char[quint64(this->cacheLength)];
+    memset(this->cacheData, 0, size_t(this->cacheLength));
+    return true;
 }
 
 
 /*!
- * \brief Allocates memory and copy extra user data.
- * \param buf Input byte array.
- * \param lasPoint Target las-point.
+ * \brief CLasfile::WritePointCache
+ * \return True, if cache was written to las-file successfully.
+ * \remark Cache is written only if it was changed.
+ * \remark Points queued for the background writer are written first, dirty pages are written last.
+ * \remark Appended points of a compressed file are written in complete chunks, queued chunks are written first.
  */
-void LasFile::decodeExtraData(char *buf, LasPoint &lasPoint)
+bool LasFile::writePointCache()
 {
-    quint32 standardRecordLength;
+    qint64 nRecords, nLength;
+    bool error = false;
 
-    standardRecordLength = getStandardPointRecordLength();
-    if (standardRecordLength < this->dataFileHeader.point_record_length)
+    if (isCompressed()) return (this->cacheData == nullptr || (writeCompressedChunks(false) && flushCompressedChunks()));
+    if (this->writeBehind != nullptr) error = !this->writeBehind->flush();
+
+    if (!error && this->cacheChanged && 0 <= this->cacheFirstRecord && 0 < this->dataFileHeader.number_of_points)
     {
-        lasPoint.extraDataLength = standardRecordLength - this->dataFileHeader.point_record_length;
-        lasPoint.extraData= new char[lasPoint.extraDataLength];
-        memcpy(lasPoint.extraData, buf + standardRecordLength, lasPoint.extraDataLength);
+        if (this->dataFile.seek(this->dataFileHeader.offset_to_point_data + this->cacheFirstRecord * this->dataFileHeader.point_record_length))
+        {
+            nRecords = this->cacheLastRecord - this->cacheFirstRecord + 1;
+            nLength = nRecords * this->dataFileHeader.point_record_length;
+            error = (this->dataFile.write(this->cacheData, nLength) != nLength);
+            this->cacheChanged = error;
+        }
     }
-}
-
-
 
+    if (!error) error = !this->pageCache.flush();
 
+    return !error;
+}
 
-/*!
- * *****************************************************************
- * Point encoders
- * *****************************************************************
- */
 
 /*!
- * \brief Dummy encoder, does nothing.
- * \param buf Buffer.
- * \param lasPoint LAS point to be loaded with data.
+ * \brief CLasfile::ReadPointCache
+ * \param iPoint Index of required point.
+ * \param nRecords Returns the number of consecutive records available from the returned pointer.
+ * \return Pointer to the record of iPoint in the loaded page, nullptr if the page cannot be loaded.
+ * \remark Loads the page of the requested point, the least recently used page is evicted and written, if it was changed.
+ * \remark In read-ahead mode pages are taken from the background reader, pages of compressed files are decompressed chunks.
  */
-void LasFile::encodePointNull(LasPoint &, char *)
+char *LasFile::readPointCache(qint64 iPoint, qint64 &nRecords)
 {
+    qint64 nFileRecords, iPage, firstRecord;
+    char *buf;
+    bool error;
+
+    nRecords = 0;
+    if (!this->dataFile.isReadable() || !this->pageCache.isAllocated()) return nullptr;
+    if (this->writeBehind != nullptr && !this->writeBehind->flush()) return nullptr;
+
+    // appended points held in the cache are not stored in the file yet
+    nFileRecords = (0 <= this->cacheFirstRecord ? this->cacheFirstRecord : qint64(this->dataFileHeader.number_of_points));
+    if (iPoint < 0 || nFileRecords <= iPoint) return nullptr;
+
+    if (isReadingAhead() || isCompressed())
+    {
+        // pages are read by the background thread in the order of the file or decompressed from chunks
+        iPage = iPoint / this->pageCache.getPageNRecords();
+        firstRecord = iPage * this->pageCache.getPageNRecords();
+        buf = this->pageCache.detachPage(iPage);
+        if (buf == nullptr) return nullptr;
+        if (isCompressed() && this->chunkDecoder != nullptr)
+            error = !this->chunkDecoder->fetch(iPage, buf, nRecords);
+        else if (isCompressed())
+        {
+            // appended chunks must be written before reading
+            error = (this->chunkTable.getNumberOfChunks() <= iPage && !flushCompressedChunks());
+            if (!error) error = (this->dataFile.isWritable() && !this->dataFile.flush()) || !readChunkAt(iPage, buf, nRecords);
+        }
+        else
+            error = !this->readAhead->fetch(firstRecord, buf, nRecords);
+        if (!error) error = (nRecords <= iPoint - firstRecord);
+        buf = this->pageCache.attachPage(iPage, buf, error ? 0 : nRecords);
+        if (error || buf == nullptr)
+        {
+            nRecords = 0;
+            return nullptr;
+        }
+        nRecords -= iPoint - firstRecord;
+        return buf + (iPoint - firstRecord) * this->dataFileHeader.point_record_length;
+    }
+
+    return this->pageCache.load(iPoint, nFileRecords, nRecords);
 }
 
 
 /*!
- * \brief Encode Point0 to byte array.
- * \param lasPoint LAS point to be loaded with data.
- * \param buf Buffer.
- * \remark x, y, z, intensity, flag, classification, userData, sourceId
- * \remark size = 20
- * \remark Coordinates must be scaled!
+ * \brief Writes the full point cache of appended points and empties the cache.
+ * \return True, if points were written or queued for writing successfully.
+ * \remark In write-behind mode the cache is handed over to the background writer and replaced by a free buffer.
  */
-void LasFile::encodePoint0(LasPoint &lasPoint, char *buf)
+bool LasFile::flushAppendedPoints()
 {
-    quint8 flag;
-
-    *reinterpret_cast<qint32*>(buf) = lasPoint.ix;
-    *reinterpret_cast<qint32*>(buf + 4) = lasPoint.iy;
-    *reinterpret_cast<qint32*>(buf + 8) = lasPoint.iz;
+    qint64 nRecords, nLength;
+    bool error = false;
 
-    *reinterpret_cast<quint16*>(buf + 12) = lasPoint.intensity;
+    if (isCompressed()) return writeCompressedChunks(false);
 
-    flag = (lasPoint.returnNumber & 7) | ((lasPoint.numberOfReturns << 3) & 7);
-    buf[14] = char(flag);
+    if (this->writeBehind != nullptr && this->cacheChanged && 0 <= this->cacheFirstRecord)
+    {
+        nRecords = this->cacheLastRecord - this->cacheFirstRecord + 1;
+        nLength = nRecords * this->dataFileHeader.point_record_length;
+        error = !this->writeBehind->submit(this->dataFileHeader.offset_to_point_data + this->cacheFirstRecord * this->dataFileHeader.point_record_length,
+                                           this->cacheData, nLength);
+        this->cacheChanged = false;
+    }
+    else
+        error = !writePointCache();
 
-    buf[15] = char(lasPoint.classification);
-    buf[16] = char(lasPoint.scanAngle & 255);
-    buf[17] = char(lasPoint.userData);
-    *reinterpret_cast<quint16*>(buf + 18) = lasPoint.sourceID;
+    this->cacheFirstRecord = -1;
+    this->cacheLastRecord = -1;
+    return !error;
 }
 
 
 /*!
- * \brief Encodes Point1 to byte array.
- * \param lasPoint LAS point to be loaded with data.
- * \param buf Buffer.
- * \remark Point0 + gpsTime
- * \remark size = 28
- * \remark Coordinates must be scaled!
+ * \brief Compresses appended points held in the cache and writes them as chunks.
+ * \param lastChunk If true, the last incomplete chunk is written too.
+ * \return True, if chunks were written successfully.
+ * \remark Records of an incomplete chunk are moved to the beginning of the cache and wait for following points.
+ * \remark If the chunk encoder runs, chunks are queued for compression by worker threads, see flushCompressedChunks.
  */
-void LasFile::encodePoint1(LasPoint &lasPoint, char *buf)
+bool LasFile::writeCompressedChunks(bool lastChunk)
 {
-    encodePoint0(lasPoint, buf);
-    *reinterpret_cast<double*>(buf + 20) = lasPoint.gpsTime;
+    const qint64 chunkNRecords = this->chunkTable.getChunkNRecords();
+    const quint16 recordLength = this->dataFileHeader.point_record_length;
+    QByteArray chunk;
+    qint64 nRecords, iRecord = 0, n, offset;
+    bool error = false;
+
+    if (this->cacheData == nullptr || this->cacheFirstRecord < 0) return true;
+
+    nRecords = this->cacheLastRecord - this->cacheFirstRecord + 1;
+    offset = this->chunkTable.getEndOffset(qint64(this->dataFileHeader.offset_to_point_data) + qint64(sizeof(qint64)));
+    while (iRecord < nRecords && !error && (lastChunk || chunkNRecords <= nRecords - iRecord))
+    {
+        n = qMin(chunkNRecords, nRecords - iRecord);
+        if (this->chunkEncoder != nullptr)
+            error = !this->chunkEncoder->submit(this->cacheData + iRecord * recordLength, n);
+        else
+        {
+            error = !LasChunkCodec::encode(this->cacheData + iRecord * recordLength, n, recordLength, GpsTimeOffset[this->dataFileHeader.point_format], chunk);
+            if (!error) error = !this->dataFile.seek(offset);
+            if (!error) error = (this->dataFile.write(chunk.constData(), chunk.size()) != chunk.size());
+            if (!error) error = !this->chunkTable.append(offset, n, chunk.size());
+            if (!error) offset += chunk.size();
+        }
+        if (!error) iRecord += n;
+    }
+
+    if (nRecords <= iRecord)
+    {
+        this->cacheFirstRecord = -1;
+        this->cacheLastRecord = -1;
+    }
+    else if (0 < iRecord)
+    {
+        memmove(this->cacheData, this->cacheData + iRecord * recordLength, size_t((nRecords - iRecord) * recordLength));
+        this->cacheFirstRecord += iRecord;
+    }
+    this->cacheChanged = (0 <= this->cacheFirstRecord);
+
+    return !error;
 }
 
 
 /*!
- * \brief Encodes Point2 to byte array.
- * \param lasPoint LAS point to be loaded with data.
- * \param buf Buffer.
- * \remark Point0 + r, g, b
- * \remark size = 26
- * \remark Coordinates must be scaled!
+ * \brief Waits until chunks queued in the chunk encoder are written and adds them to the chunk table.
+ * \return True, if all queued chunks were written successfully.
  */
-void LasFile::encodePoint2(LasPoint &lasPoint, char *buf)
+bool LasFile::flushCompressedChunks()
 {
-    encodePoint0(lasPoint, buf);
-    *reinterpret_cast<quint16*>(buf + 20) = lasPoint.r;
-    *reinterpret_cast<quint16*>(buf + 22) = lasPoint.g;
-    *reinterpret_cast<quint16*>(buf + 24) = lasPoint.b;
+    QVector<LasCompressedChunk> chunks;
+    bool error;
+
+    if (this->chunkEncoder == nullptr) return true;
+
+    error = !this->chunkEncoder->flush();
+    this->chunkEncoder->takeWrittenChunks(chunks);
+    for (int i = 0; i < chunks.size() && !error; i++)
+        error = !this->chunkTable.append(qint64(chunks[i].offset), chunks[i].numberOfRecords, chunks[i].numberOfBytes);
+    return !error;
 }
 
 
 /*!
- * \brief Encodes Point3 to byte array.
- * \param lasPoint LAS point to be loaded with data.
- * \param buf Buffer.
- * \remark Point1 + r, g, b
- * \remark size = 34
- * \remark Coordinates must be scaled!
+ * \brief Writes the last chunk of appended points and the chunk table of a compressed las-file.
+ * \return True, if the table was written successfully or the file is not a compressed file open for appending.
+ * \remark The table follows the last chunk, its offset is stored at the beginning of point data.
  */
-void LasFile::encodePoint3(LasPoint &lasPoint, char *buf)
+bool LasFile::writeChunkTable()
 {
-    encodePoint1(lasPoint, buf);
-    *reinterpret_cast<quint16*>(buf + 28) = lasPoint.r;
-    *reinterpret_cast<quint16*>(buf + 30) = lasPoint.g;
-    *reinterpret_cast<quint16*>(buf + 32) = lasPoint.b;
+    const qint64 dataOffset = qint64(this->dataFileHeader.offset_to_point_data);
+    qint64 tableOffset = 0;
+    bool error;
+
+    if (!isCompressed() || !this->dataFile.isWritable() || this->cacheNumberOfRecords == 0) return true;
+
+    error = !writeCompressedChunks(true);
+    if (!error)
+    {
+        tableOffset = this->chunkTable.getEndOffset(dataOffset + qint64(sizeof(qint64)));
+        error = !this->chunkTable.write(this->dataFile, tableOffset);
+    }
+    if (!error) error = !this->dataFile.seek(dataOffset);
+    if (!error) error = (this->dataFile.write(reinterpret_cast<char*>(&tableOffset), sizeof(qint64)) != sizeof(qint64));
+
+    return !error;
 }
 
 
 /*!
- * \brief Encodes Point4 to byte array.
- * \param lasPoint LAS point to be loaded with data.
- * \param buf Buffer.
- * \remark Point1 + waveform
- * \remark size = 57
- * \remark Coordinates must be scaled!
+ * \brief Reads the chunk table of a compressed las-file.
+ * \return True, if the table was read and it describes all points of the file.
  */
-void LasFile::encodePoint4(LasPoint &lasPoint, char *buf)
+bool LasFile::readChunkTable()
 {
-    encodePoint1(lasPoint, buf);
-    buf[28] = char(lasPoint.waveformPacketIndex);
-    *reinterpret_cast<quint64*>(buf + 29) = lasPoint.waveformDataOffset;
-    *reinterpret_cast<quint32*>(buf + 37) = lasPoint.waveformPacketSize;
-    *reinterpret_cast<float*>(buf + 41) = lasPoint.waveformLocation;
-    *reinterpret_cast<float*>(buf + 45) = lasPoint.xt;
-    *reinterpret_cast<float*>(buf + 49) = lasPoint.yt;
-    *reinterpret_cast<float*>(buf + 53) = lasPoint.zt;
+    qint64 tableOffset;
+
+    if (!readAt(qint64(this->dataFileHeader.offset_to_point_data), reinterpret_cast<char*>(&tableOffset), sizeof(qint64))) return false;
+    if (!this->chunkTable.read(this->dataFile, tableOffset)) return false;
+    return (this->chunkTable.getNumberOfRecords() == this->dataFileHeader.number_of_points);
 }
 
 
 /*!
- * \brief Encodes Point5 to byte array.
- * \param lasPoint LAS point to be loaded with data.
- * \param buf Buffer.
- * \remark Point3 + waveform
- * \remark size = 63
- * \remark Coordinates must be scaled!
+ * \brief Removes the spatial index sidecar file, which does not describe updated coordinates.
+ * \remark The file is removed once per open las-file.
  */
-void LasFile::encodePoint5(LasPoint &lasPoint, char *buf)
+void LasFile::removeSpatialIndex()
 {
-    encodePoint3(lasPoint, buf);
-    buf[34] = char(lasPoint.waveformPacketIndex);
-    *reinterpret_cast<quint64*>(buf + 35) = lasPoint.waveformDataOffset;
-    *reinterpret_cast<quint32*>(buf + 43) = lasPoint.waveformPacketSize;
-    *reinterpret_cast<float*>(buf + 47) = lasPoint.waveformLocation;
-    *reinterpret_cast<float*>(buf + 51) = lasPoint.xt;
-    *reinterpret_cast<float*>(buf + 55) = lasPoint.yt;
-    *reinterpret_cast<float*>(buf + 59) = lasPoint.zt;
+    if (this->spatialIndexRemoved) return;
+    QFile::remove(LasSpatialIndex::indexFileName(getFileName()));
+    this->spatialIndexRemoved = true;
 }
 
 
 /*!
- * \brief Encodes Point6 to byte array.
- * \param lasPoint LAS point to be loaded with data.
- * \param buf Buffer.
- * \remark x, y, z, intensity, flag, classificationFlag, classification, userData, scanAngle, sourceId, gpsTime
- * \remark size = 30
- * \remark Coordinates must be scaled!
+ * \brief Reads the chunk codec VLR, which marks point records compressed by LasChunkCodec, and the chunk table.
+ * \return True, if the file holds no chunk codec VLR or the VLR describes chunks of the chunk table.
+ * \remark The point format in the file header is not changed by the compression, the VLR alone marks compressed files.
  */
-void LasFile::encodePoint6(LasPoint &lasPoint, char *buf)
+bool LasFile::readChunkCodecVLR()
 {
-    quint8 flag;
-
-    *reinterpret_cast<qint32*>(buf) = lasPoint.ix;
-    *reinterpret_cast<qint32*>(buf + 4) = lasPoint.iy;
-    *reinterpret_cast<qint32*>(buf + 8) = lasPoint.iz;
+    qint64 iVLR;
+    LasVLR vlr;
+    LasVLRChunkCodec codec;
 
-    *reinterpret_cast<quint16*>(buf + 12) = lasPoint.intensity;
+    this->compression = LAS_COMPRESSION_NONE;
+    iVLR = findVLR(LAS_VLR_CHUNK_CODEC_USERID, LAS_VLR_CHUNK_CODEC_RECORDID);
+    if (iVLR < 0) return true;
+    if (!readVLR(iVLR, vlr)) return false;
+    if (vlr.header.recordLength < sizeof(LasVLRChunkCodec)) return false;
 
-    flag = (lasPoint.returnNumber & 15) | ((lasPoint.numberOfReturns << 4) & 15);
-    buf[14] = char(flag);
+    memcpy(&codec, vlr.data, sizeof(LasVLRChunkCodec));
+    if (codec.version != LAS_VLR_CHUNK_CODEC_VERSION) return false;
 
-    buf[15] = char(lasPoint.classificationFlag);
-    buf[16] = char(lasPoint.classification);
-    buf[17] = char(lasPoint.userData);
-    *reinterpret_cast<qint16*>(buf + 18) = lasPoint.scanAngle;
-    *reinterpret_cast<quint16*>(buf + 20) = lasPoint.sourceID;
-    *reinterpret_cast<double*>(buf + 22) = lasPoint.gpsTime;
+    this->compression = LAS_COMPRESSION_CHUNKED;
+    if (!readChunkTable()) return false;
+    return (codec.chunkNRecords == this->chunkTable.getChunkNRecords());
 }
 
 
 /*!
- * \brief Encodes Point7 to byte array.
- * \param lasPoint LAS point to be loaded with data.
- * \param buf Buffer.
- * \remark Point6 + r, g, b
- * \remark size = 36
- * \remark Coordinates must be scaled!
+ * \brief Appends the chunk codec VLR marking point records compressed by LasChunkCodec.
+ * \return True, if the VLR was appended successfully.
  */
-void LasFile::encodePoint7(LasPoint &lasPoint, char *buf)
+bool LasFile::appendChunkCodecVLR()
 {
-    encodePoint6(lasPoint, buf);
-    *reinterpret_cast<quint16*>(buf + 30) = lasPoint.r;
-    *reinterpret_cast<quint16*>(buf + 32) = lasPoint.g;
-    *reinterpret_cast<quint16*>(buf + 34) = lasPoint.b;
-}
+    LasVLR vlr;
+    LasVLRChunkCodec codec;
 
+    memset(&codec, 0, sizeof(LasVLRChunkCodec));
+    codec.version = LAS_VLR_CHUNK_CODEC_VERSION;
+    codec.chunkNRecords = this->chunkTable.getChunkNRecords();
 
-/*!
- * \brief Encodes Point8 to byte array.
- * \param lasPoint LAS point to be loaded with data.
- * \param buf Buffer.
- * \remark Point7 + ir
- * \remark size = 38
- * \remark Coordinates must be scaled!
- */
-void LasFile::encodePoint8(LasPoint &lasPoint, char *buf)
-{
-    encodePoint7(lasPoint, buf);
-    *reinterpret_cast<quint16*>(buf + 36) = lasPoint.ir;
+    memset(&vlr.header, 0, sizeof(LasVLRHeader));
+    strncpy(vlr.header.userID, LAS_VLR_CHUNK_CODEC_USERID, LAS_VLR_USERID_LENGTH);
+    strncpy(vlr.header.description, "G3DTLas chunk codec", LAS_VLR_DESCRIPTION_LENGTH);
+    vlr.header.recordID = LAS_VLR_CHUNK_CODEC_RECORDID;
+    vlr.header.recordLength = sizeof(LasVLRChunkCodec);
+    vlr.data = new char[sizeof(LasVLRChunkCodec)];
+    memcpy(vlr.data, &codec, sizeof(LasVLRChunkCodec));
+
+    return appendVLR(vlr);
 }
 
 
 /*!
- * \brief Encodes Point9 to byte array.
- * \param lasPoint LAS point to be loaded with data.
- * \param buf Buffer.
- * \remark Point6 + waveform
- * \remark size = 59
- * \remark Coordinates must be scaled!
+ * \brief Reads and decompresses a chunk of point records.
+ * \param iChunk Index of the chunk.
+ * \param buf Buffer for the chunk records.
+ * \param nRecords Returns the number of records of the chunk.
+ * \return True, if the chunk was read successfully.
+ * \remark Thread-safe, used by the point cache and by readers of LasFileReader.
  */
-void LasFile::encodePoint9(LasPoint &lasPoint, char *buf)
+bool LasFile::readChunkAt(qint64 iChunk, char *buf, qint64 &nRecords)
 {
-    encodePoint6(lasPoint, buf);
-    buf[30] = char(lasPoint.waveformPacketIndex);
-    *reinterpret_cast<quint64*>(buf + 31) = lasPoint.waveformDataOffset;
-    *reinterpret_cast<quint32*>(buf + 39) = lasPoint.waveformPacketSize;
-    *reinterpret_cast<float*>(buf + 43) = lasPoint.waveformLocation;
-    *reinterpret_cast<float*>(buf + 47) = lasPoint.xt;
-    *reinterpret_cast<float*>(buf + 51) = lasPoint.yt;
-    *reinterpret_cast<float*>(buf + 55) = lasPoint.zt;
-}
+    QByteArray chunk;
+    LasCompressedChunk chunkInfo;
 
+    nRecords = 0;
+    if (iChunk < 0 || this->chunkTable.getNumberOfChunks() <= iChunk) return false;
 
-/*!
- * \brief Encodes Point10 to byte array.
- * \param lasPoint LAS point to be loaded with data.
- * \param buf Buffer.
- * \remark Point8 + waveform
- * \remark size = 67
- * \remark Coordinates must be scaled!
- */
-void LasFile::encodePoint10(LasPoint &lasPoint, char *buf)
-{
-    encodePoint8(lasPoint, buf);
-    buf[38] = char(lasPoint.waveformPacketIndex);
-    *reinterpret_cast<quint64*>(buf + 39) = lasPoint.waveformDataOffset;
-    *reinterpret_cast<quint32*>(buf + 47) = lasPoint.waveformPacketSize;
-    *reinterpret_cast<float*>(buf + 51) = lasPoint.waveformLocation;
-    *reinterpret_cast<float*>(buf + 55) = lasPoint.xt;
-    *reinterpret_cast<float*>(buf + 59) = lasPoint.yt;
-    *reinterpret_cast<float*>(buf + 63) = lasPoint.zt;
+    chunkInfo = this->chunkTable.getChunk(iChunk);
+    chunk.resize(int(chunkInfo.numberOfBytes));
+    if (!readAt(qint64(chunkInfo.offset), chunk.data(), chunkInfo.numberOfBytes)) return false;
+    if (!LasChunkCodec::decode(chunk, this->dataFileHeader.point_record_length, GpsTimeOffset[this->dataFileHeader.point_format], buf, chunkInfo.numberOfRecords)) return false;
+
+    nRecords = chunkInfo.numberOfRecords;
+    return true;
 }
 
 
 /*!
- * \brief Encodes extra data.
- * \param lasPoint Input las-point.
- * \param buf Pointer to the output buffer.
+ * \brief Maps the whole las-file into memory.
+ * \return True, if the file was mapped successfully.
+ * \remark Only the point records stored in the file at the time of mapping are accessed through the mapping.
+ *         Appended points are read through the point cache. Compressed point data are not mapped.
  */
-void LasFile::encodeExtraData(LasPoint &lasPoint, char *buf)
+bool LasFile::mapPointData()
 {
-    if (0 < lasPoint.extraDataLength)
-    {
-        memcpy(buf + getStandardPointRecordLength(), lasPoint.extraData, lasPoint.extraDataLength);
-    }
-}
+    qint64 fileSize;
+    qint64 nRecords;
 
+    unmapPointData();
+    if (!this->dataFile.isOpen() || this->dataFileHeader.point_record_length == 0 || isCompressed()) return false;
 
+    fileSize = this->dataFile.size();
+    nRecords = (fileSize - qint64(this->dataFileHeader.offset_to_point_data)) / this->dataFileHeader.point_record_length;
+    if (qint64(this->dataFileHeader.number_of_points) < nRecords) nRecords = qint64(this->dataFileHeader.number_of_points);
+    if (nRecords <= 0) return false;
 
+    this->mappedData = this->dataFile.map(0, fileSize);
+    if (this->mappedData == nullptr) return false;
 
+    this->mappedNumberOfRecords = nRecords;
+    return true;
+}
 
-/*!
- * *****************************************************************
- * LasFile I/O
- * *****************************************************************
- */
 
 /*!
- * \brief Writes LAS 1.4 this->header.
- * \return True, if las-file header was written successfully.
+ * \brief Releases the memory mapping of the las-file.
  */
-bool LasFile::writeHeader()
+void LasFile::unmapPointData()
 {
-    bool error = false;
-
-    if (this->dataFile.isOpen() && this->dataFile.isWritable() && this->headerChanged)
+    if (this->mappedData != nullptr)
     {
-        error = !this->dataFile.seek(0);
-        if (!error) error = (this->dataFile.write(reinterpret_cast<char*>(&this->dataFileHeader), this->dataFileHeader.headerSize) != this->dataFileHeader.headerSize);
-        this->headerChanged = error;
+        this->dataFile.unmap(this->mappedData);
+        this->mappedData = nullptr;
     }
-
-    return !error;
+    this->mappedNumberOfRecords = 0;
 }
 
 
 /*!
- * \brief Updates minimum and maximum of coordinates (x0, x1, y0, y1, z0, z1), points by return values.
- * \return True, if header was updated successfully.
+ * \brief Copies point records of another las-file into this las-file without decoding.
+ * \param las Source las-file.
+ * \param firstPoint Index of the first copied point in the source las-file.
+ * \param nPoints Number of copied points.
+ * \param targetOffset Offset in this las-file, where the first record is written.
+ * \return True, if all records were copied successfully.
+ * \remark Records of a compressed source las-file are decompressed chunk by chunk.
  */
-bool LasFile::updateHeader()
+bool LasFile::copyPointRecords(LasFile &las, qint64 firstPoint, qint64 nPoints, qint64 targetOffset)
 {
+    qint64 nRecords, nLength;
+    char *buf;
     bool error = false;
-    LasPoint p;
-
-    if (!this->pointsChanged) return true;
-
-    this->dataFileHeader.x0 = DBL_MAX;
-    this->dataFileHeader.x1 = -DBL_MAX;
-    this->dataFileHeader.y0 = DBL_MAX;
-    this->dataFileHeader.y1 = -DBL_MAX;
-    this->dataFileHeader.z0 = DBL_MAX;
-    this->dataFileHeader.z1 = -DBL_MAX;
-
-    for(int i = 0; i < LAS14_NUMBER_OF_POINTS_BY_RETURN_FIELDS; i++)
-        this->dataFileHeader.number_of_points_by_return[i] = 0;
 
-    for(qint64 iPoint=0; iPoint<qint64(this->dataFileHeader.number_of_points) && !error; iPoint++)
+    if (las.isCompressed())
     {
-        error = !readPoint(iPoint, p);
-        if (!error)
+        nRecords = las.chunkTable.getChunkNRecords();
+        buf = new char[size_t(nRecords * las.dataFileHeader.point_record_length)];
+        error = !this->dataFile.seek(targetOffset);
+        while (0 < nPoints && !error)
         {
-            if (p.x < this->dataFileHeader.x0) this->dataFileHeader.x0 = p.x;
-            if (this->dataFileHeader.x1 < p.x) this->dataFileHeader.x1 = p.x;
-            if (p.y < this->dataFileHeader.y0) this->dataFileHeader.y0 = p.y;
-            if (this->dataFileHeader.y1 < p.y) this->dataFileHeader.y1 = p.y;
-            if (p.z < this->dataFileHeader.z0) this->dataFileHeader.z0 = p.z;
-            if (this->dataFileHeader.z1 < p.z) this->dataFileHeader.z1 = p.z;
-
-            if (p.returnNumber <= LAS14_NUMBER_OF_POINTS_BY_RETURN_FIELDS && 0 < p.returnNumber)
-                this->dataFileHeader.number_of_points_by_return[p.returnNumber - 1]++;
-            else
-                this->dataFileHeader.number_of_points_by_return[LAS14_NUMBER_OF_POINTS_BY_RETURN_FIELDS-1]++;
+            if (nPoints < nRecords) nRecords = nPoints;
+            nLength = nRecords * las.dataFileHeader.point_record_length;
+            error = !las.readPoints(firstPoint, nRecords, buf);
+            if (!error) error = (this->dataFile.write(buf, nLength) != nLength);
+            firstPoint += nRecords;
+            nPoints -= nRecords;
         }
+        delete[] buf;
+        return !error;
     }
 
-    this->headerChanged = true;
-    this->pointsChanged = false;
-    return !error;
+    return LasCopyTask::copy(las.dataFile, qint64(las.dataFileHeader.offset_to_point_data) + firstPoint * las.dataFileHeader.point_record_length,
+                             this->dataFile, targetOffset, nPoints * las.dataFileHeader.point_record_length);
 }
 
 
 /*!
- * \brief Copy all VRLs from las-file template.
- * \param lasTtemplate Las-file.
- * \return True, if VRLs were copied successfully.
- * \todo Copy only necessary VRLs. Do not copy superseded VRLs.
+ * \brief Starts the background reading of point cache windows.
+ * \return True, if the background reader was started.
+ * \remark The point cache must be allocated. Chunks of compressed files are decompressed by worker threads.
  */
-bool LasFile::copyVRLs(LasFile &lasTemplate)
+bool LasFile::startReadAhead()
 {
-    bool error = false;
-    qint64 iVLR;
-    LasVLR vlr;
+    stopReadAhead();
+    if (!this->dataFile.isOpen() || !this->pageCache.isAllocated() || this->dataFileHeader.number_of_points == 0) return false;
 
-    for(iVLR=0; iVLR < lasTemplate.getNumberOfVLRs() && !error; iVLR++)
+    if (isCompressed())
     {
-        error = !lasTemplate.readVLR(iVLR, vlr);
-        if (!error) error = !appendVLR(vlr);
+        this->chunkDecoder = new LasChunkDecoder();
+        if (!this->chunkDecoder->begin(this, QThread::idealThreadCount()))
+        {
+            stopReadAhead();
+            return false;
+        }
+        return true;
     }
 
-    return !error;
+    this->readAhead = new LasReadAhead();
+    if (!this->readAhead->begin(this->dataFile.fileName(), this->dataFileHeader.offset_to_point_data, this->dataFileHeader.point_record_length,
+                                qint64(this->dataFileHeader.number_of_points), this->pageCache.getPageNRecords()))
+    {
+        stopReadAhead();
+        return false;
+    }
+    return true;
 }
 
 
 /*!
- * \brief Copy all EVRLs from template las-file.
- * \attention NOT IMPLEMENTED YET.
- * \param lasTemplate Source las-file.
- * \return True, if VLRs were copied successfully.
- * \todo implement it!
+ * \brief Stops the background reading of point cache windows.
  */
-bool LasFile::copyEVRLs(LasFile &lasTemplate)
+void LasFile::stopReadAhead()
 {
-    return false;
+    if (this->readAhead != nullptr)
+    {
+        delete this->readAhead;
+        this->readAhead = nullptr;
+    }
+    if (this->chunkDecoder != nullptr)
+    {
+        delete this->chunkDecoder;
+        this->chunkDecoder = nullptr;
+    }
 }
 
 
 /*!
- * \brief Allocates cache memory for points.
- * \param pointCacheNumberOfRecords Maximal number of records in thew cache memory (cache size in records).
- * \param pointCacheOffset
- * \return True, if cache memory was successfuly allocated.
+ * \brief Starts the background writing of appended points.
+ * \return True, if the background writer was started.
+ * \remark The cache of appended points must be set up, it is allocated by the first append. Chunks of compressed files are compressed by worker threads and written by a background writer.
  */
-bool LasFile::allocatePointCache(qint64 pointCacheNumberOfRecords, qint64 pointCacheOffset)
+bool LasFile::startWriteBehind()
 {
-    if (this->cacheData != nullptr)
-    {
-        delete [] this->cacheData;
-        this->cacheData = nullptr;
-    }
+    stopWriteBehind();
+    if (!this->dataFile.isWritable() || this->cacheNumberOfRecords == 0) return false;
 
-    if (0 < pointCacheNumberOfRecords)
+    // the background writer uses its own file handle, header written so far must reach the file
+    this->dataFile.flush();
+    if (isCompressed())
     {
-        // setup cache
-        if (pointCacheOffset < 0) pointCacheOffset = pointCacheNumberOfRecords + pointCacheOffset;
-        if (0 < pointCacheOffset && pointCacheNumberOfRecords <= pointCacheOffset) pointCacheOffset = pointCacheNumberOfRecords - 1;
-        if (pointCacheOffset < 0) pointCacheOffset = 0;
-
-        this->cacheFirstRecord = -1;
-        this->cacheLastRecord = -1;
-        this->cacheNumberOfRecords = pointCacheNumberOfRecords;
-        this->cacheLength = this->dataFileHeader.point_record_length * pointCacheNumberOfRecords;
-        this->cacheData = new char[quint64(this->cacheLength)];
-        memset(this->cacheData, 0, size_t(this->cacheLength));
-        this->cacheOffset = pointCacheOffset;
+        this->chunkEncoder = new LasChunkEncoder();
+        if (!this->chunkEncoder->begin(this->dataFile.fileName(), this->chunkTable.getEndOffset(qint64(this->dataFileHeader.offset_to_point_data) + qint64(sizeof(qint64))),
+                                       this->dataFileHeader.point_record_length, GpsTimeOffset[this->dataFileHeader.point_format],
+                                       this->chunkTable.getChunkNRecords(), QThread::idealThreadCount()))
+        {
+            stopWriteBehind();
+            return false;
+        }
+        return true;
     }
-    else
+
+    this->writeBehind = new LasWriteBehind();
+    if (!this->writeBehind->begin(this->dataFile.fileName(), this->cacheLength))
     {
-        this->cacheFirstRecord = -1;
-        this->cacheLastRecord = -1;
-        this->cacheNumberOfRecords = 0;
-        this->cacheLength = 0;
-        this->cacheData = nullptr;
-        this->cacheOffset = 0;
+        stopWriteBehind();
+        return false;
     }
-
-    this->cacheChanged = false;
     return true;
 }
 
 
 /*!
- * \brief CLasfile::WritePointCache
- * \return True, if cache was written to las-file successfully.
- * \remark Cache is written only if it was changed.
+ * \brief Writes queued points and stops the background writing.
+ * \return True, if all queued points were written successfully.
  */
-bool LasFile::writePointCache()
+bool LasFile::stopWriteBehind()
 {
-    qint64 nRecords, nLength;
     bool error = false;
 
-    if (this->cacheData == nullptr) return true;
-
-    if (this->cacheChanged && 0 <= this->cacheFirstRecord && 0 < this->dataFileHeader.number_of_points)
+    if (this->writeBehind != nullptr)
     {
-        if (this->dataFile.seek(this->dataFileHeader.offset_to_point_data + this->cacheFirstRecord * this->dataFileHeader.point_record_length))
-        {
-            nRecords = this->cacheLastRecord - this->cacheFirstRecord + 1;
-            nLength = nRecords * this->dataFileHeader.point_record_length;
-            error = (this->dataFile.write(this->cacheData, nLength) != nLength);
-            this->cacheChanged = error;
-        }
+        error = !this->writeBehind->end();
+        delete this->writeBehind;
+        this->writeBehind = nullptr;
+    }
+    if (this->chunkEncoder != nullptr)
+    {
+        error = !flushCompressedChunks();
+        if (!this->chunkEncoder->end()) error = true;
+        delete this->chunkEncoder;
+        this->chunkEncoder = nullptr;
     }
-
     return !error;
 }
 
 
 /*!
- * \brief CLasfile::ReadPointCache
- * \param iPoint Index of required point.
- * \return True, if cache was loaded successfully.
- * \remark Loads cache_number_of_records points into memory, so that the requested point is within the loaded cache.
- * \remark Changes in the cache are written into the las-file.
+ * \brief Gets the pointer to point records in memory.
+ * \param iPoint Index of the first required point.
+ * \param nRecords Returns the number of consecutive records available from the returned pointer.
+ * \return Pointer to the record of iPoint in the mapped memory, in the cache of appended points or in a cached page,
+ *         nullptr if there is no memory access to records.
+ * \remark The page of the point is loaded if it is not cached.
  */
-bool LasFile::readPointCache(qint64 iPoint)
+char *LasFile::pointRecords(qint64 iPoint, qint64 &nRecords)
 {
-    qint64 nRecords, nLength;
-    bool error = true;
+    char *buf;
 
-    if (!this->dataFile.isReadable() || this->cacheData == nullptr) return false;
+    nRecords = 0;
+    if (iPoint < 0) return nullptr;
 
-    if (0 <= iPoint && quint64(iPoint) < this->dataFileHeader.number_of_points)
+    if (iPoint < this->mappedNumberOfRecords)
     {
-        this->cacheFirstRecord = iPoint - this->cacheOffset;
-        if (this->cacheFirstRecord < 0) this->cacheFirstRecord = 0;
-        this->cacheLastRecord = this->cacheFirstRecord + this->cacheNumberOfRecords - 1;
-        if (this->dataFileHeader.number_of_points <= quint64(this->cacheLastRecord))
-        {
-            this->cacheLastRecord = qint64(this->dataFileHeader.number_of_points) - 1;
-            this->cacheFirstRecord = this->cacheLastRecord - this->cacheNumberOfRecords + 1;
-            if (this->cacheFirstRecord < 0) this->cacheFirstRecord = 0;
-        }
-        if (this->cacheFirstRecord <= iPoint && iPoint <= this->cacheLastRecord)
-        {
-            if (dataFile.seek(this->dataFileHeader.offset_to_point_data + this->cacheFirstRecord * this->dataFileHeader.point_record_length))
-            {
-                nRecords = this->cacheLastRecord - this->cacheFirstRecord + 1;
-                nLength = nRecords * this->dataFileHeader.point_record_length;
-                error = (this->dataFile.read(this->cacheData, nLength) != nLength);
-                this->cacheChanged = error;
-            }
-        }
-        else
-        {
-            this->cacheFirstRecord = -1;
-            this->cacheLastRecord = -1;
-        }
+        nRecords = this->mappedNumberOfRecords - iPoint;
+        return reinterpret_cast<char*>(this->mappedData) + this->dataFileHeader.offset_to_point_data + iPoint * this->dataFileHeader.point_record_length;
     }
 
-    return !error;
+    if (this->cacheFirstRecord <= iPoint && iPoint <= this->cacheLastRecord)
+    {
+        // appended point not written yet
+        nRecords = this->cacheLastRecord - iPoint + 1;
+        return this->cacheData + (iPoint - this->cacheFirstRecord) * this->dataFileHeader.point_record_length;
+    }
+
+    buf = this->pageCache.find(iPoint, nRecords);
+    if (buf == nullptr) buf = readPointCache(iPoint, nRecords);
+    return buf;
 }
@@ -21,14 +21,64 @@
  */
 
 #include <QFile>
+#include <QLockFile>
+#include <QMutex>
 #include "g3dtlas_global.h"
 #include "Point/laspoint.h"
+#include "Point/laspointbatch.h"
+#include "Point/laspointcodec.h"
+#include "Point/laspointstatistics.h"
+#include "Point/laspointfilter.h"
+#include "Point/lascoordinates.h"
+#include "IO/laspagecache.h"
+#include "IO/lasreadahead.h"
+#include "IO/laswritebehind.h"
+#include "IO/lascopytask.h"
+#include "IO/lasscantask.h"
+#include "IO/laschunkcodec.h"
+#include "IO/laschunkdecoder.h"
+#include "IO/laschunkencoder.h"
+#include "IO/laschunktable.h"
+#include "Index/lasfilestamp.h"
+#include "Index/laszonemap.h"
 #include "VLR/lasvlr.h"
+#include "VLR/lasvlrdirectory.h"
 #include "EVLR/lasevlr.h"
 #include "Fileheader/lasfileheader14.h"
 
 #define LAS_DEFAULT_CACHE_NRECORDS (1024*1024)
-#define LAS_DEFAULT_CACHE_OFFSET (0)
+#define LAS_DEFAULT_CACHE_OFFSET (0)        //!< not used, the point cache has no offset
+#define LAS_DEFAULT_CACHE_NPAGES (8)
+#define LAS_SCAN_CHUNK_NRECORDS (64*1024)   //!< default number of records in a chunk of the parallel scan
+#define LAS_MERGE_TASK_SIZE (256*1024*1024) //!< maximal number of bytes copied by one task of the parallel merge
+#define LAS_LAZ_FORMAT_MASK (0xC0)         //!< bits of the point format in the file header marking LAZ compressed point data, not supported
+#define LAS_EVLR_SPILL_EXTENSION ".evlr"    //!< extension of the temporary file holding EVLRs while point data may grow
+#define LAS_EVLR_LOCK_EXTENSION ".lock"     //!< extension of the lock file of the spill file, appended to the name of the spill file
+#define LAS_WAVEFORM_EVLR_USERID "LASF_Spec" //!< user ID of the EVLR of waveform data packets
+#define LAS_WAVEFORM_EVLR_RECORDID (65535)  //!< record ID of the EVLR of waveform data packets
+
+
+/*!
+ * \brief Access modes to point data of an open las-file.
+ */
+enum LasFileAccessMode
+{
+    LAS_ACCESS_CACHED = 0,  //!< point records are read into the point cache
+    LAS_ACCESS_MAPPED = 1,  //!< point records are decoded directly from the memory-mapped file, the point cache is used as a fallback
+    LAS_ACCESS_READ_AHEAD = 2,  //!< point cache windows following the current window are read by a background thread, compressed chunks are decompressed by worker threads
+    LAS_ACCESS_WRITE_BEHIND = 3, //!< full point caches of appended points are written by a background thread
+    LAS_ACCESS_CONCURRENT = 4   //!< read-only, points are read by LasFileReader objects of several threads from the mapped file or by positional reads
+};
+
+
+/*!
+ * \brief Storage of point records in the las-file.
+ */
+enum LasPointCompression
+{
+    LAS_COMPRESSION_NONE = 0,   //!< point records are stored as defined by the LAS specification
+    LAS_COMPRESSION_CHUNKED = 1 //!< chunks of point records are compressed by LasChunkCodec, the file is marked by the chunk codec VLR
+};
 
 
 /* General LAS-file structure
@@ -44,29 +94,53 @@
  */
 class G3DTLAS_EXPORT LasFile
 {
+    friend class LasFileReader;
+    friend class LasChunkDecoder;
+    friend class LasWaveformReader;
+
 protected:
     static const quint16 StandardPointRecordLength[LAS_NUMBER_OF_POINT_RECORD_DATA_FORMATS]; //!< array of the standard lenghts of point records
+    static const qint8 GpsTimeOffset[LAS_NUMBER_OF_POINT_RECORD_DATA_FORMATS]; //!< offsets of gps time in point records, -1 if not stored
+    static const qint8 ColorOffset[LAS_NUMBER_OF_POINT_RECORD_DATA_FORMATS]; //!< offsets of r, g, b in point records, -1 if not stored
+    static const qint8 NirOffset[LAS_NUMBER_OF_POINT_RECORD_DATA_FORMATS]; //!< offsets of near infrared in point records, -1 if not stored
 
     QFile dataFile;                     //!< data file
     LasFileHeader14 dataFileHeader;     //!< file header
     bool headerChanged = false;         //!< file header change flag
 
-    typedef void (*FPointFromBufferFunction)(char *buf, LasPoint &lasPoint); //!< point record decoder template
-    static const FPointFromBufferFunction PointFromBufferFunctions[LAS_NUMBER_OF_POINT_RECORD_DATA_FORMATS]; //!< array of point decoders
-    FPointFromBufferFunction pointFromBufFn = LasFile::decodePointNull; //!< pointer to current point record decoder
-
-    typedef void (*FPointToBufferFunction)(LasPoint &lasPoint, char *buf); //!< point record encoder template
-    static const FPointToBufferFunction PointToBufferFunctions[LAS_NUMBER_OF_POINT_RECORD_DATA_FORMATS]; //!< array of point encoders
-    FPointToBufferFunction pointToBufFn = LasFile::encodePointNull; //!< pointer to current point record encoder
-
-    qint64 cacheFirstRecord = -1;   //!< index of the first record in cache memory
-    qint64 cacheLastRecord = -1;    //!< index of the last record in cache
+    qint64 cacheFirstRecord = -1;   //!< index of the first appended record in cache memory, not yet written to the file
+    qint64 cacheLastRecord = -1;    //!< index of the last appended record in cache
     qint64 cacheNumberOfRecords = 0; //!< number of records stored in cache
     qint64 cacheLength = 0;         //!< the size of allocated cache in bytes (== cacheNRecords * header.pointRecordLength)
-    qint64 cacheOffset = 0;         //!< offset of the first requested record in cache, used in ReadCache
-    char *cacheData = nullptr;      //!< pointer to internal cache
+    char *cacheData = nullptr;      //!< pointer to internal cache of appended points, allocated by the first append
     bool cacheChanged = false;      //!< cache change flag
     bool pointsChanged = false;     //!< file change flag
+    LasPageCache pageCache;         //!< pages of point records read from the file
+    char *recordData = nullptr;     //!< one point record read from the file if there is no cache, allocated on the first read
+
+    LasPointStatistics pointStatistics;     //!< bounds and return histogram of point records, updated by appended points
+    bool pointStatisticsTracked = true;     //!< if false, statistics are recomputed from all points in updateHeader
+    LasZoneMap zoneMap;                     //!< bounds of chunks of point records, updated by appended points
+    bool zoneMapTracked = false;            //!< if false, the zone map does not cover all points and the sidecar file is removed on close
+    bool zoneMapChanged = false;            //!< if true, the zone map sidecar file is written on close, after the las-file
+    bool spatialIndexRemoved = false;       //!< true, if the spatial index sidecar file was removed after coordinates were updated
+
+    uchar *mappedData = nullptr;        //!< memory-mapped las-file, nullptr if the file is not mapped
+    qint64 mappedNumberOfRecords = 0;   //!< number of point records available in the mapped memory
+
+    LasReadAhead *readAhead = nullptr;  //!< background reader of point cache windows, nullptr if not reading ahead
+    LasWriteBehind *writeBehind = nullptr; //!< background writer of appended points, nullptr if not writing behind
+    QMutex positionalReadMutex;         //!< serializes positional reads on systems without pread
+
+    LasPointCompression compression = LAS_COMPRESSION_NONE; //!< storage of point records
+    LasChunkTable chunkTable;           //!< compressed chunks stored in the file, chunks are pages of the point cache
+    LasChunkDecoder *chunkDecoder = nullptr; //!< parallel decompression of following chunks, nullptr if not reading ahead
+    LasChunkEncoder *chunkEncoder = nullptr; //!< parallel compression of appended chunks, nullptr if chunks are compressed by the caller
+
+    LasVLRDirectory vlrDirectory;       //!< VLRs and EVLRs of the file, read on open and updated by appended records
+    QFile evlrSpill;                    //!< EVLRs moved out of the file while points are appended, written back after point data on close
+    QLockFile *evlrSpillLock = nullptr; //!< lock of the spill file held while EVLRs are detached, other sessions do not recover locked spill files
+    QString waveformSourceFileName;     //!< las-file, whose waveform data packets are referred to by point records of waveform formats
 
 public:
     LasFile();
@@ -74,12 +148,32 @@ public:
 
     bool open(QString fileName,
               qint64 pointCacheNRecords = LAS_DEFAULT_CACHE_NRECORDS,
-              qint64 pointCacheOffset = LAS_DEFAULT_CACHE_OFFSET);
+              LasFileAccessMode accessMode = LAS_ACCESS_CACHED,
+              int pointCacheNPages = LAS_DEFAULT_CACHE_NPAGES);
+    Q_DECL_DEPRECATED bool open(QString fileName,
+              qint64 pointCacheNRecords,
+              qint64 pointCacheOffset,
+              LasFileAccessMode accessMode = LAS_ACCESS_CACHED,
+              int pointCacheNPages = LAS_DEFAULT_CACHE_NPAGES);
     bool close();
     bool isOpen();
+    bool isMapped();
+    bool isReadingAhead();
+    quint64 getPointCacheHits();
+    quint64 getPointCacheMisses();
+    void resetPointCacheCounters();
     bool createCompatible(QString fileName, LasFile &lasTemplate,
                           qint64 pointCacheNRecords = LAS_DEFAULT_CACHE_NRECORDS,
-                          qint64 pointCacheOffset = LAS_DEFAULT_CACHE_OFFSET);
+                          LasFileAccessMode accessMode = LAS_ACCESS_CACHED,
+                          int pointCacheNPages = LAS_DEFAULT_CACHE_NPAGES,
+                          LasPointCompression pointCompression = LAS_COMPRESSION_NONE);
+    Q_DECL_DEPRECATED bool createCompatible(QString fileName, LasFile &lasTemplate,
+                          qint64 pointCacheNRecords,
+                          qint64 pointCacheOffset,
+                          LasFileAccessMode accessMode = LAS_ACCESS_CACHED,
+                          int pointCacheNPages = LAS_DEFAULT_CACHE_NPAGES,
+                          LasPointCompression pointCompression = LAS_COMPRESSION_NONE);
+    bool isCompressed();
 
     QString getFileSignature();
     quint8 getMajorVersion();
@@ -106,60 +200,250 @@ public:
     double getX1();
     double getY1();
     double getZ1();
+    double getScaleX();
+    double getScaleY();
+    double getScaleZ();
+    double getOffsetX();
+    double getOffsetY();
+    double getOffsetZ();
+    QString getFileName();
     bool hasWaveform();
+    bool hasZoneMap();
+    bool buildZoneMap(quint32 chunkNRecords = LAS_ZONE_MAP_CHUNK_NRECORDS);
 
     bool readVLR(qint64 iVLR, LasVLR &vlr);
     bool appendVLR(LasVLR &vlr);
+    qint64 findVLR(QString userID, quint16 recordID);
+    qint64 findEVLR(QString userID, quint16 recordID);
+    LasVLRDirectory &getVLRDirectory();
+    QString getEVLRSpillFileName();
+    bool getFileStamp(LasFileStamp &stamp);
 
-    bool readPoint(qint64 iPoint, LasPoint &lasPoint);
+    bool readEVLR(qint64 iEVLR, LasEVLRHeader &header);
+    bool readEVLRData(qint64 iEVLR, quint64 dataOffset, char *buf, qint64 nBytes);
+    bool appendEVLR(LasEVLRHeader &header, const char *data);
+    bool appendEVLR(LasEVLRHeader &header, QFile &source, qint64 sourceOffset);
+    bool appendEVLR(LasFile &las, qint64 iEVLR);
+
+    bool readPoint(qint64 iPoint, LasPoint &lasPoint, quint32 fields = LAS_FIELD_ALL);
+    bool readPoints(qint64 firstPoint, qint64 nPoints, LasPoint *lasPoints, quint32 fields = LAS_FIELD_ALL);
+    bool readPoints(qint64 firstPoint, qint64 nPoints, char *buf);
+    bool readPointBatch(qint64 firstPoint, qint64 nPoints, LasPointBatch &batch, quint32 fields = LAS_FIELD_ALL);
+    template<class F> bool forEachPoint(qint64 firstPoint, qint64 nPoints, F function, quint32 fields = LAS_FIELD_ALL);
+    template<class F> bool forEachPoint(LasPointFilter &filter, F function, quint32 fields = LAS_FIELD_ALL);
+    template<class F> bool parallelForEach(qint64 chunkSize, int nThreads, F function, quint32 fields = LAS_FIELD_ALL);
 
     bool appendPoint(char *lasPoint);
     bool appendPoint(LasPoint &lasPoint, bool scaleCoordinates = true);
+    bool appendPointBatch(LasPointBatch &batch, bool scaleCoordinates = true);
     bool appendPoints(LasFile &las);
     bool appendPoints(QString lasFileName);
 
+    bool updatePoint(qint64 iPoint, LasPoint &lasPoint, bool scaleCoordinates = true);
+    bool updatePointBatch(qint64 firstPoint, LasPointBatch &batch, quint32 fields = LAS_FIELD_ALL, bool scaleCoordinates = true);
+
 public:
     static bool merge(QString fileName1, QString fileName2, QString outputFileName);
+    static bool merge(QStringList inputFileNames, QString outputFileName, int nThreads = 0);
     static bool append(QString targetLasFileName, QString sourceLasFileName);
 
 protected:
-    static void decodePointNull(char *buf, LasPoint &lasPoint);
-    static void decodePoint0(char *buf, LasPoint &lasPoint);
-    static void decodePoint1(char *buf, LasPoint &lasPoint);
-    static void decodePoint2(char *buf, LasPoint &lasPoint);
-    static void decodePoint3(char *buf, LasPoint &lasPoint);
-    static void decodePoint4(char *buf, LasPoint &lasPoint);
-    static void decodePoint5(char *buf, LasPoint &lasPoint);
-    static void decodePoint6(char *buf, LasPoint &lasPoint);
-    static void decodePoint7(char *buf, LasPoint &lasPoint);
-    static void decodePoint8(char *buf, LasPoint &lasPoint);
-    static void decodePoint9(char *buf, LasPoint &lasPoint);
-    static void decodePoint10(char *buf, LasPoint &lasPoint);
-    void decodeExtraData(char *buf, LasPoint &lasPoint);
-
-    static void encodePointNull(LasPoint &lasPoint, char *buf);
-    static void encodePoint0(LasPoint &lasPoint, char *buf);
-    static void encodePoint1(LasPoint &lasPoint, char *buf);
-    static void encodePoint2(LasPoint &lasPoint, char *buf);
-    static void encodePoint3(LasPoint &lasPoint, char *buf);
-    static void encodePoint4(LasPoint &lasPoint, char *buf);
-    static void encodePoint5(LasPoint &lasPoint, char *buf);
-    static void encodePoint6(LasPoint &lasPoint, char *buf);
-    static void encodePoint7(LasPoint &lasPoint, char *buf);
-    static void encodePoint8(LasPoint &lasPoint, char *buf);
-    static void encodePoint9(LasPoint &lasPoint, char *buf);
-    static void encodePoint10(LasPoint &lasPoint, char *buf);
+    void decodePoint(char *buf, LasPoint &lasPoint, quint32 fields);
+    void decodePoints(char *buf, qint64 nRecords, LasPoint *lasPoints, quint32 fields);
+    template<int Format> void decodePointsOfFormat(char *buf, qint64 nRecords, LasPoint *lasPoints, quint32 fields);
+    void decodeExtraData(char *buf, LasPoint &lasPoint, quint32 fields);
+    void decodeBatch(char *buf, qint64 nRecords, LasPointBatch &batch, qint64 iBatch, quint32 fields);
+
+    void encodePoint(LasPoint &lasPoint, char *buf);
     void encodeExtraData(LasPoint &lasPoint, char *buf);
+    void encodeBatch(LasPointBatch &batch, qint64 iBatch, qint64 nRecords, char *buf);
+    void encodeBatchFields(LasPointBatch &batch, qint64 iBatch, qint64 nRecords, char *buf, quint32 fields);
+    void addPointStatistics(char *buf, qint64 nRecords);
+    template<int Format> void addPointStatisticsOfFormat(char *buf, qint64 nRecords);
+    void updatePointStatistics(char *buf, qint64 firstPoint, qint64 nRecords, quint32 fields);
+    bool scanPointStatistics();
+    bool writeZoneMap();
 
     bool writeHeader();
     bool updateHeader();
 
     bool copyVRLs(LasFile &lasTemplate);
     bool copyEVRLs(LasFile &lasTemplate);
+    bool detachEVLRs();
+    bool attachEVLRs();
+    bool recoverEVLRs();
+    bool lockEVLRSpill();
+    void unlockEVLRSpill();
+    qint64 getPointDataEnd();
 
-    bool allocatePointCache(qint64 pointCacheNumberOfRecords, qint64 pointCacheOffset);
+    bool allocatePointCache(qint64 pointCacheNumberOfRecords, int pointCacheNPages);
+    bool allocateAppendCache();
     bool writePointCache();
-    bool readPointCache(qint64 iPoint);
+    char *readPointCache(qint64 iPoint, qint64 &nRecords);
+    bool flushAppendedPoints();
+    bool readPointRecordsAt(qint64 firstPoint, qint64 nPoints, char *buf);
+    bool readAt(qint64 offset, char *buf, qint64 nLength);
+    bool readChunkAt(qint64 iChunk, char *buf, qint64 &nRecords);
+    bool writeCompressedChunks(bool lastChunk);
+    bool flushCompressedChunks();
+    bool readChunkTable();
+    void removeSpatialIndex();
+    bool readChunkCodecVLR();
+    bool appendChunkCodecVLR();
+    bool writeChunkTable();
+    bool parallelForEachBatch(qint64 chunkSize, int nThreads, LasBatchFunction &function, quint32 fields);
+    char *pointRecords(qint64 iPoint, qint64 &nRecords);
+
+    bool mapPointData();
+    void unmapPointData();
+    bool copyPointRecords(LasFile &las, qint64 firstPoint, qint64 nPoints, qint64 targetOffset);
+
+    bool startReadAhead();
+    void stopReadAhead();
+    bool startWriteBehind();
+    bool stopWriteBehind();
+
+    template<int Format, class F> bool forEachPointOfFormat(qint64 firstPoint, qint64 nPoints, F &function, quint32 fields);
 };
 
+
+/*!
+ * \brief Calls a function for each point of a contiguous run of points.
+ * \param firstPoint Index of the first point.
+ * \param nPoints Number of points.
+ * \param function Function or functor bool(qint64 iPoint, LasPoint &lasPoint), returns false to stop the iteration.
+ * \param fields Bit mask of decoded fields (LasPointFields).
+ * \return True, if all points were read successfully or the iteration was stopped by the function.
+ * \remark The point decoder is selected once per call and inlined into the loop.
+ * \remark The same las-point object is passed to all calls, fields not decoded keep default values only if the function does not change them.
+ */
+template<class F>
+bool LasFile::forEachPoint(qint64 firstPoint, qint64 nPoints, F function, quint32 fields)
+{
+    if (!this->dataFile.isOpen()) return false;
+    if (firstPoint < 0 || nPoints < 0 || qint64(this->dataFileHeader.number_of_points) - nPoints < firstPoint) return false;
+
+    switch (this->dataFileHeader.point_format)
+    {
+        case 0: return forEachPointOfFormat<0>(firstPoint, nPoints, function, fields);
+        case 1: return forEachPointOfFormat<1>(firstPoint, nPoints, function, fields);
+        case 2: return forEachPointOfFormat<2>(firstPoint, nPoints, function, fields);
+        case 3: return forEachPointOfFormat<3>(firstPoint, nPoints, function, fields);
+        case 4: return forEachPointOfFormat<4>(firstPoint, nPoints, function, fields);
+        case 5: return forEachPointOfFormat<5>(firstPoint, nPoints, function, fields);
+        case 6: return forEachPointOfFormat<6>(firstPoint, nPoints, function, fields);
+        case 7: return forEachPointOfFormat<7>(firstPoint, nPoints, function, fields);
+        case 8: return forEachPointOfFormat<8>(firstPoint, nPoints, function, fields);
+        case 9: return forEachPointOfFormat<9>(firstPoint, nPoints, function, fields);
+        case 10: return forEachPointOfFormat<10>(firstPoint, nPoints, function, fields);
+    }
+    return false;
+}
+
+
+/*!
+ * \brief Calls a function for each point accepted by a filter.
+ * \param filter Point filter.
+ * \param function Function or functor bool(qint64 iPoint, LasPoint &lasPoint), returns false to stop the iteration.
+ * \param fields Bit mask of decoded fields (LasPointFields), fields required by the filter are always decoded.
+ * \return True, if all points were read successfully or the iteration was stopped by the function.
+ * \remark Chunks of point records, which cannot contain accepted points according to the zone map, are not read.
+ */
+template<class F>
+bool LasFile::forEachPoint(LasPointFilter &filter, F function, quint32 fields)
+{
+    qint64 nPoints = qint64(this->dataFileHeader.number_of_points);
+    qint64 chunkNRecords = nPoints, firstPoint, iZone;
+    bool stopped = false, error = false;
+
+    if (!this->dataFile.isOpen()) return false;
+    if (hasZoneMap()) chunkNRecords = this->zoneMap.getChunkNRecords();
+
+    for (firstPoint = 0, iZone = 0; firstPoint < nPoints && !stopped && !error; firstPoint += chunkNRecords, iZone++)
+    {
+        if (hasZoneMap() && !this->zoneMap.mayMatch(iZone, filter)) continue;
+        error = !forEachPoint(firstPoint, qMin(chunkNRecords, nPoints - firstPoint), [&](qint64 iPoint, LasPoint &lasPoint)
+        {
+            if (!filter.matches(lasPoint)) return true;
+            stopped = !function(iPoint, lasPoint);
+            return !stopped;
+        }, fields | filter.requiredFields());
+    }
+
+    return !error;
+}
+
+
+/*!
+ * \brief Calls a function for chunks of points decoded in parallel.
+ * \param chunkSize Number of points in a chunk, LAS_SCAN_CHUNK_NRECORDS if not positive.
+ * \param nThreads Number of worker threads, the ideal thread count if not positive.
+ * \param function Function or functor bool(int iThread, LasPointBatch &batch), returns false to stop the scan.
+ * \param fields Bit mask of decoded fields (LasPointFields).
+ * \return True, if all points were read successfully or the scan was stopped by the function.
+ * \remark The function is called concurrently from worker threads, iThread can be used to index per-thread partial results.
+ * \remark Chunks are processed in no particular order, batch.firstPoint is the index of the first point of a chunk.
+ */
+template<class F>
+bool LasFile::parallelForEach(qint64 chunkSize, int nThreads, F function, quint32 fields)
+{
+    LasBatchFunctionOf<F> batchFunction(function);
+    return parallelForEachBatch(chunkSize, nThreads, batchFunction, fields);
+}
+
+
+/*!
+ * \brief Calls a function for each point of a contiguous run of points of a given point format.
+ * \param firstPoint Index of the first point.
+ * \param nPoints Number of points.
+ * \param function Function or functor bool(qint64 iPoint, LasPoint &lasPoint), returns false to stop the iteration.
+ * \param fields Bit mask of decoded fields (LasPointFields).
+ * \return True, if all points were read successfully or the iteration was stopped by the function.
+ */
+template<int Format, class F>
+bool LasFile::forEachPointOfFormat(qint64 firstPoint, qint64 nPoints, F &function, quint32 fields)
+{
+    LasPoint lasPoint;
+    char *buf;
+    qint64 nRecords, i;
+    const quint16 recordLength = this->dataFileHeader.point_record_length;
+    const bool extraData = (fields & LAS_FIELD_EXTRA_DATA) && StandardPointRecordLength[Format] < recordLength;
+    const double offsetX = this->dataFileHeader.offset_x, offsetY = this->dataFileHeader.offset_y, offsetZ = this->dataFileHeader.offset_z;
+    const double scaleX = this->dataFileHeader.scale_x != 0.0 ? this->dataFileHeader.scale_x : 1.0;
+    const double scaleY = this->dataFileHeader.scale_y != 0.0 ? this->dataFileHeader.scale_y : 1.0;
+    const double scaleZ = this->dataFileHeader.scale_z != 0.0 ? this->dataFileHeader.scale_z : 1.0;
+
+    while (0 < nPoints)
+    {
+        buf = pointRecords(firstPoint, nRecords);
+        if (buf == nullptr)
+        {
+            // neither mapped memory nor cache is available, read point by point
+            if (!readPoint(firstPoint, lasPoint, fields)) return false;
+            if (!function(firstPoint, lasPoint)) return true;
+            nRecords = 1;
+        }
+        else
+        {
+            if (nPoints < nRecords) nRecords = nPoints;
+            for(i = 0; i < nRecords; i++, buf += recordLength)
+            {
+                LasPointCodec<Format>::decode(buf, lasPoint, fields);
+                if (extraData) decodeExtraData(buf, lasPoint, fields);
+                if (fields & LAS_FIELD_XYZ)
+                {
+                    lasPoint.x = offsetX + scaleX * lasPoint.ix;
+                    lasPoint.y = offsetY + scaleY * lasPoint.iy;
+                    lasPoint.z = offsetZ + scaleZ * lasPoint.iz;
+                }
+                if (!function(firstPoint + i, lasPoint)) return true;
+            }
+        }
+        firstPoint += nRecords;
+        nPoints -= nRecords;
+    }
+
+    return true;
+}
+
 #endif // LASFILE_H